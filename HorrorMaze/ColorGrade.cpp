@@ -0,0 +1,118 @@
+#include "ColorGrade.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    // 像素按 R、G、B、A 字节顺序存放（和 Framebuffer 相同）
+    inline std::uint32_t packBytes(int r, int g, int b, int a) {
+        const std::uint8_t bytes[4] = {static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(g),
+                                       static_cast<std::uint8_t>(b), static_cast<std::uint8_t>(a)};
+        std::uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    // 晕影因子（定点数，256 = 不变）：position 是像素中心在 [-1, 1] 上的位置
+    std::uint16_t vignetteFactor(float position, float strength) {
+        float factor = 1.0f - strength * position * position;
+        return static_cast<std::uint16_t>(std::max(0.0f, std::min(1.0f, factor)) * 256.0f + 0.5f);
+    }
+}
+
+/**
+ * 闪灵视觉的颜色变换（原来天空、地板、墙各写一份，现在只在这里）
+ * 输入是光照反转后的画面（负片在光照里做，纹理细节不丢）
+ */
+std::uint32_t ColorGrade::spiritVision(int r, int g, int b) {
+    // 降低整体亮度（深灰色调）
+    r = static_cast<int>(r * 0.5f);
+    g = static_cast<int>(g * 0.5f);
+    b = static_cast<int>(b * 0.5f);
+
+    // 添加暗红色偏色（血腥恐怖感）
+    r = std::min(255, static_cast<int>(r * 1.1f));   // 轻微增强红色
+    g = static_cast<int>(g * 0.5f);   // 中度减弱绿色
+    b = static_cast<int>(b * 0.4f);   // 中度减弱蓝色
+
+    // 轻微增强对比度
+    float contrast = 1.15f;
+    r = static_cast<int>((r - 128) * contrast + 128);
+    g = static_cast<int>((g - 128) * contrast + 128);
+    b = static_cast<int>((b - 128) * contrast + 128);
+
+    r = std::min(255, std::max(0, r));
+    g = std::min(255, std::max(0, g));
+    b = std::min(255, std::max(0, b));
+    return packBytes(r, g, b, 255);
+}
+
+void ColorGrade::build(Transform transform) {
+    // 每一格覆盖 4 个输入值，取中间的那个
+    const int step = 1 << (8 - LUT_BITS);
+    lut.resize(static_cast<std::size_t>(LUT_SIZE) * LUT_SIZE * LUT_SIZE);
+    for (int r = 0; r < LUT_SIZE; r++) {
+        for (int g = 0; g < LUT_SIZE; g++) {
+            for (int b = 0; b < LUT_SIZE; b++) {
+                lut[(static_cast<std::size_t>(r) * LUT_SIZE + g) * LUT_SIZE + b] =
+                    transform(r * step + step / 2, g * step + step / 2, b * step + step / 2);
+            }
+        }
+    }
+}
+
+void ColorGrade::setVignette(int width, int height, float strength) {
+    vignetteStrength = strength;
+    columnVignette.resize(width);
+    for (int x = 0; x < width; x++) {
+        columnVignette[x] = vignetteFactor((x + 0.5f) / width * 2.0f - 1.0f, strength);
+    }
+    rowVignette.resize(height);
+    for (int y = 0; y < height; y++) {
+        rowVignette[y] = vignetteFactor((y + 0.5f) / height * 2.0f - 1.0f, strength);
+    }
+}
+
+void ColorGrade::applyRow(std::uint32_t* row, int y) const {
+    applyRow(CpuFeatures::detectIsa(), row, y);
+}
+
+void ColorGrade::applyRow(Isa isa, std::uint32_t* row, int y) const {
+    if (isa == Isa::AVX2 && CpuFeatures::detectIsa() == Isa::AVX2) {
+        applyRowAVX2(row, y);
+    } else {
+        applyRowScalar(row, y, 0);
+    }
+}
+
+/**
+ * 每个像素：查表得到调色后的颜色，RGB 乘上晕影因子（列因子 × 行因子 >> 8），alpha 保持 255
+ */
+void ColorGrade::applyRowScalar(std::uint32_t* row, int y, int first) const {
+    const int width = static_cast<int>(columnVignette.size());
+    const std::uint32_t rowFactor = rowVignette[y];
+    for (int x = first; x < width; x++) {
+        std::uint8_t bytes[4];
+        std::memcpy(bytes, &row[x], sizeof(bytes));
+        std::uint32_t graded = lut[lutIndex(bytes[0], bytes[1], bytes[2])];
+        std::memcpy(bytes, &graded, sizeof(bytes));
+
+        std::uint32_t factor = (columnVignette[x] * rowFactor) >> 8;
+        row[x] = packBytes((bytes[0] * factor) >> 8, (bytes[1] * factor) >> 8, (bytes[2] * factor) >> 8, 255);
+    }
+}
+
+std::vector<std::uint32_t> ColorGrade::makeAtlas() const {
+    std::vector<std::uint32_t> atlas(static_cast<std::size_t>(ATLAS_SIZE) * ATLAS_SIZE);
+    for (int b = 0; b < LUT_SIZE; b++) {
+        int originX = (b % ATLAS_TILES) * LUT_SIZE;
+        int originY = (b / ATLAS_TILES) * LUT_SIZE;
+        for (int g = 0; g < LUT_SIZE; g++) {
+            for (int r = 0; r < LUT_SIZE; r++) {
+                atlas[static_cast<std::size_t>(originY + g) * ATLAS_SIZE + originX + r] =
+                    lut[(static_cast<std::size_t>(r) * LUT_SIZE + g) * LUT_SIZE + b];
+            }
+        }
+    }
+    return atlas;
+}
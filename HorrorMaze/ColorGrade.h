@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "CpuFeatures.h"
+
+/**
+ * ColorGrade：整帧调色（闪灵视觉的压暗、暗红偏色、对比度和晕影）
+ *
+ * 天空、地板、墙先画好（闪灵时只是光照反转，见 Renderer），调色在最后对整帧做一遍：
+ * 颜色变换事先烘焙成 3D 查找表（LUT），R、G、B 各取高 6 位，64×64×64 项，
+ * 每个像素查一次表，再乘上晕影因子（屏幕边缘变暗）。
+ * 晕影拆成列因子 × 行因子（定点数，256 = 不变），每个像素一次乘法得到。
+ * 换一种调色效果只换变换函数、重建查找表，不用改各个图元的着色代码。
+ *
+ *   AVX2   - 8 个像素一组：移位拼出查找表下标，gather 查表，16 位乘法做晕影
+ *   Scalar - 逐像素（非x86平台、不支持AVX2的CPU、以及每行末尾不满8个的像素）
+ *
+ * 两个版本的整数运算相同，输出逐位一致。按 CpuFeatures 检测到的指令集选择实现。
+ * 查找表还能排成一张二维图（makeAtlas），给 GPU 着色器路径当纹理用（不依赖 SFML）。
+ */
+class ColorGrade {
+public:
+    using Isa = CpuFeatures::Isa;
+
+    static constexpr int LUT_BITS = 6;
+    static constexpr int LUT_SIZE = 1 << LUT_BITS;                // 每个通道 64 级
+    static constexpr int ATLAS_TILES = 8;                         // 二维排布每行 8 个 B 切片
+    static constexpr int ATLAS_SIZE = LUT_SIZE * ATLAS_TILES;     // 512×512
+
+    // 颜色变换：RGB（0..255）→ 打包颜色（Framebuffer 的字节顺序）
+    using Transform = std::uint32_t (*)(int r, int g, int b);
+
+    // 闪灵视觉：压暗、暗红偏色、增强对比度
+    static std::uint32_t spiritVision(int r, int g, int b);
+
+    // 用变换重建查找表（每一格取格子中心的颜色）
+    void build(Transform transform);
+
+    // 晕影：离屏幕中心的归一化距离为 d 时，横竖方向各乘 (1 - strength × d²)
+    void setVignette(int width, int height, float strength);
+    float getVignetteStrength() const { return vignetteStrength; }
+
+    // 调色第 y 行（各行互不相关，调用者可以分给多个线程）
+    void applyRow(std::uint32_t* row, int y) const;
+
+    // 指定实现（基准测试和校验用；CPU不支持时自动退回标量版本）
+    void applyRow(Isa isa, std::uint32_t* row, int y) const;
+
+    // 二维排布的查找表：第 b 个切片在 (b % 8, b / 8) 格，切片内 x = R、y = G（ATLAS_SIZE² 个打包像素）
+    std::vector<std::uint32_t> makeAtlas() const;
+
+private:
+    std::vector<std::uint32_t> lut;                // [R][G][B] → 打包颜色
+    std::vector<std::uint16_t> columnVignette;     // 每列的晕影因子（0..256）
+    std::vector<std::uint16_t> rowVignette;        // 每行的晕影因子
+    float vignetteStrength = 0.0f;
+
+    static int lutIndex(int r, int g, int b) {
+        return ((r >> (8 - LUT_BITS)) << (2 * LUT_BITS)) | ((g >> (8 - LUT_BITS)) << LUT_BITS) | (b >> (8 - LUT_BITS));
+    }
+
+    // 标量版本从第 first 个像素开始（AVX2 版本用它处理末尾）
+    void applyRowScalar(std::uint32_t* row, int y, int first) const;
+    // AVX2 版本（ColorGradeSimd.cpp）
+    void applyRowAVX2(std::uint32_t* row, int y) const;
+};
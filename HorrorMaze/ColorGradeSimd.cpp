@@ -0,0 +1,61 @@
+#include "ColorGrade.h"
+#include "SimdTarget.h"
+
+/**
+ * ColorGrade 的 AVX2 实现（编译方式见 SimdTarget.h）
+ *
+ * 查找表下标由像素的三个字节各取高 6 位拼成（x86 是小端，R 在最低字节）；
+ * 晕影把 8 位通道扩展成 16 位，和每个像素的因子相乘后右移 8 位，再饱和打包回字节。
+ */
+
+#if SIMD_X86
+
+SIMD_TARGET_AVX2
+void ColorGrade::applyRowAVX2(std::uint32_t* row, int y) const {
+    static_assert(LUT_BITS == 6, "applyRowAVX2 assumes 6 bits per channel");
+
+    const int width = static_cast<int>(columnVignette.size());
+    const int* table = reinterpret_cast<const int*>(lut.data());
+    const __m256i rowFactor = _mm256_set1_epi32(rowVignette[y]);
+    const __m256i redMask = _mm256_set1_epi32(0x3F << 12);
+    const __m256i greenMask = _mm256_set1_epi32(0x3F << 6);
+    const __m256i blueMask = _mm256_set1_epi32(0x3F);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    const __m256i zero = _mm256_setzero_si256();
+
+    int x = 0;
+    for (; x + 8 <= width; x += 8) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + x));
+
+        // R 的 2..7 位 → 下标 12..17 位，G 的 10..15 位 → 6..11 位，B 的 18..23 位 → 0..5 位
+        __m256i index = _mm256_or_si256(
+            _mm256_and_si256(_mm256_slli_epi32(pixels, 10), redMask),
+            _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(pixels, 4), greenMask),
+                            _mm256_and_si256(_mm256_srli_epi32(pixels, 18), blueMask)));
+        __m256i graded = _mm256_i32gather_epi32(table, index, 4);
+
+        // 每个像素的晕影因子，复制到 32 位里的两个 16 位（一个像素占两个 32 位通道）
+        __m128i columns = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columnVignette.data() + x));
+        __m256i factor = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_cvtepu16_epi32(columns), rowFactor), 8);
+        factor = _mm256_or_si256(factor, _mm256_slli_epi32(factor, 16));
+
+        // unpack 按 128 位半边交错：低半边是每半边的第 0、1 个像素，高半边是第 2、3 个
+        __m256i low = _mm256_unpacklo_epi8(graded, zero);
+        __m256i high = _mm256_unpackhi_epi8(graded, zero);
+        low = _mm256_srli_epi16(_mm256_mullo_epi16(low, _mm256_unpacklo_epi32(factor, factor)), 8);
+        high = _mm256_srli_epi16(_mm256_mullo_epi16(high, _mm256_unpackhi_epi32(factor, factor)), 8);
+
+        __m256i result = _mm256_or_si256(_mm256_packus_epi16(low, high), alpha);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + x), result);
+    }
+
+    applyRowScalar(row, y, x);
+}
+
+#else  // 非x86平台：只有标量版本
+
+void ColorGrade::applyRowAVX2(std::uint32_t* row, int y) const {
+    applyRowScalar(row, y, 0);
+}
+
+#endif
@@ -0,0 +1,61 @@
+#include "CpuFeatures.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace {
+
+    // 运行时检测CPU特性
+    CpuFeatures::Isa queryCpu() {
+        using CpuFeatures::Isa;
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        int info[4];
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        bool sse2 = (info[3] & (1 << 26)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+
+        bool avx2 = false;
+        if (maxLeaf >= 7 && osxsave && avx) {
+            // 操作系统必须保存YMM寄存器状态（XCR0 的第1、2位）
+            unsigned long long xcr0 = _xgetbv(0);
+            if ((xcr0 & 0x6) == 0x6) {
+                __cpuidex(info, 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+        }
+        if (avx2) return Isa::AVX2;
+        if (sse2) return Isa::SSE2;
+        return Isa::Scalar;
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+        if (__builtin_cpu_supports("sse2")) return Isa::SSE2;
+        return Isa::Scalar;
+#else
+        return Isa::Scalar;  // 非x86平台：各内核只编译了标量版本
+#endif
+    }
+}
+
+namespace CpuFeatures {
+
+    Isa detectIsa() {
+        static const Isa isa = queryCpu();
+        return isa;
+    }
+
+    const char* getIsaName(Isa isa) {
+        switch (isa) {
+            case Isa::AVX2: return "AVX2";
+            case Isa::SSE2: return "SSE2";
+            case Isa::Scalar:
+            default:        return "Scalar";
+        }
+    }
+}
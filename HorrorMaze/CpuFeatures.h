@@ -0,0 +1,21 @@
+#pragma once
+
+/**
+ * CpuFeatures：运行时指令集检测（各个 SIMD 内核共用）
+ *
+ * PerceptionBatch、RayCastBatch、FloorCast、ColorGrade 都按这里的结果选择实现，
+ * 也都接受显式指定的 Isa（基准测试和校验用，CPU不支持时退回标量版本）。
+ * SIMD 函数的编译方式见 SimdTarget.h。
+ */
+namespace CpuFeatures {
+
+    enum class Isa {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+    // 当前CPU支持的最快实现（首次调用时检测，之后缓存；非x86平台总是 Scalar）
+    Isa detectIsa();
+    const char* getIsaName(Isa isa);
+}
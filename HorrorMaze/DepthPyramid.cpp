@@ -0,0 +1,76 @@
+#include "DepthPyramid.h"
+#include <algorithm>
+
+void DepthPyramid::build(const std::vector<float>& columnDepth) {
+    columns = columnDepth;
+
+    // 第 0 层由列合并，之后每层由下一层的 8 块合并（最后一块可能不满）
+    const std::vector<float>* belowMin = &columns;
+    const std::vector<float>* belowMax = &columns;
+    int blockSize = 1;
+    for (Level& level : levels) {
+        blockSize *= BRANCH;
+        level.blockSize = blockSize;
+
+        std::size_t count = (belowMin->size() + BRANCH - 1) / BRANCH;
+        level.minDepth.resize(count);
+        level.maxDepth.resize(count);
+        for (std::size_t block = 0; block < count; block++) {
+            std::size_t begin = block * BRANCH;
+            std::size_t end = std::min(begin + BRANCH, belowMin->size());
+            float lo = (*belowMin)[begin];
+            float hi = (*belowMax)[begin];
+            for (std::size_t i = begin + 1; i < end; i++) {
+                lo = std::min(lo, (*belowMin)[i]);
+                hi = std::max(hi, (*belowMax)[i]);
+            }
+            level.minDepth[block] = lo;
+            level.maxDepth[block] = hi;
+        }
+
+        belowMin = &level.minDepth;
+        belowMax = &level.maxDepth;
+    }
+}
+
+int DepthPyramid::findVisible(int first, int last, float depth) const {
+    return find(first, last, depth, true);
+}
+
+int DepthPyramid::findHidden(int first, int last, float depth) const {
+    return find(first, last, depth, false);
+}
+
+/**
+ * 从 x = first 往右：先取以 x 对齐、不超出 last 的最大块，
+ * 整块都不满足条件就跳过整块，否则往下一层细查；到单列时直接比较。
+ */
+int DepthPyramid::find(int first, int last, float depth, bool wantVisible) const {
+    int x = first;
+    while (x <= last) {
+        int level = LEVELS - 1;
+        while (level >= 0 && ((x & (levels[level].blockSize - 1)) != 0 || x + levels[level].blockSize - 1 > last)) {
+            level--;
+        }
+
+        for (;; level--) {
+            if (level < 0) {
+                if ((depth < columns[x]) == wantVisible) {
+                    return x;
+                }
+                x++;
+                break;
+            }
+
+            // 找可见列时，整块都挡住（最远的墙也不比 depth 远）就跳过；找被挡住的列时反之
+            const Level& current = levels[level];
+            int block = x >> (BRANCH_BITS * (level + 1));
+            bool skip = wantVisible ? (current.maxDepth[block] <= depth) : (current.minDepth[block] > depth);
+            if (skip) {
+                x += current.blockSize;
+                break;
+            }
+        }
+    }
+    return last + 1;
+}
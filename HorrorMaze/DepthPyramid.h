@@ -0,0 +1,46 @@
+#pragma once
+#include <vector>
+
+/**
+ * DepthPyramid：深度缓冲的分层最小/最大值
+ *
+ * 每 8、64、512 列一块，记录块内墙距离的最小值和最大值。
+ * 判断一段列“全部被墙挡住”或“全部在墙前面”时，整块满足的直接跳过，
+ * 只在边界附近逐层往下细查，一段列的查询是 O(log 宽度) 而不是 O(列数)。
+ *
+ * 深度缓冲每帧由 Renderer 写好后调用一次 build（不依赖 SFML）。
+ * 约定和逐列深度测试相同：depth < 墙距离 时可见，depth >= 墙距离 时被挡住。
+ */
+class DepthPyramid {
+public:
+    static constexpr int BRANCH_BITS = 3;
+    static constexpr int BRANCH = 1 << BRANCH_BITS;  // 每层的块是下一层的 8 倍（2 的幂，块号用移位算）
+    static constexpr int LEVELS = 3;   // 8、64、512 列三层
+
+    // 由每列的墙距离重建各层
+    void build(const std::vector<float>& columnDepth);
+
+    int getWidth() const { return static_cast<int>(columns.size()); }
+
+    // [first, last] 中第一个可见的列（depth 比墙近），没有时返回 last + 1
+    int findVisible(int first, int last, float depth) const;
+
+    // [first, last] 中第一个被墙挡住的列，没有时返回 last + 1
+    int findHidden(int first, int last, float depth) const;
+
+    // 整段可见
+    bool isVisible(int first, int last, float depth) const { return findHidden(first, last, depth) > last; }
+
+private:
+    struct Level {
+        int blockSize;
+        std::vector<float> minDepth;
+        std::vector<float> maxDepth;
+    };
+
+    std::vector<float> columns;
+    Level levels[LEVELS];
+
+    // 从 first 开始找第一个满足条件的列（wantVisible：找可见列还是被挡住的列）
+    int find(int first, int last, float depth, bool wantVisible) const;
+};
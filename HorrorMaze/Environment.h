@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdlib>
+#include <string>
+
+/**
+ * 读取环境变量（HORRORMAZE_SEED、HORRORMAZE_RECORD 等调试开关共用）
+ *
+ * MSVC 开启 SDL 检查后 std::getenv 会报 C4996，所以在 MSVC 上用 _dupenv_s。
+ * 变量不存在时返回 false。
+ */
+inline bool readEnvironmentVariable(const char* name, std::string& out) {
+#ifdef _MSC_VER
+    char* buffer = nullptr;
+    std::size_t length = 0;
+    if (_dupenv_s(&buffer, &length, name) != 0 || buffer == nullptr) {
+        return false;
+    }
+    out = buffer;
+    std::free(buffer);
+    return true;
+#else
+    const char* value = std::getenv(name);
+    if (value == nullptr) {
+        return false;
+    }
+    out = value;
+    return true;
+#endif
+}
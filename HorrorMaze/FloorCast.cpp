@@ -0,0 +1,38 @@
+#include "FloorCast.h"
+#include <algorithm>
+#include <cmath>
+
+namespace FloorCast {
+
+    void shadeRow(const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                  const std::uint32_t* colormap, std::uint32_t* out, int count) {
+        shadeRow(CpuFeatures::detectIsa(), texture, startX, startY, stepX, stepY, colormap, out, count);
+    }
+
+    void shadeRow(Isa isa, const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                  const std::uint32_t* colormap, std::uint32_t* out, int count) {
+        if (isa == Isa::AVX2 && CpuFeatures::detectIsa() == Isa::AVX2) {
+            detail::shadeRowAVX2(texture, startX, startY, stepX, stepY, colormap, out, count);
+        } else {
+            detail::shadeRowScalar(texture, startX, startY, stepX, stepY, colormap, out, 0, count);
+        }
+    }
+
+    namespace detail {
+
+        void shadeRowScalar(const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                            const std::uint32_t* colormap, std::uint32_t* out, int first, int count) {
+            const float texWidth = static_cast<float>(texture.width);
+            const float texHeight = static_cast<float>(texture.height);
+            for (int i = first; i < count; i++) {
+                float worldX = startX + stepX * static_cast<float>(i);
+                float worldY = startY + stepY * static_cast<float>(i);
+
+                // 格子内的位置 [0, 1) → 纹理坐标（浮点误差可能得到 1.0，夹到最后一个纹素）
+                int texX = std::min(texture.width - 1, static_cast<int>((worldX - std::floor(worldX)) * texWidth));
+                int texY = std::min(texture.height - 1, static_cast<int>((worldY - std::floor(worldY)) * texHeight));
+                out[i] = colormap[texture.indices[static_cast<std::size_t>(texY) * texture.width + texX]];
+            }
+        }
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include "CpuFeatures.h"
+#include "Palette.h"
+
+/**
+ * FloorCast：地板/天花板投射的逐行着色内核（软件帧缓冲用）
+ *
+ * 经典的按行投射：第 y 行上所有像素到玩家的水平距离相同（rowDistance），
+ * 世界坐标从最左边一列的光线落点开始，每个像素沿相机平面前进相同的一步。
+ * 这里只负责一行：按世界坐标的小数部分取调色板纹理的下标，查这一行的颜色表（colormap）写进帧缓冲。
+ * 光照已经算进颜色表里（见 Palette），每个像素只有一次查表。
+ *
+ *   AVX2   - 8 个像素一组：坐标、取整、纹理下标都在向量里算，gather 取调色板下标，再 gather 查颜色表
+ *   Scalar - 逐像素（非x86平台、不支持AVX2的CPU、以及每行末尾不满8个的像素）
+ *
+ * 第 i 个像素的坐标按 start + step × i 计算（不是逐像素累加），
+ * 两个版本的运算顺序相同，输出逐位一致。
+ * 按 CpuFeatures 检测到的指令集选择实现。
+ */
+namespace FloorCast {
+
+    using Isa = CpuFeatures::Isa;
+
+    /**
+     * 着色一行 count 个像素
+     *
+     * @param startX, startY  第0个像素对应的世界坐标（格）
+     * @param stepX, stepY    每个像素前进的世界坐标
+     * @param colormap        这一行的颜色表（Palette::SIZE 项，调色板颜色 × 这一行的光照）
+     * @param out             输出像素
+     */
+    void shadeRow(const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                  const std::uint32_t* colormap, std::uint32_t* out, int count);
+
+    // 指定实现（基准测试和校验用；CPU不支持时自动退回标量版本）
+    void shadeRow(Isa isa, const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                  const std::uint32_t* colormap, std::uint32_t* out, int count);
+
+    namespace detail {
+        // 标量版本从第 first 个像素开始（AVX2 版本用它处理末尾）
+        void shadeRowScalar(const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                            const std::uint32_t* colormap, std::uint32_t* out, int first, int count);
+        // AVX2 版本（FloorCastSimd.cpp）
+        void shadeRowAVX2(const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                          const std::uint32_t* colormap, std::uint32_t* out, int count);
+    }
+}
@@ -0,0 +1,64 @@
+#include "FloorCast.h"
+#include "SimdTarget.h"
+
+/**
+ * FloorCast 的 AVX2 实现（编译方式见 SimdTarget.h）
+ *
+ * 两次 gather：先按纹素位置取 32 位再留低字节得到调色板下标
+ * （IndexedTexture 末尾留了 3 个字节，不会读越界），再用下标查颜色表。
+ */
+
+namespace FloorCast {
+namespace detail {
+
+#if SIMD_X86
+
+    SIMD_TARGET_AVX2
+    void shadeRowAVX2(const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                      const std::uint32_t* colormap, std::uint32_t* out, int count) {
+        const int* indices = reinterpret_cast<const int*>(texture.indices.data());
+        const int* table = reinterpret_cast<const int*>(colormap);
+        const __m256 texWidth = _mm256_set1_ps(static_cast<float>(texture.width));
+        const __m256 texHeight = _mm256_set1_ps(static_cast<float>(texture.height));
+        const __m256i maxX = _mm256_set1_epi32(texture.width - 1);
+        const __m256i maxY = _mm256_set1_epi32(texture.height - 1);
+        const __m256i rowStride = _mm256_set1_epi32(texture.width);
+        const __m256 vstartX = _mm256_set1_ps(startX);
+        const __m256 vstartY = _mm256_set1_ps(startY);
+        const __m256 vstepX = _mm256_set1_ps(stepX);
+        const __m256 vstepY = _mm256_set1_ps(stepY);
+        const __m256i lowByte = _mm256_set1_epi32(0xFF);
+
+        __m256i pixelIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i eight = _mm256_set1_epi32(8);
+
+        int i = 0;
+        for (; i + 8 <= count; i += 8, pixelIndex = _mm256_add_epi32(pixelIndex, eight)) {
+            __m256 position = _mm256_cvtepi32_ps(pixelIndex);
+            __m256 worldX = _mm256_add_ps(vstartX, _mm256_mul_ps(vstepX, position));
+            __m256 worldY = _mm256_add_ps(vstartY, _mm256_mul_ps(vstepY, position));
+
+            // 小数部分 → 纹理坐标（截断，夹到最后一个纹素）
+            __m256i texX = _mm256_min_epi32(maxX, _mm256_cvttps_epi32(
+                _mm256_mul_ps(_mm256_sub_ps(worldX, _mm256_floor_ps(worldX)), texWidth)));
+            __m256i texY = _mm256_min_epi32(maxY, _mm256_cvttps_epi32(
+                _mm256_mul_ps(_mm256_sub_ps(worldY, _mm256_floor_ps(worldY)), texHeight)));
+            __m256i offset = _mm256_add_epi32(_mm256_mullo_epi32(texY, rowStride), texX);
+            __m256i paletteIndex = _mm256_and_si256(_mm256_i32gather_epi32(indices, offset, 1), lowByte);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_i32gather_epi32(table, paletteIndex, 4));
+        }
+
+        shadeRowScalar(texture, startX, startY, stepX, stepY, colormap, out, i, count);
+    }
+
+#else  // 非x86平台：只有标量版本
+
+    void shadeRowAVX2(const IndexedTexture& texture, float startX, float startY, float stepX, float stepY,
+                      const std::uint32_t* colormap, std::uint32_t* out, int count) {
+        shadeRowScalar(texture, startX, startY, stepX, stepY, colormap, out, 0, count);
+    }
+
+#endif
+
+}
+}
@@ -0,0 +1,31 @@
+#include "Framebuffer.h"
+#include "Logger.h"
+#include "Profiler.h"
+
+Framebuffer::Framebuffer(int w, int h)
+    : width(w)
+    , height(h)
+    , pixels(static_cast<std::size_t>(w) * h, pack(0, 0, 0))
+    , textureReady(false)
+    , textureFailed(false)
+{
+}
+
+void Framebuffer::present(sf::RenderTarget& target) {
+    PROFILE_SCOPE(Upload);
+    if (!textureReady) {
+        if (textureFailed) {
+            return;
+        }
+        if (!texture.resize({static_cast<unsigned>(width), static_cast<unsigned>(height)})) {
+            LOG_ERROR("ERROR: Cannot create framebuffer texture (" << width << "x" << height << ")");
+            textureFailed = true;
+            return;
+        }
+        textureReady = true;
+    }
+
+    texture.update(reinterpret_cast<const std::uint8_t*>(pixels.data()));
+    sf::Sprite sprite(texture);
+    target.draw(sprite);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+/**
+ * Framebuffer：CPU 端的 RGBA 帧缓冲
+ *
+ * 第一人称画面（天空、地板、墙）逐像素写进内存，每帧上传成一张纹理，
+ * 再画成一个全屏四边形：整个3D画面只有一次纹理上传和一次 draw call。
+ * 没有GPU、只有软件OpenGL的机器上，几千次小的 draw call 比写像素慢得多。
+ *
+ * 像素按 R、G、B、A 字节顺序存放（和 sf::Image / sf::Texture::update 一致），
+ * pack/unpack 用 memcpy 转换，不依赖字节序。
+ */
+class Framebuffer {
+public:
+    Framebuffer(int width, int height);
+
+    // 第 y 行的像素（调用者保证 0 <= y < height）
+    std::uint32_t* row(int y) { return pixels.data() + static_cast<std::size_t>(y) * width; }
+
+    // 上传到纹理，画成覆盖 (0, 0)-(width, height) 的四边形
+    void present(sf::RenderTarget& target);
+
+    static std::uint32_t pack(std::uint8_t r, std::uint8_t g, std::uint8_t b, std::uint8_t a = 255) {
+        const std::uint8_t bytes[4] = {r, g, b, a};
+        std::uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    static std::uint32_t pack(const sf::Color& color) {
+        return pack(color.r, color.g, color.b, color.a);
+    }
+
+    static void unpack(std::uint32_t value, std::uint8_t bytes[4]) {
+        std::memcpy(bytes, &value, sizeof(value));
+    }
+
+private:
+    int width;
+    int height;
+    std::vector<std::uint32_t> pixels;
+    sf::Texture texture;   // 第一次 present 时创建（需要窗口的 OpenGL 上下文）
+    bool textureReady;
+    bool textureFailed;    // 创建失败后不再重试（避免每帧刷错误日志）
+};
@@ -1,13 +1,14 @@
 #include "Game.h"
-#include <iostream>
+#include "GridTrace.h"
+#include "Logger.h"
+#include "Environment.h"
 #include <vector>
 #include <string>
-#include <random>
-#include <set>
 #include <cmath>
 #include <cstdint>
 #include <SFML/Window/Mouse.hpp>
 #include <stdexcept>
+#include <utility>
 
 Game::Game()
     : window(sf::VideoMode({WINDOW_WIDTH, WINDOW_HEIGHT}), "Horror Maze")
@@ -17,19 +18,17 @@ Game::Game()
     , score(0)
     , lives(3)
     , currentLevel(1)
-    , gameTimer(GAME_TIME_LIMIT)  // 初始化为5分钟
+    , sim(chooseSeed())
     , renderer(WINDOW_WIDTH, WINDOW_HEIGHT)
-    , playerFrozen(false)  // 初始未冻结
-    , frozenTimer(0.0f)
-    , activeTwinIndex(-1)
+    , rewindSnapshots(REWIND_SNAPSHOTS)
+    , slowFrameSeconds(0.0f)
     , fontLoaded(false)  // 初始化字体加载状态
     , heresJohnnyLoaded(false)  // 初始化 Here's Johnny 音效加载状态
     , soundsLoaded(false)  // 初始化声音加载状态
     , footstepIntensity(0.0f)
     , footstepAngle(0.0f)
-    , twinEncounterCount(0)  // 初始化双胞胎遭遇次数
 {
-    window.setFramerateLimit(static_cast<unsigned int>(TARGET_FPS));
+    window.setVerticalSyncEnabled(true);  // 渲染跟随显示器刷新率，模拟频率由固定步长决定
 
     // === 加载字体 ===
     std::vector<std::string> fontPaths = {
@@ -42,22 +41,22 @@ Game::Game()
     for (const auto& path : fontPaths) {
         if (font.openFromFile(path)) {
             fontLoaded = true;
-            std::cout << "Font loaded: " << path << std::endl;
+            LOG_INFO("Font loaded: " << path);
             break;
         }
     }
 
     if (!fontLoaded) {
-        std::cerr << "WARNING: Could not load any font!" << std::endl;
-        std::cerr << "Text will not be displayed." << std::endl;
+        LOG_WARN("WARNING: Could not load any font!");
+        LOG_WARN("Text will not be displayed.");
     }
 
     // === 加载声音 ===
     loadSounds();
 
     // 加载地图（尝试多个可能的路径）
-    std::cout << "=== Horror Maze - Loading ===" << std::endl;
-    std::cout << "Loading map..." << std::endl;
+    LOG_INFO("=== Horror Maze - Loading ===");
+    LOG_INFO("Loading map...");
 
     bool loaded = false;
     std::vector<std::string> possiblePaths = {
@@ -67,69 +66,43 @@ Game::Game()
     };
 
     for (const auto& path : possiblePaths) {
-        std::cout << "Trying: " << path << std::endl;
-        if (maze.loadFromFile(path)) {
+        LOG_INFO("Trying: " << path);
+        if (sim.loadMap(path)) {
             loaded = true;
-            std::cout << "Map loaded successfully!" << std::endl;
+            LOG_INFO("Map loaded successfully!");
             break;
         }
     }
 
     if (!loaded) {
-        std::cerr << "ERROR: Cannot load map!" << std::endl;
-        std::cerr << "Please ensure map file exists." << std::endl;
+        LOG_ERROR("ERROR: Cannot load map!");
+        LOG_ERROR("Please ensure map file exists.");
         throw std::runtime_error("Map file missing or unreadable.");
     }
 
-    // 初始化玩家位置
-    sf::Vector2i startPos = maze.getPlayerStart();
-    player = Player(startPos.x + 0.5f, startPos.y + 0.5f);
-    std::cout << "Player spawned at: (" << startPos.x << ", " << startPos.y << ")" << std::endl;
-
-    // 初始化鬼：在迷宫左下或右上1/4区域的道路上随机刷新
-    ghosts.clear();
-
-    // 随机决定在左下还是右上区域生成
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> regionChoice(0, 1);
-    bool spawnInBottomLeft = (regionChoice(gen) == 0);
-
-    // 找到对应区域(1/4)的所有可行走位置
-    std::vector<sf::Vector2i> validSpawnPositions;
-    int halfWidth = maze.getWidth() / 2;
-    int halfHeight = maze.getHeight() / 2;
-
-    if (spawnInBottomLeft) {
-        // 左下区域：x: [0, width/2), y: [height/2, height)
-        std::cout << "Spawning ghost in BOTTOM-LEFT quarter..." << std::endl;
-        for (int y = halfHeight; y < maze.getHeight(); y++) {
-            for (int x = 0; x < halfWidth; x++) {
-                if (!maze.isWall(x, y)) {
-                    validSpawnPositions.push_back({x, y});
-                }
-            }
-        }
-    } else {
-        // 右上区域：x: [width/2, width), y: [0, height/2)
-        std::cout << "Spawning ghost in TOP-RIGHT quarter..." << std::endl;
-        for (int y = 0; y < halfHeight; y++) {
-            for (int x = halfWidth; x < maze.getWidth(); x++) {
-                if (!maze.isWall(x, y)) {
-                    validSpawnPositions.push_back({x, y});
-                }
-            }
-        }
+    // 双胞胎台词的时长决定冻结时长
+    sim.setTwinVoiceDurations(twinVoice1Buffer.getDuration().asSeconds(),
+                              twinVoice2Buffer.getDuration().asSeconds());
+
+    // 性能统计
+    if (readEnvironmentVariable("HORRORMAZE_PROFILE", profileCsvPath) && !profileCsvPath.empty()) {
+        Profiler::instance().setEnabled(true);
+        LOG_INFO("Profiling enabled, results go to: " << profileCsvPath);
     }
 
-    // 随机选择一个位置生成鬼
-    if (!validSpawnPositions.empty()) {
-        std::uniform_int_distribution<> dis(0, static_cast<int>(validSpawnPositions.size()) - 1);
-        sf::Vector2i spawnPos = validSpawnPositions[dis(gen)];
-        ghosts.emplace_back(spawnPos.x + 0.5f, spawnPos.y + 0.5f);
-        std::cout << "Ghost spawned at: (" << spawnPos.x << ", " << spawnPos.y << ")" << std::endl;
-    } else {
-        std::cerr << "Warning: No valid spawn positions found for ghost!" << std::endl;
+    // 第一人称渲染路径
+    std::string softwareRender;
+    if (readEnvironmentVariable("HORRORMAZE_SOFTWARE_RENDER", softwareRender) && softwareRender == "1") {
+        renderer.setSoftwareRendering(true);
+    }
+
+    // 输入录像
+    std::string recordPath;
+    if (readEnvironmentVariable("HORRORMAZE_RECORD", recordPath) && !recordPath.empty()) {
+        recorder.open(recordPath, sim.getRng().getSeed(), FIXED_TIMESTEP);
+    }
+    if (replay.isLoaded() && replay.getTimestep() != FIXED_TIMESTEP) {
+        LOG_WARN("WARNING: Recording was made at a different simulation rate; replay will diverge.");
     }
 
     // 加载鬼的sprite纹理
@@ -170,40 +143,71 @@ Game::Game()
         throw std::runtime_error("Required texture missing: twin_sprite.png");
     }
 
-    // === 初始化双胞胎陷阱 ===
-    std::cout << "Spawning twins..." << std::endl;
-    twins.clear();
-
-    // 在迷宫中查找所有双胞胎标记位置（cell value = 3）
-    int twinCount = 0;
-    for (int y = 0; y < maze.getHeight(); y++) {
-        for (int x = 0; x < maze.getWidth(); x++) {
-            if (maze.getCell(x, y) == 3) {
-                twins.emplace_back(x + 0.5f, y + 0.5f);
-                twinCount++;
-                std::cout << "  Twin #" << twinCount << " at grid (" << x << ", " << y << ")" << std::endl;
-            }
-        }
-    }
-
-    std::cout << "Total twins spawned: " << twins.size() << std::endl;
-
-    std::cout << "Game initialized!" << std::endl;
-    std::cout << "==============================" << std::endl;
+    LOG_INFO("Game initialized!");
+    LOG_INFO("==============================");
 }
 
 Game::~Game() {
+    // 打开过统计（环境变量或 F3）就在退出时导出
+    if (Profiler::instance().isEnabled()) {
+        Profiler::instance().writeCsv(profileCsvPath.empty() ? "profile.csv" : profileCsvPath);
+    }
+    if (!slowFrameSnapshot.empty()) {
+        slowFrameSnapshot.saveToFile("slowframe.hmss");
+    }
 }
 
+/**
+ * 模拟的主种子：回放时必须和录像时相同
+ */
+std::uint64_t Game::chooseSeed() {
+    std::string replayPath;
+    if (readEnvironmentVariable("HORRORMAZE_REPLAY", replayPath) && !replayPath.empty()) {
+        if (!replay.load(replayPath)) {
+            throw std::runtime_error("Input recording missing or unreadable.");
+        }
+        return replay.getSeed();
+    }
+    return RngService::seedFromEnvironment();
+}
+
+/**
+ * 主循环：固定步长模拟 + 插值渲染
+ *
+ * 真实经过的时间累加到 accumulator，每攒够 FIXED_TIMESTEP 就推进一步模拟；
+ * 剩余不足一步的时间作为插值比例交给渲染。
+ * 一帧最多追赶 MAX_STEPS_PER_FRAME 步，长时间卡顿（拖动窗口、断点）后多出的时间直接丢弃，
+ * 避免模拟越追越慢。
+ */
 void Game::run() {
     sf::Clock clock;
+    float accumulator = 0.0f;
 
     while (window.isOpen()) {
-        float deltaTime = clock.restart().asSeconds();
+        ProfileScope frameScope(ProfileStage::Frame);
+        float lastFrameSeconds = clock.restart().asSeconds();
+        accumulator += lastFrameSeconds;
+
+        if (Profiler::instance().isEnabled()) {
+            checkpointFrame(lastFrameSeconds);
+        }
 
         processEvents();
-        update(deltaTime);
-        render();
+
+        int steps = 0;
+        while (accumulator >= FIXED_TIMESTEP && steps < MAX_STEPS_PER_FRAME) {
+            update(FIXED_TIMESTEP);
+            accumulator -= FIXED_TIMESTEP;
+            steps++;
+        }
+        if (accumulator >= FIXED_TIMESTEP) {
+            accumulator = std::fmod(accumulator, FIXED_TIMESTEP);
+        }
+
+        render(accumulator / FIXED_TIMESTEP);
+
+        frameScope.stop();
+        Profiler::instance().endFrame();
     }
 };
 
@@ -219,19 +223,44 @@ void Game::processEvents() {
                 window.close();
             }
 
+            // F3：帧时间统计面板
+            if (keyPress->code == sf::Keyboard::Key::F3) {
+                profilerOverlay.toggle();
+            }
+
+            // F4：切换第一人称渲染路径（SFML / 软件帧缓冲）；只影响画面，回放时也可以用来对比
+            if (keyPress->code == sf::Keyboard::Key::F4) {
+                renderer.setSoftwareRendering(!renderer.isSoftwareRendering());
+            }
+        }
+
+        // 回放时只响应关闭窗口和ESC，游戏输入全部来自录像
+        if (replay.isLoaded()) {
+            continue;
+        }
+
+        if (const auto* keyPress = event->getIf<sf::Event::KeyPressed>()) {
             // Tab键切换视角
             if (keyPress->code == sf::Keyboard::Key::Tab && gameState == GameState::Playing) {
-                switchView();
+                pendingInput.toggleView = true;
             }
 
             // F键切换打火机
             if (keyPress->code == sf::Keyboard::Key::F && gameState == GameState::Playing) {
-                player.toggleLighter();
+                pendingInput.input.toggleLighter = true;
             }
 
             // E键钻墙/出墙
             if (keyPress->code == sf::Keyboard::Key::E && gameState == GameState::Playing) {
-                player.toggleWallPhase(maze);
+                pendingInput.input.toggleWallPhase = true;
+            }
+
+            // F9：回退；F10：回到最近一次慢帧开始前（死亡/胜利界面也可以用）
+            if (keyPress->code == sf::Keyboard::Key::F9 && gameState != GameState::Menu && canUseSnapshots()) {
+                rewind();
+            }
+            if (keyPress->code == sf::Keyboard::Key::F10 && gameState != GameState::Menu && canUseSnapshots()) {
+                restoreSlowFrame();
             }
         }
 
@@ -250,475 +279,272 @@ void Game::handleMenuInput(const sf::Event& event) {
         if (keyPress->code == sf::Keyboard::Key::Enter ||
             keyPress->code == sf::Keyboard::Key::Space) {
             // 开始游戏或重新开始
-            std::cout << "\n>>> Starting Game! <<<\n" << std::endl;
-            gameState = GameState::Playing;
-            deathCause = DeathCause::None;  // 重置死亡原因
-            score = 0;
-            lives = 3;
-            currentLevel = 1;
-            gameTimer = GAME_TIME_LIMIT;  // 重置计时器为5分钟
-
-            // 播放背景音乐
-            if (soundsLoaded && backgroundMusic.getStatus() != sf::SoundSource::Status::Playing) {
-                backgroundMusic.play();
-                std::cout << "Background music started." << std::endl;
-            }
-
-            // 重置玩家位置
-            sf::Vector2i startPos = maze.getPlayerStart();
-            player = Player(startPos.x + 0.5f, startPos.y + 0.5f);
-            std::cout << "Player respawned at: (" << startPos.x << ", " << startPos.y << ")" << std::endl;
-
-            // === 重新生成鬼（在左下或右上1/4区域随机刷新）===
-            ghosts.clear();
-            escapePath.clear();  // 清空逃生路径
-
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> regionChoice(0, 1);
-            bool spawnInBottomLeft = (regionChoice(gen) == 0);
-
-            // 找到对应区域的所有可行走位置
-            std::vector<sf::Vector2i> validSpawnPositions;
-            int halfWidth = maze.getWidth() / 2;
-            int halfHeight = maze.getHeight() / 2;
-
-            if (spawnInBottomLeft) {
-                std::cout << "Spawning ghost in BOTTOM-LEFT quarter..." << std::endl;
-                for (int y = halfHeight; y < maze.getHeight(); y++) {
-                    for (int x = 0; x < halfWidth; x++) {
-                        if (!maze.isWall(x, y)) {
-                            validSpawnPositions.push_back({x, y});
-                        }
-                    }
-                }
-            } else {
-                std::cout << "Spawning ghost in TOP-RIGHT quarter..." << std::endl;
-                for (int y = 0; y < halfHeight; y++) {
-                    for (int x = halfWidth; x < maze.getWidth(); x++) {
-                        if (!maze.isWall(x, y)) {
-                            validSpawnPositions.push_back({x, y});
-                        }
-                    }
-                }
-            }
-
-            // 随机选择位置生成鬼
-            if (!validSpawnPositions.empty()) {
-                std::uniform_int_distribution<> dis(0, static_cast<int>(validSpawnPositions.size()) - 1);
-                sf::Vector2i spawnPos = validSpawnPositions[dis(gen)];
-                ghosts.emplace_back(spawnPos.x + 0.5f, spawnPos.y + 0.5f);
-                std::cout << "Ghost spawned at: (" << spawnPos.x << ", " << spawnPos.y << ")" << std::endl;
-            }
-
-            // === 重置双胞胎陷阱 ===
-            twins.clear();
-            for (int y = 0; y < maze.getHeight(); y++) {
-                for (int x = 0; x < maze.getWidth(); x++) {
-                    if (maze.getCell(x, y) == 3) {
-                        twins.emplace_back(x + 0.5f, y + 0.5f);
-                    }
-                }
-            }
-            std::cout << "Twins respawned: " << twins.size() << " traps" << std::endl;
-
-            // 重置冻结状态
-            playerFrozen = false;
-            frozenTimer = 0.0f;
-
-            window.setMouseCursorVisible(false);
-            sf::Vector2u windowSize = window.getSize();
-            sf::Mouse::setPosition(
-                sf::Vector2i(static_cast<int>(windowSize.x / 2), static_cast<int>(windowSize.y / 2)),
-                window
-            );
+            startGame();
+            pendingInput = InputFrame();
+            pendingInput.reset = true;  // 录像里记在下一步上，回放到这一步时同样重新开始
         }
     }
 }
 
-void Game::handleGameInput(const sf::Event& event) {
-    // 游戏中的输入处理（移动等）将在后面实现
-}
+void Game::startGame() {
+    LOG_INFO("\n>>> Starting Game! <<<\n");
+    gameState = GameState::Playing;
+    deathCause = DeathCause::None;  // 重置死亡原因
+    score = 0;
+    lives = 3;
+    currentLevel = 1;
+
+    // 播放背景音乐
+    if (soundsLoaded && backgroundMusic.getStatus() != sf::SoundSource::Status::Playing) {
+        backgroundMusic.play();
+        LOG_INFO("Background music started.");
+    }
 
-void Game::update(float deltaTime) {
-    if (gameState == GameState::Playing) {
-        // === 更新双胞胎冻结状态 ===
-        if (playerFrozen) {
-            // 如果有激活的双胞胎，让玩家视角逐渐转向它
-            if (activeTwinIndex >= 0 && activeTwinIndex < static_cast<int>(twins.size())) {
-                const Twin& atwin = twins[activeTwinIndex];
-                float dx = atwin.getX() - player.getX();
-                float dy = atwin.getY() - player.getY();
-                float targetAngle = std::atan2(dy, dx);
-                float playerAngle = std::atan2(player.getDirY(), player.getDirX());
-
-                // 计算角度差并归一到[-pi, pi]
-                float diff = targetAngle - playerAngle;
-                const float PI = std::acos(-1.0f);
-                while (diff > PI) diff -= 2.0f * PI;
-                while (diff < -PI) diff += 2.0f * PI;
-
-                // 平滑转向，限制每帧最大旋转量
-                float rotateSpeed = 2.5f; // rad/s
-                float maxStep = rotateSpeed * deltaTime;
-                if (std::abs(diff) > maxStep) {
-                    diff = (diff > 0.0f) ? maxStep : -maxStep;
-                }
-                player.rotate(diff);
-            }
+    // 玩家回到起点，重新刷新鬼和双胞胎，计时器复位
+    sim.reset();
 
-            // 计时器递减并在结束时解除冻结
-            frozenTimer -= deltaTime;
-            if (frozenTimer <= 0.0f) {
-                playerFrozen = false;
-                frozenTimer = 0.0f;
-                player.unfreeze();
-                player.enableLighter();
+    // 上一局的快照作废，开局状态作为第一个回退点
+    rewindSnapshots.clear();
+    frameStartSnapshot.data.clear();
+    if (canUseSnapshots()) {
+        sim.saveSnapshot(rewindSnapshots.push());
+    }
 
-                // 活动双胞胎索引重置
-                activeTwinIndex = -1;
+    window.setMouseCursorVisible(false);
+    sf::Vector2u windowSize = window.getSize();
+    sf::Mouse::setPosition(
+        sf::Vector2i(static_cast<int>(windowSize.x / 2), static_cast<int>(windowSize.y / 2)),
+        window
+    );
+}
 
-                sf::Vector2u windowSize = window.getSize();
-                sf::Mouse::setPosition(
-                    sf::Vector2i(static_cast<int>(windowSize.x / 2), static_cast<int>(windowSize.y / 2)),
-                    window
-                );
+/**
+ * 每帧开始时：上一帧太慢就留下它开始前的状态，然后保存本帧开始前的状态
+ *
+ * 保存一次只要几微秒（见 HorrorMazeHeadless --snapshot-check），两个快照对象轮换使用，不分配内存。
+ */
+void Game::checkpointFrame(float lastFrameSeconds) {
+    if (gameState != GameState::Playing || !canUseSnapshots()) {
+        return;
+    }
+    if (lastFrameSeconds > SLOW_FRAME_SECONDS && !frameStartSnapshot.empty()) {
+        std::swap(slowFrameSnapshot, frameStartSnapshot);
+        slowFrameSeconds = lastFrameSeconds;
+        LOG_DEBUG("Slow frame: " << lastFrameSeconds * 1000.0f << " ms (from step " << slowFrameSnapshot.step << ")");
+    }
+    sim.saveSnapshot(frameStartSnapshot);
+}
 
-                std::cout << "Player unfrozen!" << std::endl;
-            }
-        }
+/**
+ * 回退：恢复到至少1秒前的快照
+ *
+ * 不到1秒前的快照直接丢弃，所以连按 F9 每次都会再往前退。
+ * 最早的那个快照一直保留（最多退到它为止）。
+ */
+void Game::rewind() {
+    while (rewindSnapshots.size() > 1 &&
+           rewindSnapshots.fromNewest(0)->step + SNAPSHOT_INTERVAL_STEPS > sim.getStepCount()) {
+        rewindSnapshots.dropNewest();
+    }
+    const SimulationSnapshot* target = rewindSnapshots.fromNewest(0);
+    if (!target) {
+        return;
+    }
 
-        if (!playerFrozen && !player.isEnteringWall() && window.hasFocus()) {
-            sf::Vector2u windowSize = window.getSize();
-            sf::Vector2i center(static_cast<int>(windowSize.x / 2), static_cast<int>(windowSize.y / 2));
-            sf::Vector2i mousePos = sf::Mouse::getPosition(window);
-            int deltaX = mousePos.x - center.x;
-            if (deltaX != 0) {
-                float angle = static_cast<float>(deltaX) * MOUSE_SENSITIVITY;
-                player.rotate(angle);
-            }
-            sf::Mouse::setPosition(center, window);
-        }
+    if (sim.restoreSnapshot(*target)) {
+        LOG_INFO("Rewound to step " << target->step << " (" << rewindSnapshots.size() - 1 << " earlier snapshots left)");
+    } else {
+        rewindSnapshots.clear();  // 恢复失败时模拟已重新开始一局
+    }
+    resumeFromSnapshot();
+}
 
-        // 更新玩家（处理移动）
-        player.update(deltaTime, maze);
-
-        // === 检测双胞胎触发 ===
-        // 触发条件：玩家在视野内(±30°) OR 距离在2.5格内
-        // 并且不能被墙阻挡（需要直视/直达）
-        if (!playerFrozen) {
-            for (size_t ti = 0; ti < twins.size(); ++ti) {
-                auto& twin = twins[ti];
-                if (twin.isActivated()) continue; // 已触发的跳过
-
-                // 新触发条件：玩家和双胞胎在同一行或同一列，且中间没有墙
-                int playerGX = static_cast<int>(player.getX());
-                int playerGY = static_cast<int>(player.getY());
-                int twinGX = static_cast<int>(twin.getX());
-                int twinGY = static_cast<int>(twin.getY());
-
-                bool sameLine = (playerGX == twinGX) || (playerGY == twinGY);
-                if (!sameLine) {
-                    continue; // 不在同一行或列，跳过
-                }
+void Game::restoreSlowFrame() {
+    if (slowFrameSnapshot.empty()) {
+        LOG_INFO("No slow frame recorded yet (press F3 or set HORRORMAZE_PROFILE to track frame times)");
+        return;
+    }
 
-                // 计算相对向量和距离（用于旋转/音量/日志）
-                float dx = twin.getX() - player.getX();
-                float dy = twin.getY() - player.getY();
-                float dist = std::sqrt(dx * dx + dy * dy);
-
-                // 检查是否被墙阻挡（Bresenham格线检测）
-                int x0 = static_cast<int>(player.getX());
-                int y0 = static_cast<int>(player.getY());
-                int x1 = static_cast<int>(twin.getX());
-                int y1 = static_cast<int>(twin.getY());
-
-                bool blocked = false;
-                int sx = (x0 < x1) ? 1 : -1;
-                int sy = (y0 < y1) ? 1 : -1;
-                int dxl = std::abs(x1 - x0);
-                int dyl = std::abs(y1 - y0);
-                int err = dxl - dyl;
-                int cx = x0;
-                int cy = y0;
-                while (true) {
-                    // 忽略起点和终点自身的格子（如果玩家或双胞胎正好在墙里会另外处理）
-                    if (!(cx == x0 && cy == y0) && !(cx == x1 && cy == y1)) {
-                        if (maze.isWall(cx, cy)) {
-                            blocked = true;
-                            break;
-                        }
-                    }
-
-                    if (cx == x1 && cy == y1) break;
-
-                    int e2 = 2 * err;
-                    if (e2 > -dyl) { err -= dyl; cx += sx; }
-                    if (e2 < dxl) { err += dxl; cy += sy; }
-                }
+    if (sim.restoreSnapshot(slowFrameSnapshot)) {
+        LOG_INFO("Restored state before slow frame (" << slowFrameSeconds * 1000.0f << " ms, step "
+                 << slowFrameSnapshot.step << ")");
+        // 比恢复后的状态更新的回退快照不再有意义
+        while (rewindSnapshots.size() > 0 && rewindSnapshots.fromNewest(0)->step > sim.getStepCount()) {
+            rewindSnapshots.dropNewest();
+        }
+    } else {
+        rewindSnapshots.clear();
+    }
+    resumeFromSnapshot();
+}
 
-                if (blocked) {
-                    // 被墙阻挡，不能触发
-                    continue;
-                }
+void Game::resumeFromSnapshot() {
+    gameState = GameState::Playing;
+    deathCause = DeathCause::None;
+    pendingInput = InputFrame();
 
-                // 触发硬控：根据遭遇次数选择台词
-                twinEncounterCount++;  // 增加遭遇次数
-
-                // 确定播放哪个台词
-                sf::SoundBuffer* chosenBuffer = nullptr;
-                if (twinEncounterCount == 1) {
-                    // 第一次遭遇：播放 Twins1
-                    chosenBuffer = &twinVoice1Buffer;
-                    std::cout << "\n>>> FIRST TWIN ENCOUNTER! Playing Twins1.mp3 <<<" << std::endl;
-                } else if (twinEncounterCount == 2) {
-                    // 第二次遭遇：播放 Twins2
-                    chosenBuffer = &twinVoice2Buffer;
-                    std::cout << "\n>>> SECOND TWIN ENCOUNTER! Playing Twins2.mp3 <<<" << std::endl;
-                } else {
-                    // 第三次及以后：随机播放
-                    std::random_device rd;
-                    std::mt19937 gen(rd());
-                    std::uniform_int_distribution<> dis(0, 1);
-                    if (dis(gen) == 0) {
-                        chosenBuffer = &twinVoice1Buffer;
-                        std::cout << "\n>>> TWIN ENCOUNTER #" << twinEncounterCount << "! Randomly playing Twins1.mp3 <<<" << std::endl;
-                    } else {
-                        chosenBuffer = &twinVoice2Buffer;
-                        std::cout << "\n>>> TWIN ENCOUNTER #" << twinEncounterCount << "! Randomly playing Twins2.mp3 <<<" << std::endl;
-                    }
-                }
+    if (heresJohnnyLoaded && heresJohnnyMusic.getStatus() == sf::SoundSource::Status::Playing) {
+        heresJohnnyMusic.stop();
+    }
+    if (soundsLoaded && backgroundMusic.getStatus() != sf::SoundSource::Status::Playing) {
+        backgroundMusic.play();
+    }
 
-                // 获取音频时长作为冻结时长
-                float audioDuration = Twin::getDefaultSoundDuration(); // fallback
-                if (chosenBuffer && chosenBuffer->getDuration().asSeconds() > 0.0f) {
-                    audioDuration = chosenBuffer->getDuration().asSeconds();
-                }
+    window.setMouseCursorVisible(false);
+    sf::Vector2u windowSize = window.getSize();
+    sf::Mouse::setPosition(
+        sf::Vector2i(static_cast<int>(windowSize.x / 2), static_cast<int>(windowSize.y / 2)),
+        window
+    );
+}
 
-                twin.activate(audioDuration);
-                playerFrozen = true;
-                frozenTimer = audioDuration;
-                player.freeze();
-                player.disableLighter();
-                activeTwinIndex = static_cast<int>(ti);
-
-                // 播放选中的台词音效
-                if (soundsLoaded && twinVoiceSound && chosenBuffer) {
-                    // 如果之前正在播放，先停止
-                    if (twinVoiceSound->getStatus() == sf::SoundSource::Status::Playing) {
-                        twinVoiceSound->stop();
-                    }
-                    // 设置新的缓冲并播放
-                    twinVoiceSound->setBuffer(*chosenBuffer);
-                    twinVoiceSound->play();
-                    std::cout << "Twin voice playing! duration=" << audioDuration << " seconds" << std::endl;
-                }
+void Game::handleGameInput(const sf::Event& event) {
+    // 游戏中的输入处理（移动等）将在后面实现
+}
 
-                break; // 一次只触发一个
-            }
+void Game::update(float deltaTime) {
+    InputFrame frame;
+    if (replay.isLoaded()) {
+        // 回放：每个模拟步长取录像里的一步
+        if (replay.finished()) {
+            LOG_INFO("Replay finished: " << replay.getFrameCount() << " steps");
+            window.close();
+            return;
         }
-
-        // 更新所有双胞胎（声音衰减）
-        for (auto& twin : twins) {
-            twin.update(deltaTime);
+        frame = replay.next();
+        if (frame.reset) {
+            startGame();
         }
+    } else if (gameState == GameState::Playing) {
+        frame = sampleInput();
+    }
 
-        // 更新玩家的闪灵状态
-        player.updateSpiritVision(deltaTime);
+    if (gameState != GameState::Playing) {
+        return;
+    }
 
-        // 更新鬼脚步声（音量和立体声位置）
+    recorder.record(frame);
+    if (frame.toggleView) {
+        switchView();
+    }
+
+    sim.step(deltaTime, frame.input);
+    if (canUseSnapshots() && sim.getStatus() == SimulationStatus::Running &&
+        sim.getStepCount() % SNAPSHOT_INTERVAL_STEPS == 0) {
+        sim.saveSnapshot(rewindSnapshots.push());
+    }
+    handleSimulationEvents();
+
+    // 更新鬼脚步声（音量和立体声位置）
+    if (gameState == GameState::Playing) {
         updateGhostFootsteps(deltaTime);
+    }
+}
 
-        // 更新游戏计时器
-        gameTimer -= deltaTime * 1.5f;
-        if (gameTimer <= 0.0f) {
-            // 时间耗尽，冻死
-            std::cout << "\n*** YOU ARE FROZEN TO DEATH! ***\n" << std::endl;
-            gameState = GameState::GameOver;
-            deathCause = DeathCause::Frozen;
-            window.setMouseCursorVisible(true);
-
-            // 停止背景音乐
-            if (backgroundMusic.getStatus() == sf::SoundSource::Status::Playing) {
-                backgroundMusic.stop();
-                std::cout << "Background music stopped." << std::endl;
-            }
-            return;
+/**
+ * 采样本步的输入：键盘按住状态 + 鼠标水平位移 + 按键事件里攒下的开关
+ */
+InputFrame Game::sampleInput() {
+    InputFrame frame = pendingInput;
+    pendingInput = InputFrame();  // 开关只生效一次
+    PlayerInput& input = frame.input;
+
+    input.forward = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
+                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up);
+    input.backward = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) ||
+                     sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down);
+    input.strafeLeft = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) ||
+                       sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left);
+    input.strafeRight = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) ||
+                        sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right);
+    input.run = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) ||
+                sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift);
+    input.crouch = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) ||
+                   sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl);
+
+    // 鼠标转向（冻结和钻墙动画期间不读鼠标）
+    if (!sim.isPlayerFrozen() && !sim.getPlayer().isEnteringWall() && window.hasFocus()) {
+        PROFILE_SCOPE(MouseLook);
+        sf::Vector2u windowSize = window.getSize();
+        sf::Vector2i center(static_cast<int>(windowSize.x / 2), static_cast<int>(windowSize.y / 2));
+        sf::Vector2i mousePos = sf::Mouse::getPosition(window);
+        int deltaX = mousePos.x - center.x;
+        if (deltaX != 0) {
+            input.turn = static_cast<float>(deltaX) * MOUSE_SENSITIVITY;
         }
+        sf::Mouse::setPosition(center, window);
+    }
 
-        // 更新所有鬼（考虑双胞胎声音吸引）
-        for (auto& ghost : ghosts) {
-            // 检查是否有双胞胎发出的声音比玩家更响
-            float loudestTwinSound = 0.0f;
-            const Twin* loudestTwin = nullptr;
-
-            for (const auto& twin : twins) {
-                float twinSound = twin.getSoundLevel();
-                if (twinSound > 0.0f) {
-                    // 计算双胞胎到鬼的距离
-                    float dx = twin.getX() - ghost.getX();
-                    float dy = twin.getY() - ghost.getY();
-                    float distance = std::sqrt(dx * dx + dy * dy);
-
-                    // 空气衰减（和玩家声音一样）
-                    float perceivedSound = twinSound / (1.0f + distance * 0.08f);
-
-                    // === 计算声音路径上的墙数量（Bresenham直线算法）===
-                    int x0 = static_cast<int>(ghost.getX());
-                    int y0 = static_cast<int>(ghost.getY());
-                    int x1 = static_cast<int>(twin.getX());
-                    int y1 = static_cast<int>(twin.getY());
-
-                    int wallCount = 0;
-                    int dx_line = std::abs(x1 - x0);
-                    int dy_line = std::abs(y1 - y0);
-                    int sx = (x0 < x1) ? 1 : -1;
-                    int sy = (y0 < y1) ? 1 : -1;
-                    int err = dx_line - dy_line;
-
-                    int currentX = x0;
-                    int currentY = y0;
-
-                    while (true) {
-                        // 检查当前格子是否是墙
-                        if (maze.isWall(currentX, currentY)) {
-                            wallCount++;
-                        }
-
-                        // 到达终点
-                        if (currentX == x1 && currentY == y1) {
-                            break;
-                        }
-
-                        // Bresenham步进
-                        int e2 = 2 * err;
-                        if (e2 > -dy_line) {
-                            err -= dy_line;
-                            currentX += sx;
-                        }
-                        if (e2 < dx_line) {
-                            err += dx_line;
-                            currentY += sy;
-                        }
-                    }
-
-                    // === 应用墙壁衰减（和玩家声音一样，每堵墙×0.3）===
-                    for (int i = 0; i < wallCount; i++) {
-                        perceivedSound *= 0.3f;
-                    }
-
-                    if (perceivedSound > loudestTwinSound) {
-                        loudestTwinSound = perceivedSound;
-                        loudestTwin = &twin;
-                    }
-                }
-            }
-
-            // 如果双胞胎声音足够响（大于阈值15.0），让鬼追踪双胞胎位置
-            if (loudestTwinSound > 15.0f && loudestTwin != nullptr) {
-                // 通知鬼听到了双胞胎的声音（触发状态切换）
-                ghost.notifyLoudSound(loudestTwinSound, {
-                    static_cast<int>(loudestTwin->getX()),
-                    static_cast<int>(loudestTwin->getY())
-                });
+    return frame;
+}
 
-                // 创建一个临时"玩家"位置代表双胞胎
-                // 这样鬼会追向双胞胎而不是玩家
-                Player twinTarget(loudestTwin->getX(), loudestTwin->getY());
-                ghost.update(deltaTime, twinTarget, maze);
-            } else {
-                // 否则正常追踪玩家
-                ghost.update(deltaTime, player, maze);
+/**
+ * 模拟事件的表现：台词、音乐、鼠标和界面切换
+ */
+void Game::handleSimulationEvents() {
+    for (const auto& event : sim.getEvents()) {
+        switch (event.type) {
+        case SimulationEventType::TwinEncounter: {
+            // 播放选中的台词音效
+            sf::SoundBuffer* chosenBuffer = (event.voice == 0) ? &twinVoice1Buffer : &twinVoice2Buffer;
+            if (soundsLoaded && twinVoiceSound) {
+                // 如果之前正在播放，先停止
+                if (twinVoiceSound->getStatus() == sf::SoundSource::Status::Playing) {
+                    twinVoiceSound->stop();
+                }
+                // 设置新的缓冲并播放
+                twinVoiceSound->setBuffer(*chosenBuffer);
+                twinVoiceSound->play();
+                LOG_INFO("Twin voice playing! duration=" << event.duration << " seconds");
             }
+            break;
         }
 
-        // === 检测鬼距离，触发闪灵 ===
-        if (!player.isSpiritVisionActive()) {  // 未激活时才检测
-            for (const auto& ghost : ghosts) {
-                float dx = ghost.getX() - player.getX();
-                float dy = ghost.getY() - player.getY();
-                float distance = std::sqrt(dx * dx + dy * dy);
-
-                if (distance < SPIRIT_VISION_TRIGGER_DISTANCE) {
-                    // 鬼靠近！激活闪灵
-                    player.activateSpiritVision();
-
-                    // 计算逃生路径
-                    sf::Vector2i playerPos(static_cast<int>(player.getX()), static_cast<int>(player.getY()));
-                    sf::Vector2i exitPos(18, 19);  // 根据地图获取终点位置
-
-                    // 尝试从地图中找到终点（2=出口）
-                    for (int y = 0; y < maze.getHeight(); y++) {
-                        for (int x = 0; x < maze.getWidth(); x++) {
-                            if (maze.getCell(x, y) == 2) {
-                                exitPos = {x, y};
-                                break;
-                            }
-                        }
-                    }
-
-                    escapePath = findPathToExit(playerPos, exitPos);
-                    std::cout << "Escape path calculated: " << escapePath.size() << " steps" << std::endl;
-                    break;  // 只需要触发一次
-                }
-            }
+        case SimulationEventType::PlayerUnfrozen: {
+            sf::Vector2u windowSize = window.getSize();
+            sf::Mouse::setPosition(
+                sf::Vector2i(static_cast<int>(windowSize.x / 2), static_cast<int>(windowSize.y / 2)),
+                window
+            );
+            break;
         }
 
-        // === 检查鬼是否抓到玩家 ===
-        // 玩家在墙内且关闭打火机时免疫碰撞检测
-        // 如果在墙内但开着打火机，仍然会被抓到
-        if (!player.isInWall() || player.isLighterOn()) {
-            for (const auto& ghost : ghosts) {
-                float dx = ghost.getX() - player.getX();
-                float dy = ghost.getY() - player.getY();
-                float distance = std::sqrt(dx * dx + dy * dy);
-
-                // 增大碰撞范围到0.8格，更容易触发
-                if (distance < 0.8f) {
-                    std::cout << "\n*** YOU ARE CHOPPED! ***\n" << std::endl;
-                    std::cout << "Ghost caught player at distance: " << distance << std::endl;
-
-                    // 播放 "Here's Johnny" 音效（脚步声继续播放）
-                    if (heresJohnnyLoaded) {
-                        heresJohnnyMusic.play();
-                        std::cout << "Here's Johnny!" << std::endl;
-                    }
-
-                    gameState = GameState::GameOver;
-                    deathCause = DeathCause::Chopped;
-                    window.setMouseCursorVisible(true);
-
-                    // 停止背景音乐（但保留脚步声和 Here's Johnny 音效）
-                    if (backgroundMusic.getStatus() == sf::SoundSource::Status::Playing) {
-                        backgroundMusic.stop();
-                        std::cout << "Background music stopped." << std::endl;
-                    }
-                    return;  // 立即停止更新
-                }
-            }
-        } else {
-            // 调试输出：玩家在墙内且打火机关闭，免疫碰撞
-            static bool inWallWarningShown = false;
-            if (!inWallWarningShown) {
-                std::cout << "Player is in wall with lighter OFF - immune to ghost collision" << std::endl;
-                inWallWarningShown = true;
+        case SimulationEventType::PlayerCaught:
+            // 播放 "Here's Johnny" 音效（脚步声继续播放）
+            if (heresJohnnyLoaded) {
+                heresJohnnyMusic.play();
+                LOG_INFO("Here's Johnny!");
             }
+            break;
+
+        case SimulationEventType::SpiritVision:
+        case SimulationEventType::FrozenToDeath:
+        case SimulationEventType::ReachedExit:
+            break;
         }
+    }
 
-        // === 检查玩家是否到达出口 ===
-        int playerGridX = static_cast<int>(player.getX());
-        int playerGridY = static_cast<int>(player.getY());
+    if (sim.getStatus() == SimulationStatus::Running) {
+        return;
+    }
 
-        if (maze.getCell(playerGridX, playerGridY) == 2) {
-            // 到达出口！
-            std::cout << "\n*** CONGRATULATIONS! You found the exit! ***\n" << std::endl;
-            gameState = GameState::Victory;
-            window.setMouseCursorVisible(true);
+    // 一局结束：切换界面
+    if (sim.getStatus() == SimulationStatus::Victory) {
+        gameState = GameState::Victory;
+    } else {
+        gameState = GameState::GameOver;
+        deathCause = sim.getDeathCause();
+
+        // 停止背景音乐（但保留脚步声和 Here's Johnny 音效）
+        if (backgroundMusic.getStatus() == sf::SoundSource::Status::Playing) {
+            backgroundMusic.stop();
+            LOG_INFO("Background music stopped.");
         }
     }
+    window.setMouseCursorVisible(true);
 }
 
-void Game::render() {
+void Game::render(float alpha) {
     window.clear(sf::Color::Black);
 
     if (gameState == GameState::Menu) {
@@ -779,6 +605,12 @@ void Game::render() {
         }
 
     } else if (gameState == GameState::Playing) {
+        // 渲染用的玩家副本：位姿在上一个和当前模拟状态之间插值
+        const Player& player = sim.getPlayer();
+        const Maze& maze = sim.getMaze();
+        Player viewPlayer = player;
+        viewPlayer.setPose(Player::interpolatePose(sim.getPreviousPlayerPose(), player.getPose(), alpha));
+
         // 根据视角模式选择渲染方式
         if (viewMode == ViewMode::TopDown) {
             // 俯视图渲染
@@ -786,41 +618,47 @@ void Game::render() {
                 WINDOW_WIDTH / static_cast<float>(maze.getWidth()),
                 WINDOW_HEIGHT / static_cast<float>(maze.getHeight())
             );
-            renderer.renderTopDown(window, player, maze);
+            renderer.renderTopDown(window, viewPlayer, maze);
+
+            PROFILE_SCOPE(Sprites);
 
             // 渲染所有双胞胎
-            for (const auto& twin : twins) {
+            for (const auto& twin : sim.getTwins()) {
                 twin.renderTopDown(window, cellSize);
             }
 
             // 渲染所有鬼
-            for (const auto& ghost : ghosts) {
-                ghost.renderTopDown(window, cellSize);
+            for (const auto& ghost : sim.getGhosts()) {
+                ghost.renderTopDown(window, cellSize, alpha);
             }
 
         } else {
             // 第一人称3D渲染
-            renderer.renderFirstPerson(window, player, maze, escapePath);
+            renderer.renderFirstPerson(window, viewPlayer, maze, sim.getEscapePath());
 
-            // 第一人称渲染双胞胎
-            const auto& zBuffer = renderer.getZBuffer();
-            for (const auto& twin : twins) {
-                twin.renderFirstPerson(window, player, WINDOW_WIDTH, WINDOW_HEIGHT, zBuffer);
-            }
+            PROFILE_SCOPE(Sprites);
 
-            // 第一人称渲染鬼（sprite渲染 + 深度测试）
-            for (const auto& ghost : ghosts) {
-                ghost.renderFirstPerson(window, player, WINDOW_WIDTH, WINDOW_HEIGHT, zBuffer);
+            // 第一人称 sprite：双胞胎和鬼一起按距离排序、深度测试、按纹理合批绘制
+            SpriteRenderer& sprites = renderer.getSprites();
+            sprites.clear();
+            for (const auto& twin : sim.getTwins()) {
+                twin.addBillboard(sprites);
+            }
+            for (const auto& ghost : sim.getGhosts()) {
+                ghost.addBillboard(sprites, alpha);
             }
+            renderer.renderSprites(window, viewPlayer);
         }
 
         // HUD（头顶显示信息）
+        PROFILE_SCOPE(Hud);
         sf::RectangleShape hudBg({300, 120});
         hudBg.setFillColor(sf::Color(30, 30, 30, 200));
         hudBg.setPosition({WINDOW_WIDTH - 320.0f, 10});
         window.draw(hudBg);
 
         // 显示剩余时间（用色块表示分钟和秒）
+        float gameTimer = sim.getTimeRemaining();
         int minutes = static_cast<int>(gameTimer) / 60;
         int seconds = static_cast<int>(gameTimer) % 60;
 
@@ -1072,16 +910,19 @@ void Game::render() {
         }
     }
 
+    profilerOverlay.draw(window, fontLoaded ? &font : nullptr);
+
+    PROFILE_SCOPE(Display);
     window.display();
 }
 
 void Game::switchView() {
     if (viewMode == ViewMode::TopDown) {
         viewMode = ViewMode::FirstPerson;
-        std::cout << "Switched to First-Person view" << std::endl;
+        LOG_INFO("Switched to First-Person view");
     } else {
         viewMode = ViewMode::TopDown;
-        std::cout << "Switched to Top-Down view" << std::endl;
+        LOG_INFO("Switched to Top-Down view");
     }
 }
 
@@ -1089,7 +930,7 @@ void Game::switchView() {
  * 加载所有游戏声音
  */
 void Game::loadSounds() {
-    std::cout << "=== Loading Sounds ===" << std::endl;
+    LOG_INFO("=== Loading Sounds ===");
 
     // === 加载背景音乐 ===
     std::vector<std::string> bgmPaths = {
@@ -1102,7 +943,7 @@ void Game::loadSounds() {
     for (const auto& path : bgmPaths) {
         if (backgroundMusic.openFromFile(path)) {
             bgmLoaded = true;
-            std::cout << "Background music loaded: " << path << std::endl;
+            LOG_INFO("Background music loaded: " << path);
             backgroundMusic.setLooping(true);  // 循环播放
             backgroundMusic.setVolume(30.0f);  // 设置音量为30%（不要太响）
             break;
@@ -1110,7 +951,7 @@ void Game::loadSounds() {
     }
 
     if (!bgmLoaded) {
-        std::cerr << "WARNING: Could not load background music!" << std::endl;
+        LOG_WARN("WARNING: Could not load background music!");
     }
 
     // === 加载鬼脚步声 ===
@@ -1124,7 +965,7 @@ void Game::loadSounds() {
     for (const auto& path : stepPaths) {
         if (ghostStepBuffer.loadFromFile(path)) {
             stepLoaded = true;
-            std::cout << "Ghost step sound loaded: " << path << std::endl;
+            LOG_INFO("Ghost step sound loaded: " << path);
 
             // 构造sf::Sound对象
             ghostStepSound.emplace(ghostStepBuffer);
@@ -1137,7 +978,7 @@ void Game::loadSounds() {
     }
 
     if (!stepLoaded) {
-        std::cerr << "WARNING: Could not load ghost step sound!" << std::endl;
+        LOG_WARN("WARNING: Could not load ghost step sound!");
     }
 
     // === 加载双胞胎台词音效 ===
@@ -1157,26 +998,26 @@ void Game::loadSounds() {
     for (const auto& path : twinVoice1Paths) {
         if (twinVoice1Buffer.loadFromFile(path)) {
             twinVoice1Loaded = true;
-            std::cout << "Twin voice 1 loaded: " << path << std::endl;
+            LOG_INFO("Twin voice 1 loaded: " << path);
             break;
         }
     }
 
     if (!twinVoice1Loaded) {
-        std::cerr << "WARNING: Could not load Twins1.mp3!" << std::endl;
+        LOG_WARN("WARNING: Could not load Twins1.mp3!");
     }
 
     bool twinVoice2Loaded = false;
     for (const auto& path : twinVoice2Paths) {
         if (twinVoice2Buffer.loadFromFile(path)) {
             twinVoice2Loaded = true;
-            std::cout << "Twin voice 2 loaded: " << path << std::endl;
+            LOG_INFO("Twin voice 2 loaded: " << path);
             break;
         }
     }
 
     if (!twinVoice2Loaded) {
-        std::cerr << "WARNING: Could not load Twins2.mp3!" << std::endl;
+        LOG_WARN("WARNING: Could not load Twins2.mp3!");
     }
 
     // 构造双胞胎台词音效对象（使用 Twins1 作为初始缓冲）
@@ -1196,19 +1037,19 @@ void Game::loadSounds() {
     for (const auto& path : heresJohnnyPaths) {
         if (heresJohnnyMusic.openFromFile(path)) {
             heresJohnnyLoaded = true;
-            std::cout << "Here's Johnny sound loaded: " << path << std::endl;
+            LOG_INFO("Here's Johnny sound loaded: " << path);
             heresJohnnyMusic.setVolume(100.0f);  // 满音量
             break;
         }
     }
 
     if (!heresJohnnyLoaded) {
-        std::cerr << "WARNING: Could not load HeresJohnny.mp3!" << std::endl;
+        LOG_WARN("WARNING: Could not load HeresJohnny.mp3!");
     }
 
     soundsLoaded = (bgmLoaded || stepLoaded || twinVoice1Loaded || twinVoice2Loaded || heresJohnnyLoaded);
-    std::cout << "Sound loading complete." << std::endl;
-    std::cout << "========================" << std::endl;
+    LOG_INFO("Sound loading complete.");
+    LOG_INFO("========================");
 }
 
 /**
@@ -1220,6 +1061,10 @@ void Game::loadSounds() {
  * 3. 根据鬼相对于玩家朝向的位置计算立体声（左右声道）
  */
 void Game::updateGhostFootsteps(float deltaTime) {
+    PROFILE_SCOPE(Footsteps);
+    const Player& player = sim.getPlayer();
+    const Maze& maze = sim.getMaze();
+    const std::vector<Ghost>& ghosts = sim.getGhosts();
     if (!soundsLoaded || ghosts.empty() || !ghostStepSound) {
         footstepIntensity = 0.0f;
         return;
@@ -1260,47 +1105,14 @@ void Game::updateGhostFootsteps(float deltaTime) {
         float soundLevel = baseSound / (1.0f + distance * AIR_ATTENUATION);
 
         // === 计算声音路径上的墙数量（Bresenham直线算法）===
-        int x0 = static_cast<int>(player.getX());
-        int y0 = static_cast<int>(player.getY());
-        int x1 = static_cast<int>(ghost.getX());
-        int y1 = static_cast<int>(ghost.getY());
-
-        int wallCount = 0;
-        int dx_line = std::abs(x1 - x0);
-        int dy_line = std::abs(y1 - y0);
-        int sx = (x0 < x1) ? 1 : -1;
-        int sy = (y0 < y1) ? 1 : -1;
-        int err = dx_line - dy_line;
-
-        int currentX = x0;
-        int currentY = y0;
-
-        while (true) {
-            // 检查当前格子是否是墙
-            if (maze.isWall(currentX, currentY)) {
-                wallCount++;
-                // 超过最大墙数，声音完全被阻挡
-                if (wallCount > MAX_WALL_COUNT) {
-                    soundLevel = 0.0f;
-                    break;
-                }
-            }
-
-            // 到达终点
-            if (currentX == x1 && currentY == y1) {
-                break;
-            }
-
-            // Bresenham步进
-            int e2 = 2 * err;
-            if (e2 > -dy_line) {
-                err -= dy_line;
-                currentX += sx;
-            }
-            if (e2 < dx_line) {
-                err += dx_line;
-                currentY += sy;
-            }
+        // 数到第 MAX_WALL_COUNT+1 堵墙即可停止：超过上限声音完全被阻挡
+        int wallCount = GridTrace::trace(
+            maze.getWallBitmap(),
+            static_cast<int>(player.getX()), static_cast<int>(player.getY()),
+            static_cast<int>(ghost.getX()), static_cast<int>(ghost.getY()),
+            GridTrace::StopAfterWalls(MAX_WALL_COUNT + 1)).walls;
+        if (wallCount > MAX_WALL_COUNT) {
+            soundLevel = 0.0f;
         }
 
         // === 应用墙壁衰减（和玩家声音一样）===
@@ -1339,91 +1151,3 @@ void Game::updateGhostFootsteps(float deltaTime) {
 
     footstepAngle = std::atan2(right, forward);
 }
-
-/**
- * A*寻路算法：找到从起点到终点的最短路径
- */
-std::vector<sf::Vector2i> Game::findPathToExit(sf::Vector2i start, sf::Vector2i goal) {
-    struct Node {
-        int x, y;
-        float g, h, f;
-        int parentIndex;  // 使用索引代替指针
-
-        Node(int x_, int y_, float g_, float h_, int pIdx)
-            : x(x_), y(y_), g(g_), h(h_), f(g_ + h_), parentIndex(pIdx) {}
-
-        bool operator>(const Node& other) const {
-            return f > other.f;
-        }
-    };
-
-    // 检查起点和终点是否有效
-    if (maze.isWall(start.x, start.y) || maze.isWall(goal.x, goal.y)) {
-        return {};
-    }
-
-    std::set<std::pair<int, int>> closedSet;
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openQueue;
-    std::vector<Node> allNodes;
-    allNodes.reserve(1000);  // 预留空间，减少重新分配
-
-    auto heuristic = [goal](int x, int y) -> float {
-        return static_cast<float>(std::abs(x - goal.x) + std::abs(y - goal.y));
-    };
-
-    // 添加起点（parentIndex = -1 表示没有父节点）
-    openQueue.emplace(start.x, start.y, 0.0f, heuristic(start.x, start.y), -1);
-
-    while (!openQueue.empty()) {
-        Node current = openQueue.top();
-        openQueue.pop();
-
-        if (closedSet.count({current.x, current.y})) {
-            continue;
-        }
-
-        closedSet.insert({current.x, current.y});
-
-        // 保存当前节点并记录索引
-        int currentIndex = static_cast<int>(allNodes.size());
-        allNodes.push_back(current);
-
-        // 到达目标
-        if (current.x == goal.x && current.y == goal.y) {
-            std::vector<sf::Vector2i> path;
-            int idx = currentIndex;
-            while (idx != -1) {
-                path.push_back({allNodes[idx].x, allNodes[idx].y});
-                idx = allNodes[idx].parentIndex;
-            }
-            std::reverse(path.begin(), path.end());
-            return path;
-        }
-
-        // 扩展邻居
-        const int dx[] = {0, 0, -1, 1};
-        const int dy[] = {-1, 1, 0, 0};
-
-        for (int i = 0; i < 4; i++) {
-            int nx = current.x + dx[i];
-            int ny = current.y + dy[i];
-
-            if (nx < 0 || ny < 0 || nx >= maze.getWidth() || ny >= maze.getHeight()) {
-                continue;
-            }
-            if (maze.isWall(nx, ny)) {
-                continue;
-            }
-            if (closedSet.count({nx, ny})) {
-                continue;
-            }
-
-            float newG = current.g + 1.0f;
-            float newH = heuristic(nx, ny);
-
-            openQueue.emplace(nx, ny, newG, newH, currentIndex);  // 使用索引
-        }
-    }
-
-    return {};  // 未找到路径
-}
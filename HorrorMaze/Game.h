@@ -4,11 +4,10 @@
 #include <memory>
 #include <vector>
 #include <optional>
-#include "Maze.h"      // 包含迷宫类
-#include "Player.h"    // 包含玩家类
-#include "Renderer.h"  // 包含渲染器类
-#include "Ghost.h"     // 包含鬼类
-#include "Twin.h"      // 包含双胞胎类
+#include "Renderer.h"    // 包含渲染器类
+#include "Simulation.h"  // 模拟核心（迷宫、玩家、鬼、双胞胎）
+#include "InputRecording.h"  // 输入录像/回放
+#include "ProfilerOverlay.h" // 帧时间统计面板
 
 enum class GameState {
     Menu,
@@ -23,12 +22,6 @@ enum class ViewMode {
     FirstPerson   // 第一人称
 };
 
-enum class DeathCause {
-    None,         // 未死亡
-    Chopped,      // 被鬼抓到
-    Frozen        // 时间耗尽，冻死
-};
-
 class Game {
 public:
     Game();
@@ -39,11 +32,12 @@ public:
 private:
     void processEvents();
     void update(float deltaTime);
-    void render();
+    void render(float alpha);  // alpha：在上一个和当前模拟状态之间插值的比例 [0, 1)
 
     void handleMenuInput(const sf::Event& event);
     void handleGameInput(const sf::Event& event);
     void switchView(); // 切换视角
+    void startGame();  // 开始/重新开始一局（菜单里按 Enter，或回放到重新开始的那一步）
 
     // 窗口
     sf::RenderWindow window;
@@ -57,21 +51,40 @@ private:
     int score;
     int lives;
     int currentLevel;
-    float gameTimer;  // 游戏剩余时间（秒）
-    static constexpr float GAME_TIME_LIMIT = 300.0f;  // 5分钟时间限制
 
-    // 游戏对象
-    Maze maze;      // 迷宫
-    Player player;  // 玩家
+    // 输入录像/回放：HORRORMAZE_RECORD 指定录像文件时记录每一步的输入和种子，
+    // HORRORMAZE_REPLAY 指定录像文件时忽略键盘鼠标，按录像逐步回放（回放完自动退出）
+    // 回放对象必须声明在 sim 之前：sim 的种子来自录像
+    InputReplay replay;
+    InputRecorder recorder;
+    std::uint64_t chooseSeed();  // 回放时用录像里的种子，否则见 RngService::seedFromEnvironment
+
+    // 模拟核心：游戏规则和所有游戏对象都在这里，Game 只负责输入、声音和渲染
+    Simulation sim;
     Renderer renderer;  // 渲染器
-    std::vector<Ghost> ghosts;  // 鬼的列表
-    std::vector<Twin> twins;    // 双胞胎陷阱列表
 
-    // 双胞胎冻结状态
-    bool playerFrozen;           // 玩家是否被冻结
-    float frozenTimer;           // 冻结剩余时间
-    static constexpr float FREEZE_DURATION = 4.0f;  // 冻结持续4秒
-    int activeTwinIndex;         // 当前导致硬控的双胞胎索引（-1表示无）
+    // 按键事件里的一次性动作（F/E/Tab/重新开始），合并到下一个模拟步长的输入里
+    InputFrame pendingInput;
+    InputFrame sampleInput();  // 采样键盘和鼠标，生成本步的输入
+    void handleSimulationEvents();  // 根据模拟事件播放声音、切换界面
+
+    // 性能统计：F3 显示面板，HORRORMAZE_PROFILE=文件名 从启动开始统计，退出时导出CSV
+    ProfilerOverlay profilerOverlay;
+    std::string profileCsvPath;
+
+    // 快照：每 SNAPSHOT_INTERVAL_STEPS 步存一份到环形缓冲区，F9 回退到至少1秒前（连按继续往前）。
+    // 打开性能统计时每帧开始前也存一份，超过 SLOW_FRAME_SECONDS 的帧留下它开始前的状态，
+    // F10 回到那里重现慢帧，退出时存成 slowframe.hmss（HorrorMazeHeadless --snapshot 可以读取）。
+    // 录像和回放时不可用：回退后的输入和录像对不上
+    SnapshotRing rewindSnapshots;
+    SimulationSnapshot frameStartSnapshot;  // 本帧开始前的状态
+    SimulationSnapshot slowFrameSnapshot;   // 最近一次慢帧开始前的状态
+    float slowFrameSeconds;                 // 那一帧的耗时
+    bool canUseSnapshots() const { return !replay.isLoaded() && !recorder.isOpen(); }
+    void checkpointFrame(float lastFrameSeconds);  // 每帧开始时调用（只在性能统计打开时）
+    void rewind();
+    void restoreSlowFrame();
+    void resumeFromSnapshot();  // 恢复快照后切回游戏界面、恢复背景音乐和鼠标
 
     // 字体
     sf::Font font;  // 游戏字体
@@ -86,7 +99,6 @@ private:
     sf::SoundBuffer twinVoice1Buffer;  // 双胞胎台词1缓冲
     sf::SoundBuffer twinVoice2Buffer;  // 双胞胎台词2缓冲
     std::optional<sf::Sound> twinVoiceSound;  // 双胞胎台词音效（延迟构造）
-    int twinEncounterCount;  // 双胞胎遭遇次数（0=未遇到，1=第一次，2=第二次，3+=随机）
     bool soundsLoaded;  // 声音是否加载成功
 
     // 声音辅助函数
@@ -95,16 +107,18 @@ private:
     float footstepIntensity;
     float footstepAngle;
 
-    // 闪灵相关
-    std::vector<sf::Vector2i> escapePath;  // 逃生路径（A*计算）
-    static constexpr float SPIRIT_VISION_TRIGGER_DISTANCE = 5.0f;  // 触发距离（格）
+    // 固定步长模拟：模拟固定以 SIMULATION_RATE 推进，渲染不限帧率，
+    // 画面上的玩家和鬼在最近两个模拟状态之间插值
+    static constexpr float SIMULATION_RATE = 120.0f;                  // 模拟频率（Hz）
+    static constexpr float FIXED_TIMESTEP = 1.0f / SIMULATION_RATE;
+    static constexpr int MAX_STEPS_PER_FRAME = 8;                     // 一帧最多追赶的步数（卡顿后丢弃多余时间）
 
-    // A*寻路算法
-    std::vector<sf::Vector2i> findPathToExit(sf::Vector2i start, sf::Vector2i goal);
+    static constexpr int SNAPSHOT_INTERVAL_STEPS = 120;               // 回退快照间隔（1秒）
+    static constexpr std::size_t REWIND_SNAPSHOTS = 30;               // 最多回退30秒
+    static constexpr float SLOW_FRAME_SECONDS = 1.0f / 30.0f;          // 超过这个时长的帧算慢帧
 
     // 常量
     static constexpr int WINDOW_WIDTH = 1200;
     static constexpr int WINDOW_HEIGHT = 800;
-    static constexpr float TARGET_FPS = 60.0f;
     static constexpr float MOUSE_SENSITIVITY = 0.000833333f;
 };
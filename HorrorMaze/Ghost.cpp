@@ -1,119 +1,195 @@
 #include "Ghost.h"
 #include "Player.h"
 #include "Maze.h"
+#include "GridTrace.h"
+#include "Logger.h"
+#include "SimulationSnapshot.h"
 #include <cmath>
-#include <iostream>
 #include <algorithm>
-#include <random>
 #include <set>
 
-// 静态成员初始化
-sf::Texture Ghost::s_spriteTexture;
-bool Ghost::s_textureLoaded = false;
-
 /**
  * 构造函数：创建一个鬼
  */
-Ghost::Ghost(float startX, float startY)
+Ghost::Ghost(float startX, float startY, const Pcg32& randomStream, const SimulationParams& params)
     : x(startX)
     , y(startY)
+    , previousX(startX)
+    , previousY(startY)
     , dirX(0.0f)
     , dirY(1.0f)
     , patrolSpeed(1.8f)      // 巡逻速度：较慢
     , alertSpeed(2.4f)       // 警戒速度：中等
-    , chaseSpeed(3.5f)       // 追逐速度：较快
+    , chaseSpeed(params.ghostChaseSpeed)  // 追逐速度：较快
     , currentSpeed(0.0f)
     , currentState(State::Patrol)
     , stateChangeTimer(0.0f)
     , alertTimer(0.0f)
     , movePauseTimer(0.0f)
     , movePaused(false)
+    , hearingThresholds{params.hearingThreshold, params.twinLureThreshold}
     , pathIndex(0)
     , pathUpdateTimer(0.0f)
     , lastKnownPlayerCell(0, 0)
     , noPathWarningTimer(0.0f)  // 初始化警告计时器
+    , perception{false, false, false, false, {StimulusType::Footstep, 0.0f, 0.0f, 0.0f}, startX, startY}
+    , chaseTargetX(startX)
+    , chaseTargetY(startY)
+    , rng(randomStream)
 {
-    std::cout << "Ghost spawned at: (" << x << ", " << y << ")" << std::endl;
+    LOG_INFO("Ghost spawned at: (" << x << ", " << y << ")");
     chooseRandomDirection();  // 初始随机方向
 }
 
 /**
- * 核心更新函数：每帧调用
+ * 核心更新函数：感知、决策、行动依次执行（全部按帧率）
+ *
+ * Game 通过 UpdateScheduler 按不同频率分别调用 perceive/think/act，
+ * 这里保留一次性更新的入口。
  */
-void Ghost::update(float deltaTime, const Player& player, const Maze& maze) {
-    float prevX = x;
-    float prevY = y;
+void Ghost::update(float deltaTime, const Player& player, const Maze& maze, const StimulusSystem& stimuli) {
+    perceive(player, maze, stimuli);
+    think(deltaTime);
+    act(deltaTime, maze);
+}
 
-    // 更新警告计时器
-    if (noPathWarningTimer > 0.0f) {
-        noPathWarningTimer -= deltaTime;
+/**
+ * 感知：视听检测，结果缓存到 perception 供决策使用
+ */
+void Ghost::perceive(const Player& player, const Maze& maze, const StimulusSystem& stimuli) {
+    if (!beginPerception(player, maze, stimuli)) {
+        return;
     }
 
+    // 注意：如果玩家在墙内但打火机开着，会继续执行下面的检测逻辑
+    // canSeeLighter() 会检测到打火机光
+    perception.canSee = canSeePlayer(player, maze);
+    perception.canSeeLighter = canSeeLighter(player, maze);  // 打火机光照检测
+}
+
+/**
+ * 批量感知：鬼所在格到玩家所在格的墙数已经由 PerceptionBatch 算好
+ *
+ * 视线查预计算可见集（视野半径内一次位测试，见 canSeePlayer），
+ * 墙数只用于打火机：最多1堵墙
+ */
+void Ghost::perceive(const Player& player, int wallsToPlayer, const Maze& maze, const StimulusSystem& stimuli) {
+    if (!beginPerception(player, maze, stimuli)) {
+        return;
+    }
+
+    perception.canSee = canSeePlayer(player, maze);
+    perception.canSeeLighter = player.isLighterOn() && (wallsToPlayer <= 1);
+}
+
+/**
+ * 感知的公共部分：从刺激系统听最强的声音，记录玩家位置，判断玩家是否藏在墙里
+ *
+ * @return false = 玩家不可见（视觉结果已清空，听觉结果仍然有效）
+ */
+bool Ghost::beginPerception(const Player& player, const Maze& maze, const StimulusSystem& stimuli) {
+    perception.heard = stimuli.findStrongest(maze.getWallBitmap(), x, y, hearingThresholds, perception.sound);
+
+    perception.targetX = player.getX();
+    perception.targetY = player.getY();
+
     // === 玩家在墙内时的特殊处理 ===
     // 如果玩家在墙内但开着打火机，光会暴露位置，鬼仍然可以检测
-    // 只有在墙内且关闭打火机时，鬼才无法检测
-    if (player.isInWall() && !player.isLighterOn()) {
+    // 只有在墙内且关闭打火机时，鬼才无法检测（此时玩家也不会发出脚步声）
+    perception.targetHidden = player.isInWall() && !player.isLighterOn();
+    if (perception.targetHidden) {
+        perception.canSee = false;
+        perception.canSeeLighter = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 决策：根据最近一次感知结果推进状态机
+ *
+ * @param elapsed 距上次决策经过的时间（用于推进状态计时器）
+ */
+void Ghost::think(float elapsed) {
+    // === 环境声音（双胞胎等）：直接追向声源，优先于玩家 ===
+    if (perception.heard && perception.sound.type != StimulusType::Footstep) {
+        if (stateChangeTimer > 0.0f) {
+            stateChangeTimer -= elapsed;
+        }
+        lastKnownPlayerCell = {
+            static_cast<int>(perception.sound.x),
+            static_cast<int>(perception.sound.y)
+        };
+        chaseTargetX = perception.sound.x;
+        chaseTargetY = perception.sound.y;
+        if (currentState != State::Chasing) {
+            transitionTo(State::Chasing);
+            LOG_DEBUG("Ghost: Heard loud sound! Investigating...");
+        }
+        return;
+    }
+
+    if (perception.targetHidden) {
         // 玩家在墙内且关闭打火机，鬼看不到，切换到巡逻状态
         if (currentState != State::Patrol) {
             transitionTo(State::Patrol);
-            std::cout << "Ghost: Player phased into wall (lighter off), lost target..." << std::endl;
-        }
-        updatePatrol(deltaTime, maze);  // 执行巡逻行为
-
-        if (deltaTime > 0.0f) {
-            float dx = x - prevX;
-            float dy = y - prevY;
-            currentSpeed = std::sqrt(dx * dx + dy * dy) / deltaTime;
-        } else {
-            currentSpeed = 0.0f;
+            LOG_DEBUG("Ghost: Player phased into wall (lighter off), lost target...");
         }
-        return;  // 直接返回，不进行声音检测
+        return;
     }
 
-    // 注意：如果玩家在墙内但打火机开着，会继续执行下面的检测逻辑
-    // canSeeLighter() 会检测到打火机光
-
     // 更新状态切换冷却计时器
     if (stateChangeTimer > 0.0f) {
-        stateChangeTimer -= deltaTime;
+        stateChangeTimer -= elapsed;
     }
 
-    // === 视听检测 ===
-    bool canSee = canSeePlayer(player, maze);
-    bool canSeeLighterGlow = canSeeLighter(player, maze);  // 打火机光照检测
-    float soundLevel = calculateSoundLevel(player, maze);
-    bool canHear = (soundLevel > HEARING_THRESHOLD);
+    bool canHear = perception.heard;  // 此时听到的只可能是玩家脚步声
 
-    if (canSee || canSeeLighterGlow || canHear) {
+    if (perception.canSee || perception.canSeeLighter || canHear) {
         lastKnownPlayerCell = {
-            static_cast<int>(player.getX()),
-            static_cast<int>(player.getY())
+            static_cast<int>(perception.targetX),
+            static_cast<int>(perception.targetY)
         };
+        chaseTargetX = perception.targetX;
+        chaseTargetY = perception.targetY;
         if (currentState != State::Chasing) {
             transitionTo(State::Chasing);
-            if (canSeeLighterGlow && !canSee) {
-                std::cout << "Ghost: LIGHTER DETECTED! CHASING!" << std::endl;
+            if (perception.canSeeLighter && !perception.canSee) {
+                LOG_DEBUG("Ghost: LIGHTER DETECTED! CHASING!");
             } else {
-                std::cout << "Ghost: CHASING!" << std::endl;
+                LOG_DEBUG("Ghost: CHASING!");
             }
         }
     } else {
         if (currentState == State::Chasing && stateChangeTimer <= 0.0f) {
             transitionTo(State::Alert);
-            std::cout << "Ghost: Lost target, alert..." << std::endl;
+            LOG_DEBUG("Ghost: Lost target, alert...");
         } else if (currentState == State::Alert) {
-            alertTimer -= deltaTime;
+            alertTimer -= elapsed;
             if (alertTimer <= 0.0f && stateChangeTimer <= 0.0f) {
                 transitionTo(State::Patrol);
-                std::cout << "Ghost: Back to patrol." << std::endl;
+                LOG_DEBUG("Ghost: Back to patrol.");
             }
         }
     }
+}
+
+/**
+ * 行动：按当前状态移动（含碰撞），每帧调用
+ */
+void Ghost::act(float deltaTime, const Maze& maze) {
+    float prevX = x;
+    float prevY = y;
+
+    // 更新警告计时器
+    if (noPathWarningTimer > 0.0f) {
+        noPathWarningTimer -= deltaTime;
+    }
 
     // === 根据当前状态执行行为 ===
     switch (currentState) {
         case State::Chasing:
-            updateChasing(deltaTime, player, maze);
+            updateChasing(deltaTime, chaseTargetX, chaseTargetY, maze);
             break;
         case State::Alert:
             updateAlert(deltaTime, maze);
@@ -133,90 +209,13 @@ void Ghost::update(float deltaTime, const Player& player, const Maze& maze) {
     }
 }
 
-/**
- * 计算鬼能听到的玩家声音强度
- *
- * 算法：
- * 1. 计算欧几里得距离
- * 2. 使用Bresenham直线算法计算声音路径上穿过的墙数量
- * 3. 应用距离衰减和墙壁衰减
- */
-float Ghost::calculateSoundLevel(const Player& player, const Maze& maze) const {
-    // === 1. 计算距离 ===
-    float dx = player.getX() - x;
-    float dy = player.getY() - y;
-    float distance = std::sqrt(dx * dx + dy * dy);
-
-    float baseSound = PLAYER_SOUND_WALK;
-    switch (player.getMoveMode()) {
-        case Player::MoveMode::Run:
-            baseSound = PLAYER_SOUND_RUN;
-            break;
-        case Player::MoveMode::Crouch:
-            baseSound = PLAYER_SOUND_CROUCH;
-            break;
-        case Player::MoveMode::Walk:
-        default:
-            baseSound = PLAYER_SOUND_WALK;
-            break;
-    }
-
-    // === 2. 基础距离衰减（空气中） ===
-    float soundLevel = baseSound / (1.0f + distance * AIR_ATTENUATION);
-
-    // === 3. 计算声音路径上的墙数量（Bresenham直线算法）===
-    int x0 = static_cast<int>(x);
-    int y0 = static_cast<int>(y);
-    int x1 = static_cast<int>(player.getX());
-    int y1 = static_cast<int>(player.getY());
-
-    int wallCount = 0;
-
-    // Bresenham直线算法
-    int dx_line = std::abs(x1 - x0);
-    int dy_line = std::abs(y1 - y0);
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dx_line - dy_line;
-
-    int currentX = x0;
-    int currentY = y0;
-
-    while (true) {
-        // 检查当前格子是否是墙
-        if (maze.isWall(currentX, currentY)) {
-            wallCount++;
-        }
-
-        // 到达终点
-        if (currentX == x1 && currentY == y1) {
-            break;
-        }
-
-        // Bresenham步进
-        int e2 = 2 * err;
-        if (e2 > -dy_line) {
-            err -= dy_line;
-            currentX += sx;
-        }
-        if (e2 < dx_line) {
-            err += dx_line;
-            currentY += sy;
-        }
-    }
-
-    // === 4. 应用墙壁衰减 ===
-    for (int i = 0; i < wallCount; i++) {
-        soundLevel *= WALL_ATTENUATION_MULT;  // 每堵墙衰减到30%
-    }
-
-    return soundLevel;
-}
-
 /**
  * 视线检测：在一定距离内且没有墙阻挡
  */
 bool Ghost::canSeePlayer(const Player& player, const Maze& maze) const {
+    // 视野半径必须落在预计算可见集内，下面才能直接查表
+    static_assert(VISION_RANGE <= VisibilityCache::RADIUS, "VISION_RANGE exceeds VisibilityCache::RADIUS");
+
     float dx = player.getX() - x;
     float dy = player.getY() - y;
     float distance = std::sqrt(dx * dx + dy * dy);
@@ -224,39 +223,9 @@ bool Ghost::canSeePlayer(const Player& player, const Maze& maze) const {
         return false;
     }
 
-    int x0 = static_cast<int>(x);
-    int y0 = static_cast<int>(y);
-    int x1 = static_cast<int>(player.getX());
-    int y1 = static_cast<int>(player.getY());
-
-    int dxl = std::abs(x1 - x0);
-    int dyl = std::abs(y1 - y0);
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dxl - dyl;
-
-    int currentX = x0;
-    int currentY = y0;
-
-    while (true) {
-        if (maze.isWall(currentX, currentY)) {
-            return false;
-        }
-        if (currentX == x1 && currentY == y1) {
-            break;
-        }
-        int e2 = 2 * err;
-        if (e2 > -dyl) {
-            err -= dyl;
-            currentX += sx;
-        }
-        if (e2 < dxl) {
-            err += dxl;
-            currentY += sy;
-        }
-    }
-
-    return true;
+    // 视线：视野半径在预计算可见集范围内，查表即可
+    return maze.hasLineOfSight(static_cast<int>(x), static_cast<int>(y),
+                               static_cast<int>(player.getX()), static_cast<int>(player.getY()));
 }
 
 /**
@@ -273,44 +242,12 @@ bool Ghost::canSeeLighter(const Player& player, const Maze& maze) const {
         return false;
     }
 
-    // 计算鬼到玩家的直线路径上的墙数量
-    int x0 = static_cast<int>(x);
-    int y0 = static_cast<int>(y);
-    int x1 = static_cast<int>(player.getX());
-    int y1 = static_cast<int>(player.getY());
-
-    int wallCount = 0;
-    int dxl = std::abs(x1 - x0);
-    int dyl = std::abs(y1 - y0);
-    int sx = (x0 < x1) ? 1 : -1;
-    int sy = (y0 < y1) ? 1 : -1;
-    int err = dxl - dyl;
-
-    int currentX = x0;
-    int currentY = y0;
-
-    while (true) {
-        // 检查当前格子是否是墙
-        if (maze.isWall(currentX, currentY)) {
-            wallCount++;
-        }
-
-        // 到达终点
-        if (currentX == x1 && currentY == y1) {
-            break;
-        }
-
-        // Bresenham步进
-        int e2 = 2 * err;
-        if (e2 > -dyl) {
-            err -= dyl;
-            currentX += sx;
-        }
-        if (e2 < dxl) {
-            err += dxl;
-            currentY += sy;
-        }
-    }
+    // 计算鬼到玩家的直线路径上的墙数量（数到第2堵墙就可以停了）
+    int wallCount = GridTrace::trace(
+        maze.getWallBitmap(),
+        static_cast<int>(x), static_cast<int>(y),
+        static_cast<int>(player.getX()), static_cast<int>(player.getY()),
+        GridTrace::StopAfterWalls(LIGHTER_WALL_LIMIT)).walls;
 
     // 光可以穿透1堵墙，所以墙数<=1时可以检测到
     return (wallCount <= 1);
@@ -339,15 +276,15 @@ void Ghost::transitionTo(State newState) {
 /**
  * 追踪状态行为：使用A*寻路追踪玩家
  */
-void Ghost::updateChasing(float deltaTime, const Player& player, const Maze& maze) {
+void Ghost::updateChasing(float deltaTime, float targetPosX, float targetPosY, const Maze& maze) {
     // === 定期更新路径（避免每帧计算A*） ===
     pathUpdateTimer += deltaTime;
     if (pathUpdateTimer >= PATH_UPDATE_INTERVAL || currentPath.empty()) {
         pathUpdateTimer = 0.0f;
 
         // 计算到玩家位置的新路径
-        int targetX = static_cast<int>(player.getX());
-        int targetY = static_cast<int>(player.getY());
+        int targetX = static_cast<int>(targetPosX);
+        int targetY = static_cast<int>(targetPosY);
         currentPath = findPath(targetX, targetY, maze);
         pathIndex = 0;
 
@@ -357,13 +294,13 @@ void Ghost::updateChasing(float deltaTime, const Player& player, const Maze& maz
 
             // 只在冷却结束时输出警告（避免刷屏）
             if (noPathWarningTimer <= 0.0f) {
-                std::cout << "Ghost: No path found to player (player may be in wall)" << std::endl;
+                LOG_DEBUG("Ghost: No path found to player (player may be in wall)");
                 noPathWarningTimer = NO_PATH_WARNING_INTERVAL;  // 重置计时器
             }
 
             // 直接朝玩家方向移动（尝试绕过障碍）
-            float dx = player.getX() - x;
-            float dy = player.getY() - y;
+            float dx = targetPosX - x;
+            float dy = targetPosY - y;
             float dist = std::sqrt(dx * dx + dy * dy);
             if (dist > 0.1f) {
                 move(deltaTime, dx / dist, dy / dist, maze);
@@ -529,12 +466,8 @@ bool Ghost::checkCollision(float newX, float newY, const Maze& maze) const {
  * 选择一个新的随机游荡方向
  */
 void Ghost::chooseRandomDirection() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 3);
-
     // 四个基本方向：上、下、左、右
-    int direction = dis(gen);
+    int direction = static_cast<int>(rng.nextBelow(4));
     switch (direction) {
         case 0: dirX =  0.0f; dirY = -1.0f; break;  // 上
         case 1: dirX =  0.0f; dirY =  1.0f; break;  // 下
@@ -551,7 +484,7 @@ void Ghost::chooseRandomDirection() {
  * @param maze 迷宫对象
  * @return 路径点序列（从起点到终点，不包括起点）
  */
-std::vector<sf::Vector2i> Ghost::findPath(int targetX, int targetY, const Maze& maze) {
+std::vector<sf::Vector2i> Ghost::findPath(int targetX, int targetY, const Maze& maze) const {
     // A*节点
     struct Node {
         int x, y;
@@ -664,191 +597,48 @@ std::vector<sf::Vector2i> Ghost::findPath(int targetX, int targetY, const Maze&
 }
 
 /**
- * 渲染鬼（俯视图）
- */
-void Ghost::renderTopDown(sf::RenderWindow& window, float cellSize) const {
-    // 绘制鬼的圆点
-    float radius = cellSize * 0.25f;
-    sf::CircleShape ghostCircle(radius);
-
-    // 根据状态选择颜色
-    switch (currentState) {
-        case State::Chasing:
-            ghostCircle.setFillColor(sf::Color::Red);  // 追逐：红色
-            break;
-        case State::Alert:
-            ghostCircle.setFillColor(sf::Color(200, 120, 0));  // 警戒：橙色
-            break;
-        case State::Patrol:
-        default:
-            ghostCircle.setFillColor(sf::Color(100, 100, 100));  // 巡逻：灰色
-            break;
-    }
-
-    ghostCircle.setOrigin({radius, radius});
-    ghostCircle.setPosition({x * cellSize, y * cellSize});
-
-    window.draw(ghostCircle);
-
-    // 绘制路径（调试用）
-    if ((currentState == State::Chasing || currentState == State::Alert) && !currentPath.empty()) {
-        for (size_t i = 0; i < currentPath.size(); i++) {
-            sf::RectangleShape pathDot({3, 3});
-            pathDot.setFillColor(sf::Color::Yellow);
-            pathDot.setPosition({
-                currentPath[i].x * cellSize + cellSize / 2 - 1.5f,
-                currentPath[i].y * cellSize + cellSize / 2 - 1.5f
-            });
-            window.draw(pathDot);
-        }
-    }
-}
-
-/**
- * 加载鬼的sprite纹理（所有鬼共享）
- */
-bool Ghost::loadSpriteTexture(const std::string& filename) {
-    if (s_textureLoaded) {
-        return true;  // 已经加载过了
-    }
-
-    if (s_spriteTexture.loadFromFile(filename)) {
-        s_textureLoaded = true;
-        std::cout << "Ghost sprite loaded: " << filename << std::endl;
-        return true;
-    }
-
-    std::cerr << "Failed to load ghost sprite: " << filename << std::endl;
-    return false;
-}
-
-/**
- * 渲染鬼（第一人称视角）- Sprite渲染 + 深度测试
+ * 快照：按成员声明顺序逐个读写
  *
- * 算法原理（DOOM式sprite渲染）：
- * 1. 计算鬼相对于玩家的位置（世界坐标 → 相机坐标）
- * 2. 投影到屏幕空间（计算屏幕X坐标和Y坐标）
- * 3. 根据距离计算sprite大小
- * 4. 逐列绘制sprite，并进行深度测试（只渲染比墙近的部分）
+ * 速度和听觉阈值来自 SimulationParams，也一起保存，
+ * 这样快照恢复到的鬼和保存时完全相同，不依赖恢复方的参数。
  */
-void Ghost::renderFirstPerson(sf::RenderWindow& window, const Player& player,
-                               int screenWidth, int screenHeight,
-                               const std::vector<float>& zBuffer) const {
-    if (!s_textureLoaded) {
-        return;  // 没有加载纹理，不渲染
-    }
-
-    // === 步骤1：计算鬼相对于玩家的位置 ===
-    float spriteX = x - player.getX();
-    float spriteY = y - player.getY();
-
-    // === 步骤2：变换到相机坐标系 ===
-    float invDet = 1.0f / (player.getPlaneX() * player.getDirY() - player.getDirX() * player.getPlaneY());
-
-    float transformX = invDet * (player.getDirY() * spriteX - player.getDirX() * spriteY);
-    float transformY = invDet * (-player.getPlaneY() * spriteX + player.getPlaneX() * spriteY);
-
-    // === 步骤3：检查sprite是否在玩家前方 ===
-    if (transformY <= 0.1f) {
-        return;  // 在玩家背后或太近，不渲染
-    }
-
-    // === 步骤4：计算sprite在屏幕上的位置和大小 ===
-    int spriteScreenX = static_cast<int>((screenWidth / 2) * (1 + transformX / transformY));
-
-    // 减小sprite大小，避免近距离扭曲（使用0.6倍缩放）
-    int spriteHeight = static_cast<int>(screenHeight / transformY * 0.6f);
-    int spriteWidth = spriteHeight;
-
-    float horizon = screenHeight * 0.5f + player.getCameraOffsetY();
-    if (horizon < 1.0f) {
-        horizon = 1.0f;
-    }
-    if (horizon > screenHeight - 1.0f) {
-        horizon = screenHeight - 1.0f;
-    }
-    int horizonY = static_cast<int>(horizon);
-
-    // 调整垂直位置，让鬼"站"在地面上
-    int drawStartY = -spriteHeight / 2 + horizonY + spriteHeight / 4;  // 向下偏移
-    if (drawStartY < 0) drawStartY = 0;
-    int drawEndY = spriteHeight / 2 + horizonY + spriteHeight / 4;
-    if (drawEndY >= screenHeight) drawEndY = screenHeight - 1;
-
-    int drawStartX = -spriteWidth / 2 + spriteScreenX;
-    if (drawStartX < 0) drawStartX = 0;
-    int drawEndX = spriteWidth / 2 + spriteScreenX;
-    if (drawEndX >= screenWidth) drawEndX = screenWidth - 1;
-
-    // === 步骤5：逐列绘制sprite并进行深度测试 ===
-    sf::Vector2u texSize = s_spriteTexture.getSize();
-
-    for (int stripe = drawStartX; stripe < drawEndX; stripe++) {
-        // === 深度测试：只渲染比墙近的sprite列 ===
-        if (transformY >= zBuffer[stripe]) {
-            continue;  // 这一列被墙挡住了，跳过
-        }
-
-        // 计算纹理X坐标
-        int texX = static_cast<int>((stripe - (-spriteWidth / 2 + spriteScreenX)) * texSize.x / spriteWidth);
-
-        // 绘制一列sprite
-        sf::VertexArray quad(sf::PrimitiveType::TriangleStrip, 4);
-
-        // 纹理坐标
-        float texLeft = static_cast<float>(texX);
-        float texRight = texLeft + 1.0f;
-
-        // 根据距离调整亮度
-        float brightness = 1.0f / (1.0f + transformY * 0.1f);
-        brightness = std::max(0.3f, std::min(1.0f, brightness));
-
-        // 打火机开启时降低鬼的亮度（让鬼更隐蔽）
-        if (player.isLighterOn()) {
-            brightness *= 0.5f;  // 降低到50%亮度
-        }
-
-        std::uint8_t colorValue = static_cast<std::uint8_t>(255 * brightness);
-        sf::Color lightColor(colorValue, colorValue, colorValue);
-
-        // 设置4个顶点（一列）
-        quad[0].position = sf::Vector2f(static_cast<float>(stripe), static_cast<float>(drawStartY));
-        quad[0].texCoords = sf::Vector2f(texLeft, 0.0f);
-        quad[0].color = lightColor;
-
-        quad[1].position = sf::Vector2f(static_cast<float>(stripe + 1), static_cast<float>(drawStartY));
-        quad[1].texCoords = sf::Vector2f(texRight, 0.0f);
-        quad[1].color = lightColor;
-
-        quad[2].position = sf::Vector2f(static_cast<float>(stripe), static_cast<float>(drawEndY));
-        quad[2].texCoords = sf::Vector2f(texLeft, static_cast<float>(texSize.y));
-        quad[2].color = lightColor;
-
-        quad[3].position = sf::Vector2f(static_cast<float>(stripe + 1), static_cast<float>(drawEndY));
-        quad[3].texCoords = sf::Vector2f(texRight, static_cast<float>(texSize.y));
-        quad[3].color = lightColor;
-
-        // 绘制这一列
-        sf::RenderStates states;
-        states.texture = &s_spriteTexture;
-        window.draw(quad, states);
-    }
+void Ghost::saveState(SnapshotWriter& out) const {
+    out.write(x); out.write(y);
+    out.write(previousX); out.write(previousY);
+    out.write(dirX); out.write(dirY);
+    out.write(patrolSpeed); out.write(alertSpeed); out.write(chaseSpeed); out.write(currentSpeed);
+    out.write(currentState);
+    out.write(stateChangeTimer);
+    out.write(alertTimer);
+    out.write(movePauseTimer); out.write(movePaused);
+    out.write(hearingThresholds);
+    out.writeVector(currentPath);
+    out.write(pathIndex);
+    out.write(pathUpdateTimer);
+    out.write(lastKnownPlayerCell);
+    out.write(noPathWarningTimer);
+    out.write(perception);
+    out.write(chaseTargetX); out.write(chaseTargetY);
+    out.write(rng);
 }
 
-/**
- * 通知鬼听到了大声音（例如双胞胎发出的声音）
- *
- * @param soundLevel 声音强度
- * @param sourcePosition 声音源位置（格子坐标）
- */
-void Ghost::notifyLoudSound(float soundLevel, sf::Vector2i sourcePosition) {
-    // 如果声音足够大（超过听觉阈值），切换到追踪状态
-    if (soundLevel > HEARING_THRESHOLD) {
-        lastKnownPlayerCell = sourcePosition;
-
-        if (currentState != State::Chasing) {
-            transitionTo(State::Chasing);
-            std::cout << "Ghost: Heard loud sound! Investigating..." << std::endl;
-        }
-    }
+bool Ghost::loadState(SnapshotReader& in) {
+    in.read(x); in.read(y);
+    in.read(previousX); in.read(previousY);
+    in.read(dirX); in.read(dirY);
+    in.read(patrolSpeed); in.read(alertSpeed); in.read(chaseSpeed); in.read(currentSpeed);
+    in.read(currentState);
+    in.read(stateChangeTimer);
+    in.read(alertTimer);
+    in.read(movePauseTimer); in.read(movePaused);
+    in.read(hearingThresholds);
+    in.readVector(currentPath);
+    in.read(pathIndex);
+    in.read(pathUpdateTimer);
+    in.read(lastKnownPlayerCell);
+    in.read(noPathWarningTimer);
+    in.read(perception);
+    in.read(chaseTargetX); in.read(chaseTargetY);
+    in.read(rng);
+    return in.isOk();
 }
@@ -1,10 +1,19 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <string>
 #include <queue>
 #include <vector>
+#include "StimulusSystem.h"
+#include "RngService.h"
+#include "SimulationParams.h"
+
+namespace sf { class RenderWindow; class Texture; }
 
 class Maze;
 class Player;
+class SnapshotWriter;
+class SnapshotReader;
+class SpriteRenderer;
 
 /**
  * Ghost类：AI敌人，具有声音感知和智能追踪能力
@@ -23,21 +32,38 @@ public:
         Chasing   // 追逐状态
     };
 
-    // 构造函数
-    Ghost(float startX, float startY);
+    // 构造函数（randomStream：这只鬼独占的随机数流；params：听觉阈值和追逐速度）
+    Ghost(float startX, float startY, const Pcg32& randomStream,
+          const SimulationParams& params = SimulationParams());
+
+    // 核心更新函数（感知+决策+行动，全部按帧率执行）
+    void update(float deltaTime, const Player& player, const Maze& maze, const StimulusSystem& stimuli);
+
+    // === 分阶段更新（由 UpdateScheduler 按不同频率调用） ===
+    // 感知：看玩家 + 听刺激系统里的声音（低频）
+    void perceive(const Player& player, const Maze& maze, const StimulusSystem& stimuli);
+    // 同上，鬼到玩家的墙数已由 PerceptionBatch 批量算好（只用于打火机，视线仍查可见集；
+    // 墙数最多数到 LIGHTER_WALL_LIMIT）
+    void perceive(const Player& player, int wallsToPlayer, const Maze& maze, const StimulusSystem& stimuli);
+    static constexpr int LIGHTER_WALL_LIMIT = 2;  // 打火机光穿透1堵墙，数到第2堵就可以停
+    void think(float elapsed);                                // 决策：状态机（低频）
+    void act(float deltaTime, const Maze& maze);              // 行动：移动和碰撞（每帧）
 
-    // 核心更新函数
-    void update(float deltaTime, const Player& player, const Maze& maze);
+    // 渲染函数（定义在 GhostRender.cpp；alpha：在上一个和当前模拟状态之间插值，1 = 当前位置）
+    // 第一人称：把自己作为 billboard 交给 SpriteRenderer，和其他 sprite 一起排序、绘制
+    void addBillboard(SpriteRenderer& sprites, float alpha = 1.0f) const;
+    void renderTopDown(sf::RenderWindow& window, float cellSize, float alpha = 1.0f) const;
 
-    // 渲染函数
-    void renderFirstPerson(sf::RenderWindow& window, const Player& player,
-                          int screenWidth, int screenHeight,
-                          const std::vector<float>& zBuffer) const;
-    void renderTopDown(sf::RenderWindow& window, float cellSize) const;
+    // 记录当前位置作为"上一个模拟状态"（每个固定步长开始前调用）
+    void storePreviousPosition() { previousX = x; previousY = y; }
+
+    // 快照：保存/恢复全部状态，包括路径、计时器、感知结果和随机数流（见 SimulationSnapshot.h）
+    void saveState(SnapshotWriter& out) const;
+    bool loadState(SnapshotReader& in);
 
     // 加载sprite纹理（静态方法，所有鬼共享）
     static bool loadSpriteTexture(const std::string& filename);
-    static const sf::Texture* getSpriteTexture() { return &s_spriteTexture; }
+    static const sf::Texture* getSpriteTexture();
 
     // 获取位置信息
     float getX() const { return x; }
@@ -46,12 +72,25 @@ public:
     float getSpeed() const { return currentSpeed; }
     float getMaxSpeed() const { return chaseSpeed; }
 
-    // 通知鬼听到了大声音（用于双胞胎等环境声音）
-    void notifyLoudSound(float soundLevel, sf::Vector2i sourcePosition);
+    // === 感知和寻路查询（不修改状态，基准测试也直接调用） ===
+
+    // 视野半径内且视线畅通
+    bool canSeePlayer(const Player& player, const Maze& maze) const;
+
+    /**
+     * 使用A*算法计算从当前位置到目标的最短路径
+     *
+     * @param targetX 目标X坐标
+     * @param targetY 目标Y坐标
+     * @param maze 迷宫对象
+     * @return 路径点序列（格子坐标）
+     */
+    std::vector<sf::Vector2i> findPath(int targetX, int targetY, const Maze& maze) const;
 
 private:
     // === 位置和移动 ===
     float x, y;                    // 鬼的位置
+    float previousX, previousY;    // 上一个模拟步长的位置（渲染插值用）
     float dirX, dirY;              // 移动方向（单位向量）
 
     float patrolSpeed;             // 巡逻速度（比玩家慢）
@@ -69,13 +108,9 @@ private:
     float movePauseTimer;          // 走走停停计时器
     bool movePaused;               // 是否暂停移动
 
-    // === 声音感知系统 ===
-    static constexpr float PLAYER_SOUND_WALK = 30.0f;        // 走路基础声音强度
-    static constexpr float PLAYER_SOUND_RUN = 100.0f;        // 奔跑基础声音强度
-    static constexpr float PLAYER_SOUND_CROUCH = 10.0f;      // 蹲走基础声音强度
-    static constexpr float HEARING_THRESHOLD = 10.0f;        // 鬼的听觉阈值
-    static constexpr float AIR_ATTENUATION = 0.08f;          // 空气中每单位距离的衰减系数（降低以增加范围）
-    static constexpr float WALL_ATTENUATION_MULT = 0.3f;     // 穿墙衰减倍数（每堵墙 ×0.3）
+    // === 声音感知系统（声音来自 StimulusSystem，衰减规则见那里） ===
+    // 脚步声超过听觉阈值就能听到，双胞胎声音要足够响才会被吸引（见 SimulationParams）
+    StimulusSystem::Thresholds hearingThresholds;
 
     // === A*寻路 ===
     std::vector<sf::Vector2i> currentPath;  // 当前路径（格子坐标序列）
@@ -87,6 +122,20 @@ private:
     float noPathWarningTimer;               // 无路径警告冷却计时器（避免刷屏）
     static constexpr float NO_PATH_WARNING_INTERVAL = 3.0f;  // 每3秒最多输出一次警告
 
+    // === 最近一次感知结果（perceive 写入，think/act 读取） ===
+    struct Perception {
+        bool targetHidden;         // 目标在墙内且关闭打火机
+        bool canSee;               // 视线可见
+        bool canSeeLighter;        // 看到打火机光
+        bool heard;                // 是否听到了刺激
+        HeardStimulus sound;       // 听到的最强刺激
+        float targetX, targetY;    // 感知时玩家的位置
+    };
+    Perception perception;
+    float chaseTargetX, chaseTargetY;  // 追逐目标（玩家或被吸引的声源，由 think 决定）
+
+    Pcg32 rng;  // 这只鬼的随机数流（游荡方向）
+
     static constexpr float VISION_RANGE = 5.0f;
     static constexpr float PATROL_MOVE_DURATION = 1.6f;
     static constexpr float PATROL_PAUSE_DURATION = 0.8f;
@@ -95,19 +144,6 @@ private:
 
     // === 核心AI函数 ===
 
-    /**
-     * 计算鬼能听到的玩家声音强度
-     *
-     * 算法：
-     * 1. 使用Bresenham直线算法追踪声音路径
-     * 2. 计算距离衰减：S = S0 / (1 + distance * AIR_ATTENUATION)
-     * 3. 每穿过一堵墙：S *= WALL_ATTENUATION_MULT
-     *
-     * @return 声音强度（0-100）
-     */
-    float calculateSoundLevel(const Player& player, const Maze& maze) const;
-    bool canSeePlayer(const Player& player, const Maze& maze) const;
-
     /**
      * 检测玩家打火机光照（特殊视觉检测）
      *
@@ -119,20 +155,10 @@ private:
      */
     bool canSeeLighter(const Player& player, const Maze& maze) const;
 
-    /**
-     * 使用A*算法计算从当前位置到目标的最短路径
-     *
-     * @param targetX 目标X坐标
-     * @param targetY 目标Y坐标
-     * @param maze 迷宫对象
-     * @return 路径点序列（格子坐标）
-     */
-    std::vector<sf::Vector2i> findPath(int targetX, int targetY, const Maze& maze);
-
     /**
      * 追踪状态行为：沿着A*路径移动
      */
-    void updateChasing(float deltaTime, const Player& player, const Maze& maze);
+    void updateChasing(float deltaTime, float targetPosX, float targetPosY, const Maze& maze);
 
     /**
      * 巡逻状态行为：走走停停随机移动
@@ -146,6 +172,9 @@ private:
 
     void transitionTo(State newState);
 
+    // 感知的公共部分：听声音、记录玩家位置，玩家藏在墙里时返回false
+    bool beginPerception(const Player& player, const Maze& maze, const StimulusSystem& stimuli);
+
     /**
      * 移动鬼到新位置（带碰撞检测）
      */
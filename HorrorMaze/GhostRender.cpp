@@ -0,0 +1,98 @@
+#include "Ghost.h"
+#include "Logger.h"
+#include "SpriteRenderer.h"
+#include <SFML/Graphics.hpp>
+
+// Ghost 的绘制部分和共享纹理（只有游戏程序编译；模拟核心和无头程序不依赖图形模块）
+
+// 静态成员初始化
+sf::Texture Ghost::s_spriteTexture;
+bool Ghost::s_textureLoaded = false;
+
+const sf::Texture* Ghost::getSpriteTexture() {
+    return &s_spriteTexture;
+}
+
+/**
+ * 渲染鬼（俯视图）
+ */
+void Ghost::renderTopDown(sf::RenderWindow& window, float cellSize, float alpha) const {
+    float renderX = previousX + (x - previousX) * alpha;
+    float renderY = previousY + (y - previousY) * alpha;
+
+    // 绘制鬼的圆点
+    float radius = cellSize * 0.25f;
+    sf::CircleShape ghostCircle(radius);
+
+    // 根据状态选择颜色
+    switch (currentState) {
+        case State::Chasing:
+            ghostCircle.setFillColor(sf::Color::Red);  // 追逐：红色
+            break;
+        case State::Alert:
+            ghostCircle.setFillColor(sf::Color(200, 120, 0));  // 警戒：橙色
+            break;
+        case State::Patrol:
+        default:
+            ghostCircle.setFillColor(sf::Color(100, 100, 100));  // 巡逻：灰色
+            break;
+    }
+
+    ghostCircle.setOrigin({radius, radius});
+    ghostCircle.setPosition({renderX * cellSize, renderY * cellSize});
+
+    window.draw(ghostCircle);
+
+    // 绘制路径（调试用）
+    if ((currentState == State::Chasing || currentState == State::Alert) && !currentPath.empty()) {
+        for (size_t i = 0; i < currentPath.size(); i++) {
+            sf::RectangleShape pathDot({3, 3});
+            pathDot.setFillColor(sf::Color::Yellow);
+            pathDot.setPosition({
+                currentPath[i].x * cellSize + cellSize / 2 - 1.5f,
+                currentPath[i].y * cellSize + cellSize / 2 - 1.5f
+            });
+            window.draw(pathDot);
+        }
+    }
+}
+
+/**
+ * 加载鬼的sprite纹理（所有鬼共享）
+ */
+bool Ghost::loadSpriteTexture(const std::string& filename) {
+    if (s_textureLoaded) {
+        return true;  // 已经加载过了
+    }
+
+    if (s_spriteTexture.loadFromFile(filename)) {
+        s_textureLoaded = true;
+        LOG_INFO("Ghost sprite loaded: " << filename);
+        return true;
+    }
+
+    LOG_WARN("Failed to load ghost sprite: " << filename);
+    return false;
+}
+
+/**
+ * 渲染鬼（第一人称视角）：交给 SpriteRenderer 统一投影、深度测试和合批
+ *
+ * 鬼比双胞胎大一些（0.6倍墙高），向下偏移四分之一，看起来“站”在地面上；
+ * 打火机开启时亮度减半（让鬼更隐蔽）。
+ */
+void Ghost::addBillboard(SpriteRenderer& sprites, float alpha) const {
+    if (!s_textureLoaded) {
+        return;  // 没有加载纹理，不渲染
+    }
+
+    SpriteRenderer::Billboard billboard;
+    billboard.x = previousX + (x - previousX) * alpha;  // 位置在两个模拟状态之间插值
+    billboard.y = previousY + (y - previousY) * alpha;
+    billboard.texture = &s_spriteTexture;
+    billboard.scale = 0.6f;  // 减小sprite大小，避免近距离扭曲
+    billboard.drop = 0.25f;
+    billboard.dimWithLighter = true;
+    billboard.color = sf::Color::White;
+    sprites.add(billboard);
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include "WallBitmap.h"
+
+/**
+ * GridTrace：统一的格子直线遍历内核（Bresenham）
+ *
+ * 声音传播、视线、打火机光照、双胞胎触发、脚步声都需要
+ * "沿两格之间的直线数墙"，规则只在计数和提前退出上不同。
+ * 这里用访问策略（Visitor）模板把这些差异参数化：
+ *
+ *   CountWalls       - 数完整条线上的墙
+ *   StopAtFirstWall  - 碰到第一堵墙就停（视线检测）
+ *   StopAfterWalls   - 数到第K堵墙就停（穿透上限）
+ *
+ * 每个格子调用一次策略的 visit(isWall)，返回 false 表示停止遍历。
+ * visit 写成无分支的累加，热循环里只剩一个退出判断。
+ * 遍历结果从策略的 walls 字段读取。
+ *
+ * 用法：
+ *   int walls = GridTrace::trace<GridTrace::CountWalls>(bitmap, x0, y0, x1, y1).walls;
+ *   bool clear = GridTrace::trace<GridTrace::StopAtFirstWall>(bitmap, x0, y0, x1, y1).walls == 0;
+ */
+namespace GridTrace {
+
+    // 一条待检测的线段（格子坐标）
+    struct Segment {
+        int x0, y0;
+        int x1, y1;
+    };
+
+    // 是否把起点/终点格子本身算进去
+    enum class Endpoints {
+        Include,   // 起点和终点格子也参与检测
+        Exclude    // 忽略起点和终点格子（双胞胎触发检测用）
+    };
+
+    // === 访问策略 ===
+
+    struct CountWalls {
+        int walls = 0;
+        bool visit(bool wall) { walls += wall; return true; }
+    };
+
+    struct StopAtFirstWall {
+        int walls = 0;
+        bool visit(bool wall) { walls += wall; return !wall; }
+    };
+
+    struct StopAfterWalls {
+        explicit StopAfterWalls(int limit_ = 1) : limit(limit_) {}
+        int limit;
+        int walls = 0;
+        bool visit(bool wall) { walls += wall; return walls < limit; }
+    };
+
+    namespace detail {
+        /**
+         * Bresenham主循环
+         *
+         * Checked = false 时两个端点都在地图内，整条线都落在端点的包围盒里，
+         * 所以可以跳过逐格的边界检查，直接按行指针取位。
+         */
+        template <typename Visitor, Endpoints E, bool Checked>
+        inline void walk(const WallBitmap& walls, int x0, int y0, int x1, int y1, Visitor& visitor) {
+            int dxl = std::abs(x1 - x0);
+            int dyl = std::abs(y1 - y0);
+            int sx = (x0 < x1) ? 1 : -1;
+            int sy = (y0 < y1) ? 1 : -1;
+            int err = dxl - dyl;
+
+            int cx = x0;
+            int cy = y0;
+            const std::uint64_t* row = Checked ? nullptr : walls.row(cy);
+            const std::ptrdiff_t rowStep = static_cast<std::ptrdiff_t>(sy) * walls.getStride();
+
+            while (true) {
+                bool skip = (E == Endpoints::Exclude) &&
+                            ((cx == x0 && cy == y0) || (cx == x1 && cy == y1));
+                if (!skip) {
+                    bool wall = Checked ? walls.test(cx, cy)
+                                        : ((row[cx >> 6] >> (cx & 63)) & 1u) != 0;
+                    if (!visitor.visit(wall)) {
+                        return;
+                    }
+                }
+
+                if (cx == x1 && cy == y1) {
+                    return;
+                }
+
+                int e2 = 2 * err;
+                if (e2 > -dyl) {
+                    err -= dyl;
+                    cx += sx;
+                }
+                if (e2 < dxl) {
+                    err += dxl;
+                    cy += sy;
+                    if (!Checked) {
+                        row += rowStep;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * 沿 (x0,y0) → (x1,y1) 遍历格子，把遇到的墙交给访问策略
+     */
+    template <typename Visitor, Endpoints E = Endpoints::Include>
+    inline void traverse(const WallBitmap& walls, int x0, int y0, int x1, int y1, Visitor& visitor) {
+        if (walls.inBounds(x0, y0) && walls.inBounds(x1, y1)) {
+            detail::walk<Visitor, E, false>(walls, x0, y0, x1, y1, visitor);
+        } else {
+            detail::walk<Visitor, E, true>(walls, x0, y0, x1, y1, visitor);
+        }
+    }
+
+    /**
+     * 便捷版本：按值传入策略，返回遍历后的策略（从 .walls 读结果）
+     */
+    template <typename Visitor, Endpoints E = Endpoints::Include>
+    inline Visitor trace(const WallBitmap& walls, int x0, int y0, int x1, int y1,
+                         Visitor visitor = Visitor()) {
+        traverse<Visitor, E>(walls, x0, y0, x1, y1, visitor);
+        return visitor;
+    }
+
+    /**
+     * 批量版本：一次检测多条线段
+     *
+     * 每条线段使用 prototype 的一份拷贝，结果（墙数）写入 wallCounts[i]。
+     * 对 StopAtFirstWall，wallCounts[i] == 0 即表示视线畅通。
+     */
+    template <typename Visitor, Endpoints E = Endpoints::Include>
+    inline void traceBatch(const WallBitmap& walls, const Segment* segments, std::size_t count,
+                           int* wallCounts, const Visitor& prototype = Visitor()) {
+        for (std::size_t i = 0; i < count; i++) {
+            Visitor visitor = prototype;
+            const Segment& s = segments[i];
+            traverse<Visitor, E>(walls, s.x0, s.y0, s.x1, s.y1, visitor);
+            wallCounts[i] = visitor.walls;
+        }
+    }
+}
@@ -0,0 +1,262 @@
+#include "InputRecording.h"
+#include "Logger.h"
+#include <cstring>
+#include <iterator>
+
+namespace {
+    using namespace InputRecording;
+
+    const char MAGIC[4] = {'H', 'M', 'I', 'R'};
+
+    std::uint16_t packFlags(const InputFrame& frame) {
+        const PlayerInput& in = frame.input;
+        std::uint16_t flags = 0;
+        if (in.forward)         flags |= Forward;
+        if (in.backward)        flags |= Backward;
+        if (in.strafeLeft)      flags |= StrafeLeft;
+        if (in.strafeRight)     flags |= StrafeRight;
+        if (in.run)             flags |= Run;
+        if (in.crouch)          flags |= Crouch;
+        if (in.toggleLighter)   flags |= ToggleLighter;
+        if (in.toggleWallPhase) flags |= ToggleWallPhase;
+        if (frame.toggleView)   flags |= ToggleView;
+        if (frame.reset)        flags |= Reset;
+        if (in.turn != 0.0f)    flags |= HasTurn;
+        return flags;
+    }
+
+    InputFrame unpackFlags(std::uint16_t flags, float turn) {
+        InputFrame frame;
+        frame.input.forward = (flags & Forward) != 0;
+        frame.input.backward = (flags & Backward) != 0;
+        frame.input.strafeLeft = (flags & StrafeLeft) != 0;
+        frame.input.strafeRight = (flags & StrafeRight) != 0;
+        frame.input.run = (flags & Run) != 0;
+        frame.input.crouch = (flags & Crouch) != 0;
+        frame.input.toggleLighter = (flags & ToggleLighter) != 0;
+        frame.input.toggleWallPhase = (flags & ToggleWallPhase) != 0;
+        frame.input.turn = turn;
+        frame.toggleView = (flags & ToggleView) != 0;
+        frame.reset = (flags & Reset) != 0;
+        return frame;
+    }
+
+    // 按字节写整数/浮点（固定小端，和编译器、平台无关）
+    void writeBytes(std::ofstream& out, std::uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            out.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void writeFloat(std::ofstream& out, float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeBytes(out, bits, 4);
+    }
+
+    // LEB128 变长整数：小于128的重复次数只占1字节
+    void writeVarint(std::ofstream& out, std::uint32_t value) {
+        while (value >= 0x80) {
+            out.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.put(static_cast<char>(value));
+    }
+
+    /**
+     * 从内存缓冲区顺序读取
+     */
+    class ByteReader {
+    public:
+        explicit ByteReader(const std::vector<unsigned char>& data) : data(data), offset(0) {}
+
+        bool atEnd() const { return offset >= data.size(); }
+
+        bool readBytes(std::uint64_t& value, int bytes) {
+            if (data.size() - offset < static_cast<std::size_t>(bytes)) {
+                return false;
+            }
+            value = 0;
+            for (int i = 0; i < bytes; i++) {
+                value |= static_cast<std::uint64_t>(data[offset++]) << (8 * i);
+            }
+            return true;
+        }
+
+        bool readFloat(float& value) {
+            std::uint64_t bits;
+            if (!readBytes(bits, 4)) {
+                return false;
+            }
+            std::uint32_t bits32 = static_cast<std::uint32_t>(bits);
+            std::memcpy(&value, &bits32, sizeof(value));
+            return true;
+        }
+
+        bool readVarint(std::uint32_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 35; shift += 7) {
+                if (atEnd()) {
+                    return false;
+                }
+                unsigned char byte = data[offset++];
+                value |= static_cast<std::uint32_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        const std::vector<unsigned char>& data;
+        std::size_t offset;
+    };
+}
+
+// ==================== InputRecorder ====================
+
+InputRecorder::InputRecorder()
+    : pendingFlags(0)
+    , pendingTurn(0.0f)
+    , pendingCount(0)
+    , frameCount(0)
+{
+}
+
+InputRecorder::~InputRecorder() {
+    close();
+}
+
+bool InputRecorder::open(const std::string& filename, std::uint64_t seed, float timestep) {
+    close();
+
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("ERROR: Cannot create input recording: " << filename);
+        return false;
+    }
+
+    file.write(MAGIC, sizeof(MAGIC));
+    writeBytes(file, InputRecording::VERSION, 4);
+    writeBytes(file, seed, 8);
+    writeFloat(file, timestep);
+
+    path = filename;
+    pendingCount = 0;
+    frameCount = 0;
+    LOG_INFO("Recording input to: " << filename << " (seed " << seed << ")");
+    return true;
+}
+
+void InputRecorder::record(const InputFrame& frame) {
+    if (!file.is_open()) {
+        return;
+    }
+
+    std::uint16_t flags = packFlags(frame);
+    float turn = frame.input.turn;
+    frameCount++;
+
+    // 和上一条完全相同（包括转向量的每一位）时只累加重复次数
+    if (pendingCount > 0 && flags == pendingFlags &&
+        std::memcmp(&turn, &pendingTurn, sizeof(turn)) == 0) {
+        pendingCount++;
+        return;
+    }
+
+    writePending();
+    pendingFlags = flags;
+    pendingTurn = turn;
+    pendingCount = 1;
+}
+
+void InputRecorder::writePending() {
+    if (pendingCount == 0) {
+        return;
+    }
+    writeBytes(file, pendingFlags, 2);
+    writeVarint(file, pendingCount);
+    if (pendingFlags & InputRecording::HasTurn) {
+        writeFloat(file, pendingTurn);
+    }
+    pendingCount = 0;
+}
+
+void InputRecorder::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    writePending();
+    file.close();
+    LOG_INFO("Input recording saved: " << path << " (" << frameCount << " steps)");
+}
+
+// ==================== InputReplay ====================
+
+InputReplay::InputReplay()
+    : loaded(false)
+    , seed(0)
+    , timestep(0.0f)
+    , position(0)
+{
+}
+
+bool InputReplay::load(const std::string& filename) {
+    loaded = false;
+    frames.clear();
+    position = 0;
+
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ERROR("ERROR: Cannot open input recording: " << filename);
+        return false;
+    }
+    std::vector<unsigned char> data((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+
+    ByteReader reader(data);
+    std::uint64_t magic = 0;
+    std::uint64_t version = 0;
+    if (!reader.readBytes(magic, 4) || std::memcmp(&data[0], MAGIC, sizeof(MAGIC)) != 0 ||
+        !reader.readBytes(version, 4) || version != InputRecording::VERSION ||
+        !reader.readBytes(seed, 8) || !reader.readFloat(timestep)) {
+        LOG_ERROR("ERROR: Not a valid input recording: " << filename);
+        return false;
+    }
+
+    while (!reader.atEnd()) {
+        std::uint64_t flags = 0;
+        std::uint32_t count = 0;
+        float turn = 0.0f;
+        if (!reader.readBytes(flags, 2) || !reader.readVarint(count) ||
+            ((flags & InputRecording::HasTurn) && !reader.readFloat(turn))) {
+            LOG_ERROR("ERROR: Input recording is truncated: " << filename);
+            return false;
+        }
+        if (count > InputRecording::MAX_FRAMES - frames.size()) {
+            LOG_ERROR("ERROR: Input recording exceeds " << InputRecording::MAX_FRAMES << " steps: " << filename);
+            frames.clear();
+            return false;
+        }
+        frames.insert(frames.end(), count, unpackFlags(static_cast<std::uint16_t>(flags), turn));
+    }
+
+    loaded = true;
+    LOG_INFO("Input recording loaded: " << filename << " (" << frames.size()
+             << " steps, seed " << seed << ")");
+    return true;
+}
+
+const InputFrame& InputReplay::peek() const {
+    static const InputFrame empty;
+    return finished() ? empty : frames[position];
+}
+
+const InputFrame& InputReplay::next() {
+    const InputFrame& frame = peek();
+    if (!finished()) {
+        position++;
+    }
+    return frame;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Player.h"
+
+/**
+ * 一个模拟步长的完整输入
+ *
+ * 除了交给模拟的 PlayerInput，还记录两个只在 Game 里生效的动作：
+ * 本步之前是否重新开始了一局（菜单里按 Enter），以及是否按了 Tab 切换视角。
+ */
+struct InputFrame {
+    PlayerInput input;
+    bool reset = false;        // 本步之前调用 Simulation::reset()
+    bool toggleView = false;   // 本步内按下了 Tab
+};
+
+/**
+ * 输入录像文件格式（小端）
+ *
+ *   头部：'H' 'M' 'I' 'R' | u32 版本 | u64 主种子 | f32 模拟步长（秒）
+ *   之后每条记录：u16 标志位 | 变长整数 重复次数 | [f32 转向]（标志位含 HasTurn 时）
+ *
+ * 连续相同的输入只存一条记录加重复次数，站着不动或一直按住 W 的几秒钟只占几个字节；
+ * 一局5分钟（120Hz 共 36000 步）的录像通常只有几十KB。
+ */
+namespace InputRecording {
+    constexpr std::uint32_t VERSION = 1;
+
+    // 一份录像最多的步数（120Hz 下 8 小时）；超过视为文件损坏，避免按错误的重复次数分配内存
+    constexpr std::uint64_t MAX_FRAMES = 120ULL * 60 * 60 * 8;
+
+    enum Flag : std::uint16_t {
+        Forward         = 1 << 0,
+        Backward        = 1 << 1,
+        StrafeLeft      = 1 << 2,
+        StrafeRight     = 1 << 3,
+        Run             = 1 << 4,
+        Crouch          = 1 << 5,
+        ToggleLighter   = 1 << 6,
+        ToggleWallPhase = 1 << 7,
+        ToggleView      = 1 << 8,
+        Reset           = 1 << 9,
+        HasTurn         = 1 << 10
+    };
+}
+
+/**
+ * InputRecorder：把每个模拟步长的输入写入录像文件
+ *
+ * 相同的输入先在内存里累计重复次数，变化时才写出一条记录。
+ */
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(const std::string& filename, std::uint64_t seed, float timestep);
+    void record(const InputFrame& frame);
+    void close();
+
+    bool isOpen() const { return file.is_open(); }
+    std::uint64_t getFrameCount() const { return frameCount; }
+
+private:
+    std::ofstream file;
+    std::string path;
+    std::uint16_t pendingFlags;
+    float pendingTurn;
+    std::uint32_t pendingCount;   // 待写出记录的重复次数（0 表示没有待写出的记录）
+    std::uint64_t frameCount;
+
+    void writePending();
+};
+
+/**
+ * InputReplay：读取录像文件，按步长依次给出输入
+ */
+class InputReplay {
+public:
+    InputReplay();
+
+    // 整个文件一次性读入内存（回放时不再访问磁盘）
+    bool load(const std::string& filename);
+
+    bool isLoaded() const { return loaded; }
+    std::uint64_t getSeed() const { return seed; }
+    float getTimestep() const { return timestep; }
+    std::size_t getFrameCount() const { return frames.size(); }
+    std::size_t getPosition() const { return position; }
+    bool finished() const { return position >= frames.size(); }
+
+    // 取出下一步的输入；回放结束后返回空输入
+    const InputFrame& next();
+
+private:
+    bool loaded;
+    std::uint64_t seed;
+    float timestep;
+    std::vector<InputFrame> frames;
+    std::size_t position;
+
+    // 下一步的输入（不前进）
+    const InputFrame& peek() const;
+};
@@ -0,0 +1,294 @@
+#include "Logger.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// 参数类型标签
+namespace {
+    const char TAG_STRING = 's';
+    const char TAG_CHAR = 'c';
+    const char TAG_BOOL = 'b';
+    const char TAG_SIGNED = 'i';
+    const char TAG_UNSIGNED = 'u';
+    const char TAG_FLOAT = 'f';
+
+    const std::size_t MAX_STRING = 255;   // 单个字符串参数最多保留的字节数（长度用1字节存）
+}
+
+// ============================================================
+// LogRecordBuilder
+// ============================================================
+
+LogRecordBuilder::LogRecordBuilder(LogLevel level) {
+    record.level = level;
+    record.size = 0;
+    record.truncated = false;
+}
+
+LogRecordBuilder& LogRecordBuilder::operator<<(const char* text) {
+    if (text == nullptr) {
+        text = "(null)";
+    }
+    std::size_t length = std::strlen(text);
+
+    // 放不下时尽量截断保留前半部分
+    std::size_t room = LogRecord::PAYLOAD_SIZE - record.size;
+    if (room < 3) {
+        record.truncated = true;
+        return *this;
+    }
+    if (length > MAX_STRING) {
+        length = MAX_STRING;
+        record.truncated = true;
+    }
+    if (length > room - 2) {
+        length = room - 2;
+        record.truncated = true;
+    }
+
+    char* out = record.payload + record.size;
+    out[0] = TAG_STRING;
+    out[1] = static_cast<char>(static_cast<unsigned char>(length));
+    std::memcpy(out + 2, text, length);
+    record.size = static_cast<std::uint16_t>(record.size + 2 + length);
+    return *this;
+}
+
+LogRecordBuilder& LogRecordBuilder::operator<<(const std::string& text) {
+    return *this << text.c_str();
+}
+
+LogRecordBuilder& LogRecordBuilder::operator<<(char value) {
+    put(TAG_CHAR, &value, sizeof(value));
+    return *this;
+}
+
+LogRecordBuilder& LogRecordBuilder::operator<<(bool value) {
+    char b = value ? 1 : 0;
+    put(TAG_BOOL, &b, sizeof(b));
+    return *this;
+}
+
+LogRecordBuilder& LogRecordBuilder::putSigned(long long value) {
+    std::int64_t v = value;
+    put(TAG_SIGNED, &v, sizeof(v));
+    return *this;
+}
+
+LogRecordBuilder& LogRecordBuilder::putUnsigned(unsigned long long value) {
+    std::uint64_t v = value;
+    put(TAG_UNSIGNED, &v, sizeof(v));
+    return *this;
+}
+
+LogRecordBuilder& LogRecordBuilder::putFloat(double value) {
+    put(TAG_FLOAT, &value, sizeof(value));
+    return *this;
+}
+
+bool LogRecordBuilder::put(char tag, const void* data, std::size_t bytes) {
+    if (record.size + 1 + bytes > LogRecord::PAYLOAD_SIZE) {
+        record.truncated = true;
+        return false;
+    }
+    char* out = record.payload + record.size;
+    out[0] = tag;
+    std::memcpy(out + 1, data, bytes);
+    record.size = static_cast<std::uint16_t>(record.size + 1 + bytes);
+    return true;
+}
+
+void LogRecordBuilder::submit() {
+    Logger::instance().enqueue(record);
+}
+
+// ============================================================
+// Logger
+// ============================================================
+
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : slots(CAPACITY)
+    , enqueuePos(0)
+    , dequeuePos(0)
+    , writtenPos(0)
+    , dropped(0)
+    , running(true)
+    , minimumLevel(static_cast<int>(LogLevel::Debug))
+{
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Logger::CAPACITY must be a power of two");
+    for (std::size_t i = 0; i < CAPACITY; i++) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    worker = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger() {
+    running.store(false, std::memory_order_release);
+    if (worker.joinable()) {
+        worker.join();  // 后台线程退出前会写完队列里剩下的记录
+    }
+}
+
+/**
+ * 入队（任意线程，无锁）
+ *
+ * 槽位序号 == 当前位置 表示空闲可写；抢到位置后写入记录，
+ * 再把序号设为 位置+1 通知消费者可读。
+ */
+bool Logger::enqueue(const LogRecord& record) {
+    const std::size_t mask = CAPACITY - 1;
+    std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+
+    while (true) {
+        slot = &slots[pos & mask];
+        std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // 队列满：丢弃
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->record = record;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * 出队（只在后台线程调用）
+ */
+bool Logger::dequeue(LogRecord& out) {
+    const std::size_t mask = CAPACITY - 1;
+    Slot& slot = slots[dequeuePos & mask];
+    std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+    if (seq != dequeuePos + 1) {
+        return false;  // 空，或者生产者还没写完
+    }
+
+    out = slot.record;
+    slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+    dequeuePos++;
+    return true;
+}
+
+void Logger::flush() {
+    std::size_t target = enqueuePos.load(std::memory_order_acquire);
+    while (writtenPos.load(std::memory_order_acquire) < target &&
+           running.load(std::memory_order_acquire)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+/**
+ * 后台线程：取记录 → 格式化 → 写出；队列空时 flush 并短暂休眠
+ */
+void Logger::run() {
+    LogRecord record;
+    std::uint64_t reportedDropped = 0;
+
+    while (true) {
+        bool wroteAny = false;
+        while (dequeue(record)) {
+            write(record);
+            writtenPos.fetch_add(1, std::memory_order_release);
+            wroteAny = true;
+        }
+
+        std::uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+        if (droppedNow != reportedDropped) {
+            std::cerr << "[log] " << (droppedNow - reportedDropped)
+                      << " messages dropped (buffer full)" << '\n';
+            reportedDropped = droppedNow;
+        }
+
+        if (wroteAny) {
+            std::cout.flush();
+            continue;
+        }
+
+        // 退出时队列里可能还有正在写入的记录，等它们发布后再结束
+        if (!running.load(std::memory_order_acquire) &&
+            writtenPos.load(std::memory_order_acquire) == enqueuePos.load(std::memory_order_acquire)) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::cout.flush();
+}
+
+/**
+ * 把一条二进制记录格式化成一行文本
+ */
+void Logger::write(const LogRecord& record) {
+    std::ostringstream line;
+    const char* p = record.payload;
+    const char* end = record.payload + record.size;
+
+    while (p < end) {
+        char tag = *p++;
+        switch (tag) {
+            case TAG_STRING: {
+                std::size_t length = static_cast<unsigned char>(*p++);
+                line.write(p, static_cast<std::streamsize>(length));
+                p += length;
+                break;
+            }
+            case TAG_CHAR:
+                line << *p;
+                p += 1;
+                break;
+            case TAG_BOOL:
+                line << (*p != 0);
+                p += 1;
+                break;
+            case TAG_SIGNED: {
+                std::int64_t v;
+                std::memcpy(&v, p, sizeof(v));
+                line << v;
+                p += sizeof(v);
+                break;
+            }
+            case TAG_UNSIGNED: {
+                std::uint64_t v;
+                std::memcpy(&v, p, sizeof(v));
+                line << v;
+                p += sizeof(v);
+                break;
+            }
+            case TAG_FLOAT: {
+                double v;
+                std::memcpy(&v, p, sizeof(v));
+                line << v;
+                p += sizeof(v);
+                break;
+            }
+            default:
+                p = end;  // 数据损坏，丢弃剩余部分
+                break;
+        }
+    }
+    if (record.truncated) {
+        line << " [...]";
+    }
+    line << '\n';
+
+    if (record.level >= LogLevel::Warn) {
+        std::cerr << line.str();
+    } else {
+        std::cout << line.str();
+    }
+}
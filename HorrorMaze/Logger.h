@@ -0,0 +1,152 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * 日志级别
+ */
+enum class LogLevel {
+    Debug = 0,   // 调试信息（AI状态切换等高频日志）
+    Info = 1,    // 一般信息（加载、生成、游戏事件）
+    Warn = 2,    // 警告（资源缺失但能继续运行）
+    Error = 3    // 错误
+};
+
+/**
+ * 编译期日志级别过滤：低于此级别的日志语句整个被编译器删掉
+ * 默认 Debug 版本输出全部，Release 版本从 Info 开始；可以用 /D 或 -D 覆盖
+ */
+#ifndef HORRORMAZE_LOG_LEVEL
+#ifdef NDEBUG
+#define HORRORMAZE_LOG_LEVEL 1
+#else
+#define HORRORMAZE_LOG_LEVEL 0
+#endif
+#endif
+
+/**
+ * 一条二进制日志记录（固定大小，直接放进环形缓冲区的槽位）
+ *
+ * 参数不在调用线程格式化，而是按"类型标签 + 原始字节"依次打包进 payload，
+ * 由后台线程统一格式化成文本。字符串会被拷贝（超长时截断）。
+ */
+struct LogRecord {
+    static constexpr std::size_t PAYLOAD_SIZE = 240;
+
+    LogLevel level;
+    std::uint16_t size;        // payload 已用字节数
+    bool truncated;            // 参数太多被截断
+    char payload[PAYLOAD_SIZE];
+};
+
+/**
+ * LogRecordBuilder：在调用线程上打包一条记录（流式写法）
+ *
+ * 一般不直接使用，而是通过 LOG_INFO("x = " << x) 这类宏。
+ */
+class LogRecordBuilder {
+public:
+    explicit LogRecordBuilder(LogLevel level);
+
+    LogRecordBuilder& operator<<(const char* text);
+    LogRecordBuilder& operator<<(const std::string& text);
+    LogRecordBuilder& operator<<(char value);
+    LogRecordBuilder& operator<<(bool value);
+    LogRecordBuilder& operator<<(int value) { return putSigned(value); }
+    LogRecordBuilder& operator<<(long value) { return putSigned(value); }
+    LogRecordBuilder& operator<<(long long value) { return putSigned(value); }
+    LogRecordBuilder& operator<<(unsigned value) { return putUnsigned(value); }
+    LogRecordBuilder& operator<<(unsigned long value) { return putUnsigned(value); }
+    LogRecordBuilder& operator<<(unsigned long long value) { return putUnsigned(value); }
+    LogRecordBuilder& operator<<(float value) { return putFloat(value); }
+    LogRecordBuilder& operator<<(double value) { return putFloat(value); }
+
+    // 投递到日志队列（队列满时丢弃并计数）
+    void submit();
+
+private:
+    LogRecord record;
+
+    LogRecordBuilder& putSigned(long long value);
+    LogRecordBuilder& putUnsigned(unsigned long long value);
+    LogRecordBuilder& putFloat(double value);
+    bool put(char tag, const void* data, std::size_t bytes);
+};
+
+/**
+ * Logger：异步日志（无锁多生产者环形缓冲区 + 后台写出线程）
+ *
+ * - 任意线程调用 LOG_xxx 只做一次打包和一次无锁入队，不做格式化和I/O
+ * - 后台线程取出记录、格式化、写到 stdout（Warn/Error 写到 stderr），
+ *   队列空闲时才 flush
+ * - 队列满时新记录被丢弃，丢弃数量会在后台线程补一行提示
+ *
+ * 队列是 Vyukov 有界队列：每个槽位带一个序号，生产者用 CAS 抢占写入位置，
+ * 写完后发布序号；消费者只有一个，按序号判断槽位是否可读。
+ */
+class Logger {
+public:
+    static constexpr std::size_t CAPACITY = 4096;   // 槽位数（必须是2的幂）
+
+    static Logger& instance();
+
+    // 入队一条记录；队列满返回false
+    bool enqueue(const LogRecord& record);
+
+    // 阻塞直到队列里已有的记录全部写出（退出前、崩溃前调用）
+    void flush();
+
+    std::uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    // 运行期级别过滤（在编译期过滤之上；批量模拟时只保留警告和错误）
+    void setMinimumLevel(LogLevel level) { minimumLevel.store(static_cast<int>(level), std::memory_order_relaxed); }
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minimumLevel.load(std::memory_order_relaxed);
+    }
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+private:
+    Logger();
+    ~Logger();
+
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        LogRecord record;
+    };
+
+    std::vector<Slot> slots;
+    alignas(64) std::atomic<std::size_t> enqueuePos;
+    alignas(64) std::size_t dequeuePos;              // 只有后台线程访问
+    std::atomic<std::size_t> writtenPos;             // 已写出的记录数（flush 用）
+    std::atomic<std::uint64_t> dropped;
+    std::atomic<bool> running;
+    std::atomic<int> minimumLevel;
+    std::thread worker;
+
+    bool dequeue(LogRecord& out);
+    void run();
+    static void write(const LogRecord& record);
+};
+
+#define HORRORMAZE_LOG(level, expr)                                               \
+    do {                                                                          \
+        if constexpr (static_cast<int>(level) >= HORRORMAZE_LOG_LEVEL) {          \
+            if (Logger::instance().isEnabled(level)) {                            \
+                LogRecordBuilder horrorMazeLogRecord_(level);                     \
+                horrorMazeLogRecord_ << expr;                                     \
+                horrorMazeLogRecord_.submit();                                    \
+            }                                                                     \
+        }                                                                         \
+    } while (0)
+
+// 用法：LOG_INFO("Ghost spawned at: (" << x << ", " << y << ")");  —— 不需要 std::endl
+#define LOG_DEBUG(expr) HORRORMAZE_LOG(LogLevel::Debug, expr)
+#define LOG_INFO(expr)  HORRORMAZE_LOG(LogLevel::Info, expr)
+#define LOG_WARN(expr)  HORRORMAZE_LOG(LogLevel::Warn, expr)
+#define LOG_ERROR(expr) HORRORMAZE_LOG(LogLevel::Error, expr)
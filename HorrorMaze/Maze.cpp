@@ -1,6 +1,7 @@
 #include "Maze.h"
+#include "GridTrace.h"
+#include "Logger.h"
 #include <fstream>
-#include <iostream>
 
 Maze::Maze()
     : width(0)
@@ -21,14 +22,14 @@ bool Maze::loadFromFile(const std::string& filename) {
     std::ifstream file(filename);
 
     if (!file.is_open()) {
-        std::cerr << "ERROR: Cannot open map file: " << filename << std::endl;
+        LOG_ERROR("ERROR: Cannot open map file: " << filename);
         return false;
     }
 
     // 读取宽度和高度
     file >> width >> height;
 
-    std::cout << "Map size: " << width << " x " << height << std::endl;
+    LOG_INFO("Map size: " << width << " x " << height);
 
     // 初始化地图（创建二维数组）
     map.resize(height);
@@ -44,11 +45,20 @@ bool Maze::loadFromFile(const std::string& filename) {
             // 记录特殊位置
             if (map[y][x] == 2) {  // 出口
                 exitPos = sf::Vector2i(x, y);
-                std::cout << "Exit found at: (" << x << ", " << y << ")" << std::endl;
+                LOG_INFO("Exit found at: (" << x << ", " << y << ")");
             }
         }
     }
 
+    // 构建墙体位图
+    wallBits.resize(width, height);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            wallBits.set(x, y, map[y][x] == 1);
+        }
+    }
+    visibility.build(wallBits);
+
     // 寻找玩家起点（第一个空地）
     bool foundStart = false;
     for (int y = 0; y < height && !foundStart; y++) {
@@ -56,13 +66,13 @@ bool Maze::loadFromFile(const std::string& filename) {
             if (map[y][x] == 0) {  // 空地
                 playerStart = sf::Vector2i(x, y);
                 foundStart = true;
-                std::cout << "Player start: (" << x << ", " << y << ")" << std::endl;
+                LOG_INFO("Player start: (" << x << ", " << y << ")");
             }
         }
     }
 
     file.close();
-    std::cout << "Map loaded successfully!" << std::endl;
+    LOG_INFO("Map loaded successfully!");
     return true;
 }
 
@@ -70,13 +80,20 @@ bool Maze::loadFromFile(const std::string& filename) {
  * 检查某个位置是否是墙
  */
 bool Maze::isWall(int x, int y) const {
-    // 边界外视为墙
-    if (x < 0 || x >= width || y < 0 || y >= height) {
-        return true;
-    }
+    // 边界外视为墙，1 = 墙（位图里已经按这个规则打包）
+    return wallBits.test(x, y);
+}
 
-    // 1 = 墙
-    return map[y][x] == 1;
+/**
+ * 两格之间视线是否畅通（含两端）
+ *
+ * 半径内直接查预计算可见集（一次位测试），超出半径时退回逐格遍历
+ */
+bool Maze::hasLineOfSight(int x0, int y0, int x1, int y1) const {
+    if (VisibilityCache::inWindow(x0, y0, x1, y1)) {
+        return visibility.isVisible(x0, y0, x1, y1);
+    }
+    return GridTrace::trace<GridTrace::StopAtFirstWall>(wallBits, x0, y0, x1, y1).walls == 0;
 }
 
 /**
@@ -94,59 +111,12 @@ int Maze::getCell(int x, int y) const {
  */
 void Maze::setCell(int x, int y, int value) {
     if (x >= 0 && x < width && y >= 0 && y < height) {
+        bool wasWall = (map[y][x] == 1);
         map[y][x] = value;
-    }
-}
-
-/**
- * 渲染迷宫（俯视图）
- *
- * cellSize: 每个格子的像素大小
- */
-void Maze::renderTopDown(sf::RenderWindow& window, float cellSize) const {
-    sf::RectangleShape cell(sf::Vector2f(cellSize, cellSize));
-
-    for (int y = 0; y < height; y++) {
-        for (int x = 0; x < width; x++) {
-            cell.setPosition({x * cellSize, y * cellSize});
-
-            // 根据格子类型设置颜色
-            switch (map[y][x]) {
-                case 0:  // 空地
-                    cell.setFillColor(sf::Color(50, 50, 50));
-                    break;
-
-                case 1:  // 墙
-                    cell.setFillColor(sf::Color(200, 200, 200));
-                    break;
-
-                case 2:  // 出口
-                    cell.setFillColor(sf::Color::Green);
-                    break;
-
-                case 3:  // 双胞胎
-                    cell.setFillColor(sf::Color::Magenta);
-                    break;
-
-                case 4:  // 雪墙
-                    cell.setFillColor(sf::Color::Cyan);
-                    break;
-
-                case 5:  // 打火机
-                    cell.setFillColor(sf::Color::Yellow);
-                    break;
-
-                default:
-                    cell.setFillColor(sf::Color::Black);
-            }
-
-            window.draw(cell);
-
-            // 绘制网格线（方便看清格子）
-            cell.setFillColor(sf::Color::Transparent);
-            cell.setOutlineColor(sf::Color(80, 80, 80));
-            cell.setOutlineThickness(1.0f);
-            window.draw(cell);
+        if (wasWall != (value == 1)) {
+            // 墙体变化：同步位图并局部修补可见集
+            wallBits.set(x, y, value == 1);
+            visibility.updateCell(wallBits, x, y);
         }
     }
 }
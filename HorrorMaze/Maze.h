@@ -1,7 +1,11 @@
 #pragma once
 #include <vector>
 #include <string>
-#include <SFML/Graphics.hpp>
+#include <SFML/System/Vector2.hpp>
+#include "WallBitmap.h"
+#include "VisibilityCache.h"
+
+namespace sf { class RenderWindow; }
 
 /**
  * Maze类：管理迷宫地图数据和渲染
@@ -32,7 +36,18 @@ public:
     sf::Vector2i getPlayerStart() const { return playerStart; }
     sf::Vector2i getExitPos() const { return exitPos; }
 
-    // 渲染迷宫（俯视图）
+    // 打包的墙体位图（直线遍历、碰撞等热点查询使用）
+    const WallBitmap& getWallBitmap() const { return wallBits; }
+
+    // 两格之间视线是否畅通（含两端）：VisibilityCache::RADIUS 内查预计算可见集，否则逐格遍历
+    bool hasLineOfSight(int x0, int y0, int x1, int y1) const;
+
+    // 同一行/列的两格之间（不含两端）是否没有墙
+    bool isAxisLineClear(int x0, int y0, int x1, int y1) const {
+        return visibility.isAxisClear(x0, y0, x1, y1);
+    }
+
+    // 渲染迷宫（俯视图，定义在 MazeRender.cpp）
     void renderTopDown(sf::RenderWindow& window, float cellSize) const;
 
 private:
@@ -41,4 +56,6 @@ private:
     std::vector<std::vector<int>> map;      // 地图数据（二维数组）
     sf::Vector2i playerStart;               // 玩家起点
     sf::Vector2i exitPos;                   // 出口位置
+    WallBitmap wallBits;                    // 墙体位图（和map同步维护）
+    VisibilityCache visibility;             // 预计算可见集（和wallBits同步维护）
 };
@@ -0,0 +1,57 @@
+#include "Maze.h"
+#include <SFML/Graphics.hpp>
+
+// Maze 的绘制部分（只有游戏程序编译；模拟核心和无头程序不依赖图形模块）
+
+/**
+ * 渲染迷宫（俯视图）
+ *
+ * cellSize: 每个格子的像素大小
+ */
+void Maze::renderTopDown(sf::RenderWindow& window, float cellSize) const {
+    sf::RectangleShape cell(sf::Vector2f(cellSize, cellSize));
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            cell.setPosition({x * cellSize, y * cellSize});
+
+            // 根据格子类型设置颜色
+            switch (map[y][x]) {
+                case 0:  // 空地
+                    cell.setFillColor(sf::Color(50, 50, 50));
+                    break;
+
+                case 1:  // 墙
+                    cell.setFillColor(sf::Color(200, 200, 200));
+                    break;
+
+                case 2:  // 出口
+                    cell.setFillColor(sf::Color::Green);
+                    break;
+
+                case 3:  // 双胞胎
+                    cell.setFillColor(sf::Color::Magenta);
+                    break;
+
+                case 4:  // 雪墙
+                    cell.setFillColor(sf::Color::Cyan);
+                    break;
+
+                case 5:  // 打火机
+                    cell.setFillColor(sf::Color::Yellow);
+                    break;
+
+                default:
+                    cell.setFillColor(sf::Color::Black);
+            }
+
+            window.draw(cell);
+
+            // 绘制网格线（方便看清格子）
+            cell.setFillColor(sf::Color::Transparent);
+            cell.setOutlineColor(sf::Color(80, 80, 80));
+            cell.setOutlineThickness(1.0f);
+            window.draw(cell);
+        }
+    }
+}
@@ -0,0 +1,166 @@
+#include "Palette.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+    // 打包颜色的第 channel 个字节（四个字节一视同仁，和字节序无关）
+    inline int channelOf(std::uint32_t color, int channel) {
+        return static_cast<int>((color >> (channel * 8)) & 0xFFu);
+    }
+
+    struct Entry {
+        std::uint32_t color;
+        std::uint32_t count;   // 出现次数（加权平均和加权中位数用）
+    };
+
+    // 中位切分的一个盒子：entries[begin, end)
+    struct Box {
+        std::size_t begin, end;
+        int channel;           // 跨度最大的通道
+        int range;             // 这个通道的跨度（0 = 只剩一种颜色，不能再切）
+    };
+
+    Box makeBox(const std::vector<Entry>& entries, std::size_t begin, std::size_t end) {
+        Box box{begin, end, 0, 0};
+        for (int channel = 0; channel < 4; channel++) {
+            int lo = 255, hi = 0;
+            for (std::size_t i = begin; i < end; i++) {
+                int value = channelOf(entries[i].color, channel);
+                lo = std::min(lo, value);
+                hi = std::max(hi, value);
+            }
+            if (hi - lo > box.range) {
+                box.range = hi - lo;
+                box.channel = channel;
+            }
+        }
+        return box;
+    }
+}
+
+/**
+ * 中位切分：反复把跨度最大的盒子沿这个通道按出现次数对半切开，
+ * 直到有 256 个盒子；每个盒子的加权平均色是一种调色板颜色。
+ */
+void Palette::build(const std::vector<const PackedTexture*>& textures) {
+    std::unordered_map<std::uint32_t, std::uint32_t> histogram;
+    for (const PackedTexture* texture : textures) {
+        for (std::uint32_t texel : texture->texels) {
+            histogram[texel]++;
+        }
+    }
+
+    // 按颜色排序，结果和哈希表的遍历顺序无关
+    std::vector<Entry> entries;
+    entries.reserve(histogram.size());
+    for (const auto& item : histogram) {
+        entries.push_back({item.first, item.second});
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.color < b.color; });
+
+    colors.clear();
+    if (entries.size() <= static_cast<std::size_t>(SIZE)) {
+        for (const Entry& entry : entries) {
+            colors.push_back(entry.color);
+        }
+    } else {
+        std::vector<Box> boxes = {makeBox(entries, 0, entries.size())};
+        while (boxes.size() < static_cast<std::size_t>(SIZE)) {
+            auto widest = std::max_element(boxes.begin(), boxes.end(),
+                                           [](const Box& a, const Box& b) { return a.range < b.range; });
+            if (widest->range == 0) {
+                break;
+            }
+            Box box = *widest;
+            std::sort(entries.begin() + box.begin, entries.begin() + box.end, [&](const Entry& a, const Entry& b) {
+                return channelOf(a.color, box.channel) < channelOf(b.color, box.channel);
+            });
+
+            // 加权中位数（两边都至少留一种颜色）
+            std::uint64_t total = 0;
+            for (std::size_t i = box.begin; i < box.end; i++) {
+                total += entries[i].count;
+            }
+            std::uint64_t accumulated = 0;
+            std::size_t split = box.begin + 1;
+            for (std::size_t i = box.begin; i + 1 < box.end; i++) {
+                accumulated += entries[i].count;
+                split = i + 1;
+                if (accumulated * 2 >= total) {
+                    break;
+                }
+            }
+
+            *widest = makeBox(entries, box.begin, split);
+            boxes.push_back(makeBox(entries, split, box.end));
+        }
+
+        for (const Box& box : boxes) {
+            std::uint64_t sum[4] = {0, 0, 0, 0};
+            std::uint64_t total = 0;
+            for (std::size_t i = box.begin; i < box.end; i++) {
+                for (int channel = 0; channel < 4; channel++) {
+                    sum[channel] += static_cast<std::uint64_t>(channelOf(entries[i].color, channel)) * entries[i].count;
+                }
+                total += entries[i].count;
+            }
+            std::uint32_t color = 0;
+            for (int channel = 0; channel < 4; channel++) {
+                color |= static_cast<std::uint32_t>((sum[channel] + total / 2) / total) << (channel * 8);
+            }
+            colors.push_back(color);
+        }
+    }
+
+    // 内存里第4个字节是 alpha（像素按 R、G、B、A 字节顺序存放）
+    opaque = true;
+    for (std::uint32_t color : colors) {
+        std::uint8_t bytes[4];
+        std::memcpy(bytes, &color, sizeof(bytes));
+        opaque = opaque && bytes[3] == 255;
+    }
+}
+
+IndexedTexture Palette::convert(const PackedTexture& texture) const {
+    IndexedTexture indexed;
+    indexed.width = texture.width;
+    indexed.height = texture.height;
+    indexed.indices.assign(texture.texels.size() + IndexedTexture::PADDING, 0);
+
+    // 同一种颜色只找一次最近的调色板颜色
+    std::unordered_map<std::uint32_t, std::uint8_t> nearest;
+    for (std::size_t i = 0; i < texture.texels.size(); i++) {
+        std::uint32_t texel = texture.texels[i];
+        auto found = nearest.find(texel);
+        if (found == nearest.end()) {
+            found = nearest.emplace(texel, static_cast<std::uint8_t>(findNearest(texel))).first;
+        }
+        indexed.indices[i] = found->second;
+    }
+    return indexed;
+}
+
+int Palette::findNearest(std::uint32_t texel) const {
+    int best = 0;
+    int bestDistance = -1;
+    for (int i = 0; i < size(); i++) {
+        int distance = 0;
+        for (int channel = 0; channel < 4; channel++) {
+            int delta = channelOf(texel, channel) - channelOf(colors[i], channel);
+            distance += delta * delta;
+        }
+        if (bestDistance < 0 || distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
+
+void Palette::buildColormap(std::uint32_t light, std::uint32_t* out) const {
+    for (int i = 0; i < SIZE; i++) {
+        out[i] = (i < size()) ? modulate(colors[i], light) : 0;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * 打包好的真彩色纹理（像素格式和 Framebuffer 相同，按行存放）
+ */
+struct PackedTexture {
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint32_t> texels;
+};
+
+/**
+ * 8 位调色板纹理：每个纹素是调色板下标（按行存放）
+ *
+ * indices 末尾多留 3 个字节：AVX2 按 32 位 gather 字节下标时，最后一个纹素不会读越界。
+ */
+struct IndexedTexture {
+    static constexpr int PADDING = 3;
+
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint8_t> indices;
+};
+
+/**
+ * Palette：软件渲染共用的 256 色调色板和光照颜色表（colormap）
+ *
+ * 和经典光线投射游戏一样，纹理加载时转成调色板下标，
+ * 每种光照事先算好一张 256 项的颜色表：表[i] = 调色板第 i 种颜色 × 光照颜色。
+ * 着色一个像素只是 colormap[纹素下标] 一次查表，没有乘法和分支；
+ * 打火机、黑暗、闪灵只是换一组表。
+ *
+ * 调色板由所有纹理的纹素一起做中位切分得到（不超过 256 种颜色时无损）。
+ * 颜色表的乘法和墙的光栅化相同：每个通道 texel * light / 255（整数除法）。
+ */
+class Palette {
+public:
+    static constexpr int SIZE = 256;
+
+    // 由这几张纹理的全部纹素选出调色板
+    void build(const std::vector<const PackedTexture*>& textures);
+
+    // 每个纹素换成最接近的调色板颜色
+    IndexedTexture convert(const PackedTexture& texture) const;
+
+    int size() const { return static_cast<int>(colors.size()); }
+
+    // 所有颜色都不透明（墙的光栅化可以不做混合）
+    bool isOpaque() const { return opaque; }
+
+    // 一张颜色表（out 有 SIZE 项；调色板不满 256 种颜色时其余项为 0）
+    void buildColormap(std::uint32_t light, std::uint32_t* out) const;
+
+    /**
+     * 纹素 × 光照（每个通道 texel * light / 255；
+     * 除以255写成 (x + 1 + (x >> 8)) >> 8，在 x <= 255 × 255 时和整数除法完全相同）
+     */
+    static std::uint32_t modulateChannel(std::uint32_t texel, std::uint32_t light, int shift) {
+        std::uint32_t product = ((texel >> shift) & 0xFFu) * ((light >> shift) & 0xFFu);
+        return ((product + 1 + (product >> 8)) >> 8) << shift;
+    }
+
+    static std::uint32_t modulate(std::uint32_t texel, std::uint32_t light) {
+        return modulateChannel(texel, light, 0) | modulateChannel(texel, light, 8) |
+               modulateChannel(texel, light, 16) | modulateChannel(texel, light, 24);
+    }
+
+private:
+    std::vector<std::uint32_t> colors;
+    bool opaque = true;
+
+    int findNearest(std::uint32_t texel) const;
+};
@@ -0,0 +1,54 @@
+#include "PerceptionBatch.h"
+#include "GridTrace.h"
+
+namespace {
+
+    int countWallsScalar(const WallBitmap& walls, int sourceX, int sourceY,
+                         int targetX, int targetY, int wallLimit) {
+        if (wallLimit == PerceptionBatch::NO_WALL_LIMIT) {
+            return GridTrace::trace<GridTrace::CountWalls>(walls, sourceX, sourceY, targetX, targetY).walls;
+        }
+        return GridTrace::trace(walls, sourceX, sourceY, targetX, targetY,
+                                GridTrace::StopAfterWalls(wallLimit)).walls;
+    }
+}
+
+namespace PerceptionBatch {
+
+    void countWallsToTarget(const WallBitmap& walls,
+                            const int* sourceX, const int* sourceY, std::size_t count,
+                            int targetX, int targetY, int* wallCounts, int wallLimit) {
+        countWallsToTarget(CpuFeatures::detectIsa(), walls, sourceX, sourceY, count,
+                           targetX, targetY, wallCounts, wallLimit);
+    }
+
+    void countWallsToTarget(Isa isa, const WallBitmap& walls,
+                            const int* sourceX, const int* sourceY, std::size_t count,
+                            int targetX, int targetY, int* wallCounts, int wallLimit) {
+        // 不能超过CPU实际支持的指令集
+        if (static_cast<int>(isa) > static_cast<int>(CpuFeatures::detectIsa())) {
+            isa = CpuFeatures::detectIsa();
+        }
+
+        // 目标在地图外时整条线都要逐格做边界检查，直接走标量版本
+        if (isa == Isa::Scalar || !walls.inBounds(targetX, targetY)) {
+            for (std::size_t i = 0; i < count; i++) {
+                wallCounts[i] = countWallsScalar(walls, sourceX[i], sourceY[i], targetX, targetY, wallLimit);
+            }
+            return;
+        }
+
+        if (isa == Isa::AVX2) {
+            detail::countWallsAVX2(walls, sourceX, sourceY, count, targetX, targetY, wallCounts, wallLimit);
+        } else {
+            detail::countWallsSSE2(walls, sourceX, sourceY, count, targetX, targetY, wallCounts, wallLimit);
+        }
+
+        // SIMD版本把地图外的起点当作目标本身处理，这里用标量版本修正
+        for (std::size_t i = 0; i < count; i++) {
+            if (!walls.inBounds(sourceX[i], sourceY[i])) {
+                wallCounts[i] = countWallsScalar(walls, sourceX[i], sourceY[i], targetX, targetY, wallLimit);
+            }
+        }
+    }
+}
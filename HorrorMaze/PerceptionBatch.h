@@ -0,0 +1,55 @@
+#pragma once
+#include <climits>
+#include <cstddef>
+#include "CpuFeatures.h"
+#include "WallBitmap.h"
+
+/**
+ * PerceptionBatch：批量感知内核（多个起点 → 同一个目标）
+ *
+ * 所有鬼的视觉/打火机检测都是"从鬼所在格到玩家所在格数墙"，
+ * 目标相同、只有起点不同。这里把多条 Bresenham 线放进SIMD的各个通道同步步进：
+ *
+ *   AVX2  - 8 通道 × 2 组交错（16 条线同时在途），用 gather 从位图取墙体位
+ *   SSE2  - 4 通道同步步进，逐通道取位
+ *   Scalar - 逐条调用 GridTrace（非x86平台或不支持SIMD时）
+ *
+ * 已经走完的通道停在终点并被屏蔽，不再累加墙数；数到 wallLimit 堵墙的通道同样提前退出，
+ * 所有通道都退出后整组停止步进。运行时选择可用的最快实现（CpuFeatures）。
+ *
+ * 结果和 GridTrace::StopAfterWalls(wallLimit)（含两端）完全一致，
+ * 不设上限时就是 GridTrace::CountWalls。模拟只用它判断打火机光照（墙数 <= 1，上限 2），
+ * 视线查预计算可见集（见 Ghost::canSeePlayer）。
+ */
+namespace PerceptionBatch {
+
+    using Isa = CpuFeatures::Isa;
+
+    constexpr int NO_WALL_LIMIT = INT_MAX;
+
+    /**
+     * 从 count 个起点 (sourceX[i], sourceY[i]) 到同一目标格数墙
+     *
+     * @param wallCounts 输出：每条线上的墙数（含起点和终点格），最多为 wallLimit
+     * @param wallLimit  数到这么多堵墙就停（>= 1）
+     */
+    void countWallsToTarget(const WallBitmap& walls,
+                            const int* sourceX, const int* sourceY, std::size_t count,
+                            int targetX, int targetY, int* wallCounts, int wallLimit = NO_WALL_LIMIT);
+
+    // 指定实现（基准测试和校验用；CPU不支持时自动退回标量版本）
+    void countWallsToTarget(Isa isa, const WallBitmap& walls,
+                            const int* sourceX, const int* sourceY, std::size_t count,
+                            int targetX, int targetY, int* wallCounts, int wallLimit = NO_WALL_LIMIT);
+
+    namespace detail {
+        // 各实现（PerceptionBatchSimd.cpp）。只处理起点和目标都在地图内的情况，
+        // 地图外的起点由调用者另外用标量版本修正。非x86平台是空函数（detectIsa 不会选到）
+        void countWallsSSE2(const WallBitmap& walls,
+                            const int* sourceX, const int* sourceY, std::size_t count,
+                            int targetX, int targetY, int* wallCounts, int wallLimit);
+        void countWallsAVX2(const WallBitmap& walls,
+                            const int* sourceX, const int* sourceY, std::size_t count,
+                            int targetX, int targetY, int* wallCounts, int wallLimit);
+    }
+}
@@ -0,0 +1,257 @@
+#include "PerceptionBatch.h"
+#include "SimdTarget.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+/**
+ * PerceptionBatch 的 SSE2 / AVX2 实现（编译方式见 SimdTarget.h）
+ *
+ * 每个通道的状态和 GridTrace::detail::walk 一一对应：
+ *   cx      当前x
+ *   rowOff  当前行在位图中的起始字下标（代替 cy，y方向步进时加减 rowStep）
+ *   err     Bresenham误差项
+ *   steps   这条线一共要访问的格子数 = max(|dx|, |dy|) + 1
+ * 第 s 步访问第 s 个格子；s + 1 >= steps 的通道不再前进，停在终点。
+ * 墙数到达 wallLimit 的通道不再累加、不再前进；没有通道还要前进时整块提前结束。
+ */
+
+namespace PerceptionBatch {
+namespace detail {
+
+#if SIMD_X86
+
+    namespace {
+
+        // 地图外的起点替换成目标本身（结果稍后由标量版本修正）
+        inline void clampSource(const WallBitmap& walls, int targetX, int targetY, int& x, int& y) {
+            if (!walls.inBounds(x, y)) {
+                x = targetX;
+                y = targetY;
+            }
+        }
+
+        // ===================== SSE2：4 通道 =====================
+
+        SIMD_TARGET_SSE2
+        void countBlockSSE2(const WallBitmap& walls, const int* sourceX, const int* sourceY,
+                            int targetX, int targetY, int* out, int wallLimit) {
+            const std::uint64_t* words = walls.data();
+            const int stride = walls.getStride();
+
+            alignas(16) int cx[4], rowOff[4], err[4], dxl[4], dyl[4], sx[4], rowStep[4], steps[4];
+            int maxSteps = 0;
+            for (int lane = 0; lane < 4; lane++) {
+                int x0 = sourceX[lane];
+                int y0 = sourceY[lane];
+                clampSource(walls, targetX, targetY, x0, y0);
+                dxl[lane] = std::abs(targetX - x0);
+                dyl[lane] = std::abs(targetY - y0);
+                sx[lane] = (x0 < targetX) ? 1 : -1;
+                rowStep[lane] = (y0 < targetY) ? stride : -stride;
+                err[lane] = dxl[lane] - dyl[lane];
+                cx[lane] = x0;
+                rowOff[lane] = y0 * stride;
+                steps[lane] = std::max(dxl[lane], dyl[lane]) + 1;
+                maxSteps = std::max(maxSteps, steps[lane]);
+            }
+
+            __m128i vcx = _mm_load_si128(reinterpret_cast<const __m128i*>(cx));
+            __m128i vrow = _mm_load_si128(reinterpret_cast<const __m128i*>(rowOff));
+            __m128i verr = _mm_load_si128(reinterpret_cast<const __m128i*>(err));
+            const __m128i vdx = _mm_load_si128(reinterpret_cast<const __m128i*>(dxl));
+            const __m128i vdy = _mm_load_si128(reinterpret_cast<const __m128i*>(dyl));
+            const __m128i vnegdy = _mm_sub_epi32(_mm_setzero_si128(), vdy);
+            const __m128i vsx = _mm_load_si128(reinterpret_cast<const __m128i*>(sx));
+            const __m128i vrowStep = _mm_load_si128(reinterpret_cast<const __m128i*>(rowStep));
+            const __m128i vsteps = _mm_load_si128(reinterpret_cast<const __m128i*>(steps));
+            const __m128i vlimit = _mm_set1_epi32(wallLimit);
+            __m128i vwalls = _mm_setzero_si128();
+
+            for (int s = 0; s < maxSteps; s++) {
+                // SSE2 没有 gather：下标和位移量用向量算好，逐通道取位
+                alignas(16) int index[4], shift[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_add_epi32(vrow, _mm_srli_epi32(vcx, 6)));
+                _mm_store_si128(reinterpret_cast<__m128i*>(shift), _mm_and_si128(vcx, _mm_set1_epi32(63)));
+                __m128i vbits = _mm_set_epi32(
+                    static_cast<int>((words[index[3]] >> shift[3]) & 1u),
+                    static_cast<int>((words[index[2]] >> shift[2]) & 1u),
+                    static_cast<int>((words[index[1]] >> shift[1]) & 1u),
+                    static_cast<int>((words[index[0]] >> shift[0]) & 1u));
+                __m128i active = _mm_and_si128(_mm_cmpgt_epi32(vsteps, _mm_set1_epi32(s)),
+                                               _mm_cmpgt_epi32(vlimit, vwalls));
+                vwalls = _mm_add_epi32(vwalls, _mm_and_si128(vbits, active));
+
+                __m128i advance = _mm_and_si128(_mm_cmpgt_epi32(vsteps, _mm_set1_epi32(s + 1)),
+                                                _mm_cmpgt_epi32(vlimit, vwalls));
+                if (_mm_movemask_epi8(advance) == 0) {
+                    break;
+                }
+                __m128i e2 = _mm_add_epi32(verr, verr);
+                __m128i xm = _mm_and_si128(_mm_cmpgt_epi32(e2, vnegdy), advance);
+                __m128i ym = _mm_and_si128(_mm_cmpgt_epi32(vdx, e2), advance);
+                verr = _mm_sub_epi32(verr, _mm_and_si128(vdy, xm));
+                verr = _mm_add_epi32(verr, _mm_and_si128(vdx, ym));
+                vcx = _mm_add_epi32(vcx, _mm_and_si128(vsx, xm));
+                vrow = _mm_add_epi32(vrow, _mm_and_si128(vrowStep, ym));
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), vwalls);
+        }
+
+        // ===================== AVX2：8 通道 × 2 组 =====================
+
+        struct Lanes8 {
+            __m256i cx;
+            __m256i rowOff;     // 以32位字为单位
+            __m256i err;
+            __m256i dx;
+            __m256i dy;
+            __m256i negdy;
+            __m256i sx;
+            __m256i rowStep;
+            __m256i steps;
+            __m256i walls;
+        };
+
+        SIMD_TARGET_AVX2
+        inline void setupLanes(Lanes8& l, __m256i x0, __m256i y0, __m256i tx, __m256i ty,
+                               __m256i width, __m256i height, __m256i stride32) {
+            // 地图外的起点替换成目标（结果稍后修正）
+            const __m256i minusOne = _mm256_set1_epi32(-1);
+            __m256i inBounds = _mm256_and_si256(
+                _mm256_and_si256(_mm256_cmpgt_epi32(x0, minusOne), _mm256_cmpgt_epi32(width, x0)),
+                _mm256_and_si256(_mm256_cmpgt_epi32(y0, minusOne), _mm256_cmpgt_epi32(height, y0)));
+            x0 = _mm256_blendv_epi8(tx, x0, inBounds);
+            y0 = _mm256_blendv_epi8(ty, y0, inBounds);
+
+            const __m256i one = _mm256_set1_epi32(1);
+            l.dx = _mm256_abs_epi32(_mm256_sub_epi32(tx, x0));
+            l.dy = _mm256_abs_epi32(_mm256_sub_epi32(ty, y0));
+            l.negdy = _mm256_sub_epi32(_mm256_setzero_si256(), l.dy);
+            // x0 < tx ? 1 : -1  →  (mask & 2) - 1
+            l.sx = _mm256_sub_epi32(_mm256_and_si256(_mm256_cmpgt_epi32(tx, x0), _mm256_set1_epi32(2)), one);
+            // y0 < ty ? stride : -stride  →  (mask & 2*stride) - stride
+            l.rowStep = _mm256_sub_epi32(
+                _mm256_and_si256(_mm256_cmpgt_epi32(ty, y0), _mm256_add_epi32(stride32, stride32)), stride32);
+            l.err = _mm256_sub_epi32(l.dx, l.dy);
+            l.cx = x0;
+            l.rowOff = _mm256_mullo_epi32(y0, stride32);
+            l.steps = _mm256_add_epi32(_mm256_max_epi32(l.dx, l.dy), one);
+            l.walls = _mm256_setzero_si256();
+        }
+
+        // 返回还要继续前进的通道（全 0 时这一组已经结束）
+        SIMD_TARGET_AVX2
+        inline __m256i stepLanes(Lanes8& l, const int* base, __m256i s, __m256i sNext, __m256i limit) {
+            const __m256i one = _mm256_set1_epi32(1);
+
+            // 取墙体位：32位字下标 = rowOff + cx/32，位 = cx%32
+            __m256i index = _mm256_add_epi32(l.rowOff, _mm256_srli_epi32(l.cx, 5));
+            __m256i word = _mm256_i32gather_epi32(base, index, 4);
+            __m256i bit = _mm256_and_si256(
+                _mm256_srlv_epi32(word, _mm256_and_si256(l.cx, _mm256_set1_epi32(31))), one);
+            __m256i active = _mm256_and_si256(_mm256_cmpgt_epi32(l.steps, s), _mm256_cmpgt_epi32(limit, l.walls));
+            l.walls = _mm256_add_epi32(l.walls, _mm256_and_si256(bit, active));
+
+            // Bresenham前进（最后一格之后、数够墙之后不再前进，保证 gather 不越界）
+            __m256i advance = _mm256_and_si256(_mm256_cmpgt_epi32(l.steps, sNext), _mm256_cmpgt_epi32(limit, l.walls));
+            __m256i e2 = _mm256_add_epi32(l.err, l.err);
+            __m256i xm = _mm256_and_si256(_mm256_cmpgt_epi32(e2, l.negdy), advance);
+            __m256i ym = _mm256_and_si256(_mm256_cmpgt_epi32(l.dx, e2), advance);
+            l.err = _mm256_add_epi32(_mm256_sub_epi32(l.err, _mm256_and_si256(l.dy, xm)),
+                                     _mm256_and_si256(l.dx, ym));
+            l.cx = _mm256_add_epi32(l.cx, _mm256_and_si256(l.sx, xm));
+            l.rowOff = _mm256_add_epi32(l.rowOff, _mm256_and_si256(l.rowStep, ym));
+            return advance;
+        }
+
+        SIMD_TARGET_AVX2
+        inline int horizontalMax(__m256i v) {
+            __m128i m = _mm_max_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+            m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+            m = _mm_max_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+            return _mm_cvtsi128_si32(m);
+        }
+
+        // 16 条线一组：两组8通道交错步进，隐藏 gather 的延迟
+        SIMD_TARGET_AVX2
+        void countBlockAVX2(const WallBitmap& walls, const int* sourceX, const int* sourceY,
+                            int targetX, int targetY, int* out, int wallLimit) {
+            // 位图按64位字存储；x86是小端，第 x 位就在第 x/32 个32位字的第 x%32 位
+            const int* base = reinterpret_cast<const int*>(walls.data());
+            const __m256i stride32 = _mm256_set1_epi32(walls.getStride() * 2);
+            const __m256i width = _mm256_set1_epi32(walls.getWidth());
+            const __m256i height = _mm256_set1_epi32(walls.getHeight());
+            const __m256i tx = _mm256_set1_epi32(targetX);
+            const __m256i ty = _mm256_set1_epi32(targetY);
+            const __m256i limit = _mm256_set1_epi32(wallLimit);
+
+            Lanes8 a, b;
+            setupLanes(a, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceX)),
+                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceY)),
+                       tx, ty, width, height, stride32);
+            setupLanes(b, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceX + 8)),
+                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sourceY + 8)),
+                       tx, ty, width, height, stride32);
+
+            int maxSteps = horizontalMax(_mm256_max_epi32(a.steps, b.steps));
+            for (int s = 0; s < maxSteps; s++) {
+                __m256i vs = _mm256_set1_epi32(s);
+                __m256i vsNext = _mm256_set1_epi32(s + 1);
+                __m256i advance = _mm256_or_si256(stepLanes(a, base, vs, vsNext, limit),
+                                                  stepLanes(b, base, vs, vsNext, limit));
+                if (_mm256_testz_si256(advance, advance)) {
+                    break;
+                }
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), a.walls);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 8), b.walls);
+        }
+
+        /**
+         * 按固定宽度分块；最后不满一块时用目标本身补齐（补齐的通道结果丢弃）
+         */
+        template <int Width, typename Block>
+        void forEachBlock(const WallBitmap& walls, const int* sourceX, const int* sourceY,
+                          std::size_t count, int targetX, int targetY, int* wallCounts, int wallLimit, Block block) {
+            std::size_t i = 0;
+            for (; i + Width <= count; i += Width) {
+                block(walls, sourceX + i, sourceY + i, targetX, targetY, wallCounts + i, wallLimit);
+            }
+            if (i < count) {
+                int padX[Width], padY[Width], padOut[Width];
+                std::size_t rest = count - i;
+                for (int lane = 0; lane < Width; lane++) {
+                    bool used = static_cast<std::size_t>(lane) < rest;
+                    padX[lane] = used ? sourceX[i + lane] : targetX;
+                    padY[lane] = used ? sourceY[i + lane] : targetY;
+                }
+                block(walls, padX, padY, targetX, targetY, padOut, wallLimit);
+                std::copy(padOut, padOut + rest, wallCounts + i);
+            }
+        }
+    }
+
+    void countWallsSSE2(const WallBitmap& walls,
+                        const int* sourceX, const int* sourceY, std::size_t count,
+                        int targetX, int targetY, int* wallCounts, int wallLimit) {
+        forEachBlock<4>(walls, sourceX, sourceY, count, targetX, targetY, wallCounts, wallLimit, countBlockSSE2);
+    }
+
+    void countWallsAVX2(const WallBitmap& walls,
+                        const int* sourceX, const int* sourceY, std::size_t count,
+                        int targetX, int targetY, int* wallCounts, int wallLimit) {
+        forEachBlock<16>(walls, sourceX, sourceY, count, targetX, targetY, wallCounts, wallLimit, countBlockAVX2);
+    }
+
+#else  // 非x86平台：只有标量版本
+
+    void countWallsSSE2(const WallBitmap&, const int*, const int*, std::size_t, int, int, int*, int) {}
+    void countWallsAVX2(const WallBitmap&, const int*, const int*, std::size_t, int, int, int*, int) {}
+
+#endif
+
+}
+}
@@ -1,9 +1,8 @@
 #include "Player.h"
 #include "Maze.h"
-#include <SFML/Window/Keyboard.hpp>
+#include "Logger.h"
+#include "SimulationSnapshot.h"
 #include <cmath>
-#include <iostream>
-#include <array>
 
 /**
  * 默认构造函数：创建一个在(1.5, 1.5)位置的玩家
@@ -58,33 +57,17 @@ Player::Player(float startX, float startY)
 }
 
 /**
- * 检查键盘输入，更新输入状态
+ * 读取本步输入，更新移动状态和移动模式
  */
-void Player::handleInput() {
-    // 检查前进键（W或上箭头）
-    movingForward = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::W) ||
-                   sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Up);
+void Player::handleInput(const PlayerInput& input) {
+    movingForward = input.forward;
+    movingBackward = input.backward;
+    strafingLeft = input.strafeLeft;
+    strafingRight = input.strafeRight;
 
-    // 检查后退键（S或下箭头）
-    movingBackward = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::S) ||
-                    sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Down);
-
-    // 检查左移键（A或左箭头）
-    strafingLeft = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::A) ||
-                  sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Left);
-
-    // 检查右移键（D或右箭头）
-    strafingRight = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::D) ||
-                   sf::Keyboard::isKeyPressed(sf::Keyboard::Key::Right);
-
-    bool runPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LShift) ||
-                      sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RShift);
-    bool crouchPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Key::LControl) ||
-                         sf::Keyboard::isKeyPressed(sf::Keyboard::Key::RControl);
-
-    if (crouchPressed) {
+    if (input.crouch) {
         m_moveMode = MoveMode::Crouch;
-    } else if (runPressed) {
+    } else if (input.run) {
         m_moveMode = MoveMode::Run;
     } else {
         m_moveMode = MoveMode::Walk;
@@ -216,19 +199,20 @@ void Player::rotate(float angle) {
 }
 
 /**
- * 每帧更新玩家状态
+ * 每步更新玩家状态
  *
- * @param deltaTime 上一帧到现在的时间（秒）
+ * @param deltaTime 模拟步长（秒）
  * @param maze 迷宫对象
+ * @param input 本步输入
  */
-void Player::update(float deltaTime, const Maze& maze) {
+void Player::update(float deltaTime, const Maze& maze, const PlayerInput& input) {
     // 冻结时锁定
     if (m_frozen) {
         return;
     }
 
-    // 步骤1：检查键盘输入
-    handleInput();
+    // 步骤1：读取本步输入
+    handleInput(input);
 
     float targetOffset = 0.0f;
     if (m_moveMode == MoveMode::Crouch) {
@@ -276,6 +260,59 @@ void Player::update(float deltaTime, const Maze& maze) {
     move(deltaTime, maze);
 }
 
+/**
+ * 当前移动模式下的脚步声强度
+ */
+float Player::getFootstepLoudness() const {
+    switch (m_moveMode) {
+        case MoveMode::Run:
+            return FOOTSTEP_RUN;
+        case MoveMode::Crouch:
+            return FOOTSTEP_CROUCH;
+        case MoveMode::Walk:
+        default:
+            return FOOTSTEP_WALK;
+    }
+}
+
+Player::Pose Player::getPose() const {
+    return Pose{x, y, dirX, dirY, planeX, planeY, m_cameraOffsetY};
+}
+
+void Player::setPose(const Pose& pose) {
+    x = pose.x;
+    y = pose.y;
+    dirX = pose.dirX;
+    dirY = pose.dirY;
+    planeX = pose.planeX;
+    planeY = pose.planeY;
+    m_cameraOffsetY = pose.cameraOffsetY;
+}
+
+/**
+ * 位姿插值
+ *
+ * 朝向不能直接线性插值（转得多时向量会变短，画面会被拉伸），
+ * 这里先求出两个朝向的夹角，再把 from 的朝向和相机平面旋转 alpha 倍夹角。
+ */
+Player::Pose Player::interpolatePose(const Pose& from, const Pose& to, float alpha) {
+    Pose result;
+    result.x = from.x + (to.x - from.x) * alpha;
+    result.y = from.y + (to.y - from.y) * alpha;
+    result.cameraOffsetY = from.cameraOffsetY + (to.cameraOffsetY - from.cameraOffsetY) * alpha;
+
+    float cross = from.dirX * to.dirY - from.dirY * to.dirX;
+    float dot = from.dirX * to.dirX + from.dirY * to.dirY;
+    float angle = std::atan2(cross, dot) * alpha;
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+    result.dirX = from.dirX * c - from.dirY * s;
+    result.dirY = from.dirX * s + from.dirY * c;
+    result.planeX = from.planeX * c - from.planeY * s;
+    result.planeY = from.planeX * s + from.planeY * c;
+    return result;
+}
+
 void Player::updateStamina(float deltaTime, bool isMoving) {
     if (m_inWall) {
         m_staminaMax -= STAMINA_WALL_MAX_DECAY * deltaTime;
@@ -303,9 +340,9 @@ void Player::updateStamina(float deltaTime, bool isMoving) {
 void Player::toggleLighter() {
     if (m_hasLighter && !m_lighterDisabled) {
         m_lighterOn = !m_lighterOn;
-        std::cout << "Lighter: " << (m_lighterOn ? "ON" : "OFF") << std::endl;
+        LOG_INFO("Lighter: " << (m_lighterOn ? "ON" : "OFF"));
     } else if (m_lighterDisabled) {
-        std::cout << "Lighter is disabled!" << std::endl;
+        LOG_INFO("Lighter is disabled!");
     }
 }
 
@@ -315,7 +352,7 @@ void Player::toggleLighter() {
 void Player::disableLighter() {
     m_lighterOn = false;  // 强制关闭
     m_lighterDisabled = true;  // 禁用
-    std::cout << ">>> Lighter forcibly turned OFF and DISABLED! <<<" << std::endl;
+    LOG_INFO(">>> Lighter forcibly turned OFF and DISABLED! <<<");
 }
 
 /**
@@ -323,7 +360,7 @@ void Player::disableLighter() {
  */
 void Player::enableLighter() {
     m_lighterDisabled = false;  // 恢复
-    std::cout << "Lighter functionality restored." << std::endl;
+    LOG_INFO("Lighter functionality restored.");
 }
 
 /**
@@ -333,7 +370,7 @@ void Player::activateSpiritVision() {
     if (!m_spiritVisionActive) {
         m_spiritVisionActive = true;
         m_spiritVisionTimer = SPIRIT_VISION_DURATION;
-        std::cout << ">>> SPIRIT VISION ACTIVATED <<<" << std::endl;
+        LOG_INFO(">>> SPIRIT VISION ACTIVATED <<<");
     }
 }
 
@@ -346,42 +383,11 @@ void Player::updateSpiritVision(float deltaTime) {
         if (m_spiritVisionTimer <= 0.0f) {
             m_spiritVisionActive = false;
             m_spiritVisionTimer = 0.0f;
-            std::cout << "Spirit Vision deactivated." << std::endl;
+            LOG_INFO("Spirit Vision deactivated.");
         }
     }
 }
 
-/**
- * 渲染玩家（俯视图）
- *
- * 绘制：
- * 1. 一个红色圆点（玩家位置）
- * 2. 一条黄色线（表示朝向）
- *
- * @param window SFML窗口对象
- * @param cellSize 每个格子的像素大小
- */
-void Player::renderTopDown(sf::RenderWindow& window, float cellSize) const {
-    // 绘制玩家圆点
-    float radius = cellSize * 0.3f;  // 圆的半径
-    sf::CircleShape playerCircle(radius);
-
-    playerCircle.setFillColor(sf::Color::Red);
-    playerCircle.setOrigin({radius, radius});  // 设置中心点
-    playerCircle.setPosition({x * cellSize, y * cellSize});
-
-    window.draw(playerCircle);
-
-    // 绘制方向指示线
-    std::array<sf::Vertex, 2> line;
-    line[0].position = sf::Vector2f(x * cellSize, y * cellSize);
-    line[0].color = sf::Color::Yellow;
-    line[1].position = sf::Vector2f((x + dirX * 0.5f) * cellSize, (y + dirY * 0.5f) * cellSize);
-    line[1].color = sf::Color::Yellow;
-
-    window.draw(line.data(), 2, sf::PrimitiveType::Lines);
-}
-
 /**
  * 切换钻墙/出墙状态
  *
@@ -411,7 +417,7 @@ void Player::toggleWallPhase(const Maze& maze) {
 
         if (maze.isWall(static_cast<int>(checkX), static_cast<int>(checkY))) {
             // 前方有墙，可以钻入
-            std::cout << ">>> Phasing into wall... <<<" << std::endl;
+            LOG_INFO(">>> Phasing into wall... <<<");
 
             // 保存钻墙前的状态
             m_wallEntryX = x;
@@ -425,11 +431,11 @@ void Player::toggleWallPhase(const Maze& maze) {
             m_wallPhaseTimer = 0.0f;
             m_wallPhaseRotateRemaining = std::acos(-1.0f);
         } else {
-            std::cout << "No wall ahead to phase into!" << std::endl;
+            LOG_INFO("No wall ahead to phase into!");
         }
     } else {
         // === 退出墙 ===
-        std::cout << ">>> Phasing out of wall... <<<" << std::endl;
+        LOG_INFO(">>> Phasing out of wall... <<<");
 
         m_wallPhaseState = WallPhaseState::Exiting;
         m_wallPhaseTimer = 0.0f;
@@ -465,3 +471,46 @@ void Player::updateWallPhase(float deltaTime) {
     }
 }
 
+/**
+ * 快照：按成员声明顺序逐个读写
+ */
+void Player::saveState(SnapshotWriter& out) const {
+    out.write(x); out.write(y);
+    out.write(dirX); out.write(dirY);
+    out.write(planeX); out.write(planeY);
+    out.write(moveSpeed); out.write(rotateSpeed);
+    out.write(m_moveMode);
+    out.write(m_cameraOffsetY); out.write(m_cameraOffsetTargetY);
+    out.write(movingForward); out.write(movingBackward);
+    out.write(strafingLeft); out.write(strafingRight);
+    out.write(m_hasLighter); out.write(m_lighterOn); out.write(m_lighterDisabled);
+    out.write(m_spiritVisionActive); out.write(m_spiritVisionTimer);
+    out.write(m_inWall);
+    out.write(m_wallEntryX); out.write(m_wallEntryY);
+    out.write(m_wallEntryDirX); out.write(m_wallEntryDirY);
+    out.write(m_wallEntryPlaneX); out.write(m_wallEntryPlaneY);
+    out.write(m_wallPhaseState); out.write(m_wallPhaseTimer); out.write(m_wallPhaseRotateRemaining);
+    out.write(m_stamina); out.write(m_staminaMax);
+    out.write(m_frozen);
+}
+
+bool Player::loadState(SnapshotReader& in) {
+    in.read(x); in.read(y);
+    in.read(dirX); in.read(dirY);
+    in.read(planeX); in.read(planeY);
+    in.read(moveSpeed); in.read(rotateSpeed);
+    in.read(m_moveMode);
+    in.read(m_cameraOffsetY); in.read(m_cameraOffsetTargetY);
+    in.read(movingForward); in.read(movingBackward);
+    in.read(strafingLeft); in.read(strafingRight);
+    in.read(m_hasLighter); in.read(m_lighterOn); in.read(m_lighterDisabled);
+    in.read(m_spiritVisionActive); in.read(m_spiritVisionTimer);
+    in.read(m_inWall);
+    in.read(m_wallEntryX); in.read(m_wallEntryY);
+    in.read(m_wallEntryDirX); in.read(m_wallEntryDirY);
+    in.read(m_wallEntryPlaneX); in.read(m_wallEntryPlaneY);
+    in.read(m_wallPhaseState); in.read(m_wallPhaseTimer); in.read(m_wallPhaseRotateRemaining);
+    in.read(m_stamina); in.read(m_staminaMax);
+    in.read(m_frozen);
+    return in.isOk();
+}
@@ -1,8 +1,27 @@
 #pragma once
-#include <SFML/Graphics.hpp>
-
 // 前向声明（告诉编译器Maze类存在，但详细定义在Maze.h中）
 class Maze;
+class SnapshotWriter;
+class SnapshotReader;
+namespace sf { class RenderWindow; }
+
+/**
+ * 玩家在一个模拟步长内的输入
+ *
+ * 游戏每步从键盘/鼠标采样一次；无头程序和回放直接构造。
+ * 模拟核心只看这个结构体，不直接读键盘。
+ */
+struct PlayerInput {
+    bool forward = false;          // W / ↑
+    bool backward = false;         // S / ↓
+    bool strafeLeft = false;       // A / ←
+    bool strafeRight = false;      // D / →
+    bool run = false;              // Shift
+    bool crouch = false;           // Ctrl
+    float turn = 0.0f;             // 本步的视角旋转（弧度，由鼠标横向移动换算）
+    bool toggleLighter = false;    // 本步内按下了 F
+    bool toggleWallPhase = false;  // 本步内按下了 E
+};
 
 /**
  * Player类：管理玩家的位置、移动、旋转
@@ -24,12 +43,20 @@ public:
         Crouch
     };
 
+    // 位姿（位置 + 朝向 + 相机），固定步长模拟时用于渲染插值
+    struct Pose {
+        float x, y;
+        float dirX, dirY;
+        float planeX, planeY;
+        float cameraOffsetY;
+    };
+
     // 构造函数
     Player();
     Player(float startX, float startY);
 
     // 核心功能
-    void update(float deltaTime, const Maze& maze);  // 每帧更新
+    void update(float deltaTime, const Maze& maze, const PlayerInput& input);  // 每步更新
     void move(float deltaTime, const Maze& maze);    // 处理移动
     void rotate(float angle);                        // 旋转视角
 
@@ -41,6 +68,7 @@ public:
     float getPlaneX() const { return planeX; }
     float getPlaneY() const { return planeY; }
     MoveMode getMoveMode() const { return m_moveMode; }
+    float getFootstepLoudness() const;  // 当前移动模式下的脚步声强度（投递给刺激系统）
     float getCameraOffsetY() const { return m_cameraOffsetY; }
     float getStamina() const { return m_stamina; }
     float getStaminaMax() const { return m_staminaMax; }
@@ -69,7 +97,26 @@ public:
     void unfreeze() { m_frozen = false; }
     bool isFrozen() const { return m_frozen; }
 
-    // 渲染（俯视图）
+    // 碰撞检测：以 (newX, newY) 为中心的碰撞体积是否碰到墙
+    bool checkCollision(float newX, float newY, const Maze& maze) const;
+
+    // 位姿读写（setPose 只给渲染用的副本使用）
+    Pose getPose() const;
+    void setPose(const Pose& pose);
+
+    /**
+     * 在两个模拟状态之间插值
+     * 位置线性插值；朝向和相机平面按夹角旋转插值（保持长度和视野不变）
+     *
+     * @param alpha 0 = from，1 = to
+     */
+    static Pose interpolatePose(const Pose& from, const Pose& to, float alpha);
+
+    // 快照：保存/恢复全部状态（见 SimulationSnapshot.h）
+    void saveState(SnapshotWriter& out) const;
+    bool loadState(SnapshotReader& in);
+
+    // 渲染（俯视图，定义在 PlayerRender.cpp）
     void renderTopDown(sf::RenderWindow& window, float cellSize) const;
 
 private:
@@ -85,7 +132,7 @@ private:
     float m_cameraOffsetY;   // 视角垂直偏移（像素）
     float m_cameraOffsetTargetY;
 
-    // 输入状态（记录哪些键被按下）
+    // 输入状态（本步哪些移动键被按下）
     bool movingForward;      // W或↑键
     bool movingBackward;     // S或↓键
     bool strafingLeft;       // A或←键
@@ -101,6 +148,11 @@ private:
     float m_spiritVisionTimer;    // 闪灵持续时间计时器
     static constexpr float SPIRIT_VISION_DURATION = 3.0f;  // 持续3秒
 
+    // 脚步声强度（按移动模式）
+    static constexpr float FOOTSTEP_WALK = 30.0f;     // 走路
+    static constexpr float FOOTSTEP_RUN = 100.0f;     // 奔跑
+    static constexpr float FOOTSTEP_CROUCH = 10.0f;   // 蹲走
+
     static constexpr float WALK_SPEED = 2.0f;
     static constexpr float RUN_SPEED = 4.0f;
     static constexpr float CROUCH_SPEED = 1.0f;
@@ -138,8 +190,7 @@ private:
     bool m_frozen;  // 是否被双胞胎冻结
 
     // 私有辅助函数
-    void handleInput();      // 检查键盘输入
-    bool checkCollision(float newX, float newY, const Maze& maze) const;  // 碰撞检测
+    void handleInput(const PlayerInput& input);  // 读取本步输入
     void updateWallPhase(float deltaTime);
     void updateStamina(float deltaTime, bool isMoving);
 };
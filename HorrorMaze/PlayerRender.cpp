@@ -0,0 +1,36 @@
+#include "Player.h"
+#include <SFML/Graphics.hpp>
+#include <array>
+
+// Player 的绘制部分（只有游戏程序编译；模拟核心和无头程序不依赖图形模块）
+
+/**
+ * 渲染玩家（俯视图）
+ *
+ * 绘制：
+ * 1. 一个红色圆点（玩家位置）
+ * 2. 一条黄色线（表示朝向）
+ *
+ * @param window SFML窗口对象
+ * @param cellSize 每个格子的像素大小
+ */
+void Player::renderTopDown(sf::RenderWindow& window, float cellSize) const {
+    // 绘制玩家圆点
+    float radius = cellSize * 0.3f;  // 圆的半径
+    sf::CircleShape playerCircle(radius);
+
+    playerCircle.setFillColor(sf::Color::Red);
+    playerCircle.setOrigin({radius, radius});  // 设置中心点
+    playerCircle.setPosition({x * cellSize, y * cellSize});
+
+    window.draw(playerCircle);
+
+    // 绘制方向指示线
+    std::array<sf::Vertex, 2> line;
+    line[0].position = sf::Vector2f(x * cellSize, y * cellSize);
+    line[0].color = sf::Color::Yellow;
+    line[1].position = sf::Vector2f((x + dirX * 0.5f) * cellSize, (y + dirY * 0.5f) * cellSize);
+    line[1].color = sf::Color::Yellow;
+
+    window.draw(line.data(), 2, sf::PrimitiveType::Lines);
+}
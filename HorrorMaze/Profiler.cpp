@@ -0,0 +1,177 @@
+#include "Profiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+
+namespace {
+    constexpr double NS_PER_MS = 1000000.0;
+
+    const char* const STAGE_NAMES[] = {
+        "Frame",
+        "Simulation",
+        "MouseLook",
+        "PlayerUpdate",
+        "TwinChecks",
+        "GhostUpdate",
+        "Footsteps",
+        "Snapshot",
+        "SkyFloor",
+        "CastRays",
+        "Upload",
+        "Grade",
+        "Sprites",
+        "Hud",
+        "Display"
+    };
+    static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<std::size_t>(ProfileStage::Count),
+                  "STAGE_NAMES must match ProfileStage");
+
+    int highestBit(std::uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) {
+            bit++;
+        }
+        return bit;
+    }
+
+    // 对数分桶：0~7 纳秒各一桶，之后每个2倍区间按最高位之后的3位再分8桶
+    std::size_t bucketIndex(std::uint64_t ns) {
+        if (ns < 8) {
+            return static_cast<std::size_t>(ns);
+        }
+        int msb = highestBit(ns);
+        std::size_t sub = static_cast<std::size_t>((ns >> (msb - 3)) & 7);
+        std::size_t index = static_cast<std::size_t>(msb - 2) * 8 + sub;
+        return std::min(index, Profiler::HISTOGRAM_BUCKETS - 1);
+    }
+
+    // 桶的代表值（区间中点）
+    double bucketValue(std::size_t index) {
+        if (index < 8) {
+            return static_cast<double>(index);
+        }
+        int msb = static_cast<int>(index / 8) + 2;
+        std::uint64_t sub = index % 8;
+        std::uint64_t lower = (8 + sub) << (msb - 3);
+        std::uint64_t width = std::uint64_t(1) << (msb - 3);
+        return static_cast<double>(lower) + width * 0.5;
+    }
+}
+
+Profiler& Profiler::instance() {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::Profiler()
+    : enabled(false)
+    , stages{}
+{
+}
+
+void Profiler::endFrame() {
+    if (!enabled) {
+        return;
+    }
+
+    for (auto& data : stages) {
+        if (!data.ranThisFrame) {
+            continue;
+        }
+        std::uint64_t ns = data.frameTotal;
+
+        data.window[data.windowPos] = ns;
+        data.windowPos = (data.windowPos + 1) % WINDOW_FRAMES;
+        data.windowCount = std::min(data.windowCount + 1, WINDOW_FRAMES);
+
+        data.histogram[bucketIndex(ns)]++;
+        data.sessionFrames++;
+        data.sessionTotal += ns;
+        data.sessionMax = std::max(data.sessionMax, ns);
+
+        data.frameTotal = 0;
+        data.ranThisFrame = false;
+    }
+}
+
+ProfileStats Profiler::getRollingStats(ProfileStage stage) const {
+    const StageData& data = stages[static_cast<std::size_t>(stage)];
+    ProfileStats stats{};
+    stats.frames = data.windowCount;
+    if (data.windowCount == 0) {
+        return stats;
+    }
+
+    std::vector<std::uint64_t> samples(data.window.begin(), data.window.begin() + data.windowCount);
+    auto percentile = [&samples](double p) {
+        std::size_t k = static_cast<std::size_t>(p * (samples.size() - 1) + 0.5);
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k] / NS_PER_MS;
+    };
+
+    std::uint64_t total = 0;
+    for (std::uint64_t ns : samples) {
+        total += ns;
+    }
+    stats.mean = total / NS_PER_MS / samples.size();
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = *std::max_element(samples.begin(), samples.end()) / NS_PER_MS;
+    return stats;
+}
+
+ProfileStats Profiler::getSessionStats(ProfileStage stage) const {
+    const StageData& data = stages[static_cast<std::size_t>(stage)];
+    ProfileStats stats{};
+    stats.frames = data.sessionFrames;
+    if (data.sessionFrames == 0) {
+        return stats;
+    }
+
+    double maxMs = data.sessionMax / NS_PER_MS;
+    auto percentile = [&data, maxMs](double p) {
+        std::uint64_t rank = static_cast<std::uint64_t>(p * (data.sessionFrames - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            seen += data.histogram[i];
+            if (seen >= rank) {
+                return std::min(bucketValue(i) / NS_PER_MS, maxMs);
+            }
+        }
+        return maxMs;
+    };
+
+    stats.mean = data.sessionTotal / NS_PER_MS / data.sessionFrames;
+    stats.p50 = percentile(0.50);
+    stats.p95 = percentile(0.95);
+    stats.p99 = percentile(0.99);
+    stats.max = maxMs;
+    return stats;
+}
+
+bool Profiler::writeCsv(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        LOG_ERROR("ERROR: Cannot write profile: " << filename);
+        return false;
+    }
+
+    file << "stage,frames,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+    file << std::fixed << std::setprecision(4);
+    for (std::size_t i = 0; i < stages.size(); i++) {
+        ProfileStage stage = static_cast<ProfileStage>(i);
+        ProfileStats stats = getSessionStats(stage);
+        file << getStageName(stage) << ',' << stats.frames << ',' << stats.mean << ','
+             << stats.p50 << ',' << stats.p95 << ',' << stats.p99 << ',' << stats.max << '\n';
+    }
+
+    LOG_INFO("Profile written: " << filename);
+    return true;
+}
+
+const char* Profiler::getStageName(ProfileStage stage) {
+    return STAGE_NAMES[static_cast<std::size_t>(stage)];
+}
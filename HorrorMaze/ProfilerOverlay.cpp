@@ -0,0 +1,119 @@
+#include "ProfilerOverlay.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace {
+    constexpr float PANEL_X = 10.0f;
+    constexpr float PANEL_Y = 10.0f;
+    constexpr float ROW_HEIGHT = 16.0f;
+    constexpr float NAME_WIDTH = 110.0f;   // 阶段名一列
+    constexpr float VALUE_WIDTH = 55.0f;   // 每个数值一列
+    constexpr float TEXT_WIDTH = NAME_WIDTH + VALUE_WIDTH * 4;
+    constexpr float BAR_WIDTH = 160.0f;    // 满格 = 一帧预算
+}
+
+ProfilerOverlay::ProfilerOverlay()
+    : visible(false)
+    , hasStats(false)
+    , stats{}
+{
+}
+
+void ProfilerOverlay::toggle() {
+    visible = !visible;
+    if (visible) {
+        Profiler::instance().setEnabled(true);
+        hasStats = false;  // 立即刷新一次
+    }
+}
+
+void ProfilerOverlay::refresh(const sf::Font* font) {
+    for (std::size_t i = 0; i < stats.size(); i++) {
+        stats[i] = Profiler::instance().getRollingStats(static_cast<ProfileStage>(i));
+    }
+    hasStats = true;
+    refreshClock.restart();
+
+    labels.clear();
+    if (!font) {
+        return;
+    }
+
+    // 每个单元格一个文字对象（字体不等宽，靠固定列位置对齐）
+    auto addLabel = [this, font](const std::string& value, std::size_t row, std::size_t column, sf::Color color) {
+        sf::Text label(*font);
+        label.setString(value);
+        label.setCharacterSize(12);
+        label.setFillColor(color);
+        float x = PANEL_X + 5.0f + (column == 0 ? 0.0f : NAME_WIDTH + (column - 1) * VALUE_WIDTH);
+        label.setPosition({x, PANEL_Y + 4.0f + row * ROW_HEIGHT});
+        labels.push_back(label);
+    };
+
+    const char* const headers[] = {"stage (ms)", "p50", "p95", "p99", "max"};
+    for (std::size_t column = 0; column < 5; column++) {
+        addLabel(headers[column], 0, column, sf::Color(160, 160, 160));
+    }
+
+    char value[32];
+    for (std::size_t i = 0; i < stats.size(); i++) {
+        std::size_t row = i + 1;
+        addLabel(Profiler::getStageName(static_cast<ProfileStage>(i)), row, 0, sf::Color(220, 220, 220));
+        if (stats[i].frames == 0) {
+            addLabel("-", row, 1, sf::Color(120, 120, 120));
+            continue;
+        }
+        const double values[] = {stats[i].p50, stats[i].p95, stats[i].p99, stats[i].max};
+        for (std::size_t k = 0; k < 4; k++) {
+            std::snprintf(value, sizeof(value), "%.2f", values[k]);
+            addLabel(value, row, k + 1, values[k] > FRAME_BUDGET_MS ? sf::Color(255, 90, 90) : sf::Color(220, 220, 220));
+        }
+    }
+}
+
+void ProfilerOverlay::draw(sf::RenderWindow& window, const sf::Font* font) {
+    if (!visible) {
+        return;
+    }
+    if (!hasStats || refreshClock.getElapsedTime().asSeconds() >= REFRESH_INTERVAL) {
+        refresh(font);
+    }
+
+    const float rows = static_cast<float>(stats.size() + 1);
+    sf::RectangleShape background({TEXT_WIDTH + BAR_WIDTH + 20.0f, rows * ROW_HEIGHT + 10.0f});
+    background.setFillColor(sf::Color(0, 0, 0, 170));
+    background.setPosition({PANEL_X, PANEL_Y});
+    window.draw(background);
+
+    for (const auto& label : labels) {
+        window.draw(label);
+    }
+
+    // 条形图：p50 实心、p95 浅色、p99 细线（超过一帧预算的部分截断）
+    const float barX = PANEL_X + TEXT_WIDTH + 10.0f;
+    auto toWidth = [](double ms) {
+        return BAR_WIDTH * std::min(1.0f, static_cast<float>(ms) / FRAME_BUDGET_MS);
+    };
+    for (std::size_t i = 0; i < stats.size(); i++) {
+        if (stats[i].frames == 0) {
+            continue;
+        }
+        float y = PANEL_Y + 5.0f + (i + 1) * ROW_HEIGHT;
+
+        sf::RectangleShape p95Bar({toWidth(stats[i].p95), ROW_HEIGHT - 6.0f});
+        p95Bar.setFillColor(sf::Color(90, 140, 90));
+        p95Bar.setPosition({barX, y});
+        window.draw(p95Bar);
+
+        sf::RectangleShape p50Bar({toWidth(stats[i].p50), ROW_HEIGHT - 6.0f});
+        p50Bar.setFillColor(sf::Color(120, 220, 120));
+        p50Bar.setPosition({barX, y});
+        window.draw(p50Bar);
+
+        sf::RectangleShape p99Mark({2.0f, ROW_HEIGHT - 4.0f});
+        p99Mark.setFillColor(stats[i].p99 > FRAME_BUDGET_MS ? sf::Color::Red : sf::Color(240, 200, 80));
+        p99Mark.setPosition({barX + toWidth(stats[i].p99), y - 1.0f});
+        window.draw(p99Mark);
+    }
+}
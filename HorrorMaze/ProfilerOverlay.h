@@ -0,0 +1,36 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+#include "Profiler.h"
+
+/**
+ * ProfilerOverlay：屏幕左上角的帧时间面板（F3 切换）
+ *
+ * 每个阶段一行：p50 / p95 / p99 / max（毫秒，最近 Profiler::WINDOW_FRAMES 帧），
+ * 右侧的条形图以 60Hz 的一帧（16.7ms）为满格：实心段是 p50，浅色段到 p95，细线标出 p99。
+ * 统计每 REFRESH_INTERVAL 秒刷新一次，避免面板本身每帧排序、拼字符串。
+ */
+class ProfilerOverlay {
+public:
+    ProfilerOverlay();
+
+    // 切换显示；第一次显示时顺便打开 Profiler
+    void toggle();
+    bool isVisible() const { return visible; }
+
+    // font 为空时只画条形图
+    void draw(sf::RenderWindow& window, const sf::Font* font);
+
+private:
+    static constexpr float REFRESH_INTERVAL = 0.5f;        // 秒
+    static constexpr float FRAME_BUDGET_MS = 1000.0f / 60.0f;
+
+    bool visible;
+    sf::Clock refreshClock;
+    bool hasStats;
+    std::array<ProfileStats, static_cast<std::size_t>(ProfileStage::Count)> stats;
+    std::vector<sf::Text> labels;  // 刷新时生成，每帧直接绘制
+
+    void refresh(const sf::Font* font);
+};
@@ -0,0 +1,109 @@
+#pragma once
+#include <cmath>
+#include "WallBitmap.h"
+
+/**
+ * RayCast：单条光线的DDA墙体求交（不依赖SFML）
+ *
+ * Renderer::castRays 对屏幕每一列调用一次，算出墙的垂直距离、
+ * 击中的墙面方向和格子、以及击中点在墙面上的位置（纹理X坐标用）。
+ * 抽成独立内核后，基准测试可以在没有窗口的情况下测量每秒能投射多少列。
+ */
+namespace RayCast {
+
+    static constexpr float MIN_DISTANCE = 0.01f;  // 距离下限（避免除以0）
+
+    struct Hit {
+        float distance;   // 垂直距离（不是真实距离，避免鱼眼效果）
+        int side;         // 碰到的墙的方向（0=垂直墙/东西方向, 1=水平墙/南北方向）
+        int mapX, mapY;   // 碰到的墙所在的格子
+        float wallX;      // 击中点在墙面上的位置 [0, 1)
+    };
+
+    /**
+     * 屏幕第 column 列在相机平面上的位置：-1 = 最左边, 0 = 中间, 1 = 最右边
+     * 光线方向 = 玩家朝向 + 相机平面 × cameraX
+     */
+    inline float cameraX(int column, int screenWidth) {
+        return 2.0f * column / static_cast<float>(screenWidth) - 1.0f;
+    }
+
+    /**
+     * DDA 停下之后：由击中的格子和墙面方向算出垂直距离和击中点
+     * （标量和 SIMD 版本共用，保证两者结果逐位相同）
+     */
+    inline Hit makeHit(float posX, float posY, float rayDirX, float rayDirY, int mapX, int mapY, int side) {
+        int stepX = (rayDirX < 0) ? -1 : 1;
+        int stepY = (rayDirY < 0) ? -1 : 1;
+
+        Hit hit;
+        hit.side = side;
+        hit.mapX = mapX;
+        hit.mapY = mapY;
+
+        // 使用垂直距离，而不是真实距离（避免图像边缘的扭曲）
+        if (side == 0) {
+            hit.distance = (mapX - posX + (1 - stepX) / 2) / rayDirX;
+        } else {
+            hit.distance = (mapY - posY + (1 - stepY) / 2) / rayDirY;
+        }
+        if (hit.distance < MIN_DISTANCE) {
+            hit.distance = MIN_DISTANCE;
+        }
+
+        // 击中点的精确位置，只保留小数部分
+        float wallX = (side == 0) ? posY + hit.distance * rayDirY : posX + hit.distance * rayDirX;
+        hit.wallX = wallX - std::floor(wallX);
+        return hit;
+    }
+
+    /**
+     * 从 (posX, posY) 沿 (rayDirX, rayDirY) 前进，直到碰到墙
+     * 边界外一律视为墙，所以光线一定会停下
+     */
+    inline Hit cast(const WallBitmap& walls, float posX, float posY, float rayDirX, float rayDirY) {
+        // 玩家当前所在的地图格子
+        int mapX = static_cast<int>(posX);
+        int mapY = static_cast<int>(posY);
+
+        // 光线每前进1格在X/Y方向上移动的距离：1 / cos(angle)
+        float deltaDistX = (rayDirX == 0) ? 1e30f : std::abs(1.0f / rayDirX);
+        float deltaDistY = (rayDirY == 0) ? 1e30f : std::abs(1.0f / rayDirY);
+
+        // 步进方向（-1 或 +1）和到下一个格子边界的距离
+        int stepX, stepY;
+        float sideDistX, sideDistY;
+
+        if (rayDirX < 0) {
+            stepX = -1;
+            sideDistX = (posX - mapX) * deltaDistX;
+        } else {
+            stepX = 1;
+            sideDistX = (mapX + 1.0f - posX) * deltaDistX;
+        }
+
+        if (rayDirY < 0) {
+            stepY = -1;
+            sideDistY = (posY - mapY) * deltaDistY;
+        } else {
+            stepY = 1;
+            sideDistY = (mapY + 1.0f - posY) * deltaDistY;
+        }
+
+        // DDA：每次选择距离更近的边界前进，直到碰到墙
+        int side = 0;
+        do {
+            if (sideDistX < sideDistY) {
+                sideDistX += deltaDistX;
+                mapX += stepX;
+                side = 0;
+            } else {
+                sideDistY += deltaDistY;
+                mapY += stepY;
+                side = 1;
+            }
+        } while (!walls.test(mapX, mapY));
+
+        return makeHit(posX, posY, rayDirX, rayDirY, mapX, mapY, side);
+    }
+}
@@ -0,0 +1,42 @@
+#include "RayCastBatch.h"
+
+namespace {
+
+    void castColumnsScalar(const WallBitmap& walls, float posX, float posY,
+                           float dirX, float dirY, float planeX, float planeY,
+                           int screenWidth, int firstColumn, int count, RayCast::Hit* hits) {
+        for (int i = 0; i < count; i++) {
+            float cameraX = RayCast::cameraX(firstColumn + i, screenWidth);
+            hits[i] = RayCast::cast(walls, posX, posY, dirX + planeX * cameraX, dirY + planeY * cameraX);
+        }
+    }
+}
+
+namespace RayCastBatch {
+
+    void castColumns(const WallBitmap& walls, float posX, float posY,
+                     float dirX, float dirY, float planeX, float planeY,
+                     int screenWidth, int firstColumn, int count, RayCast::Hit* hits) {
+        // SSE2 没有 gather，逐通道取位的开销抵消了同步步进的收益（和逐列投射差不多），
+        // 所以默认只在有 AVX2 时使用SIMD
+        Isa isa = (CpuFeatures::detectIsa() == Isa::AVX2) ? Isa::AVX2 : Isa::Scalar;
+        castColumns(isa, walls, posX, posY, dirX, dirY, planeX, planeY, screenWidth, firstColumn, count, hits);
+    }
+
+    void castColumns(Isa isa, const WallBitmap& walls, float posX, float posY,
+                     float dirX, float dirY, float planeX, float planeY,
+                     int screenWidth, int firstColumn, int count, RayCast::Hit* hits) {
+        // 不能超过CPU实际支持的指令集
+        if (static_cast<int>(isa) > static_cast<int>(CpuFeatures::detectIsa())) {
+            isa = CpuFeatures::detectIsa();
+        }
+
+        if (isa == Isa::Scalar) {
+            castColumnsScalar(walls, posX, posY, dirX, dirY, planeX, planeY, screenWidth, firstColumn, count, hits);
+        } else if (isa == Isa::AVX2) {
+            detail::castColumnsAVX2(walls, posX, posY, dirX, dirY, planeX, planeY, screenWidth, firstColumn, count, hits);
+        } else {
+            detail::castColumnsSSE2(walls, posX, posY, dirX, dirY, planeX, planeY, screenWidth, firstColumn, count, hits);
+        }
+    }
+}
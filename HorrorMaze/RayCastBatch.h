@@ -0,0 +1,53 @@
+#pragma once
+#include <cstddef>
+#include "CpuFeatures.h"
+#include "RayCast.h"
+#include "WallBitmap.h"
+
+/**
+ * RayCastBatch：相邻屏幕列的光线成组求交（SIMD 包）
+ *
+ * 同一帧的光线起点相同、方向随列号线性变化，相邻列的 DDA 步数也差不多。
+ * 这里把一组相邻列放进 SIMD 的各个通道同步步进：
+ *
+ *   AVX2  - 8 通道，sideDist/deltaDist/格子坐标都在向量寄存器里，用 gather 从位图取墙体位
+ *   SSE2  - 4 通道同步步进，逐通道取位（和标量版本差不多快，默认不选，只用于测量）
+ *   Scalar - 逐列调用 RayCast::cast（非x86平台或不支持SIMD时）
+ *
+ * 碰到墙（或走出地图）的通道被屏蔽、不再前进，整组都停下后
+ * 用 RayCast::makeHit 算距离和击中点。浮点运算的顺序和 RayCast::cast 完全相同，
+ * 结果逐位一致（HorrorMazeKernelBench 会校验）。
+ * 按 CpuFeatures 检测到的指令集选择实现。
+ */
+namespace RayCastBatch {
+
+    using Isa = CpuFeatures::Isa;
+
+    /**
+     * 投射屏幕第 firstColumn ~ firstColumn + count - 1 列的光线
+     *
+     * 第 x 列的方向 = (dirX, dirY) + (planeX, planeY) × RayCast::cameraX(x, screenWidth)，
+     * 和 Renderer 逐列投射时相同。
+     *
+     * @param hits 输出：每列一个结果（hits[0] 对应 firstColumn）
+     * 有 AVX2 时使用8通道版本，否则逐列投射。
+     */
+    void castColumns(const WallBitmap& walls, float posX, float posY,
+                     float dirX, float dirY, float planeX, float planeY,
+                     int screenWidth, int firstColumn, int count, RayCast::Hit* hits);
+
+    // 指定实现（基准测试和校验用；CPU不支持时自动退回标量版本）
+    void castColumns(Isa isa, const WallBitmap& walls, float posX, float posY,
+                     float dirX, float dirY, float planeX, float planeY,
+                     int screenWidth, int firstColumn, int count, RayCast::Hit* hits);
+
+    namespace detail {
+        // 各实现（RayCastBatchSimd.cpp）
+        void castColumnsSSE2(const WallBitmap& walls, float posX, float posY,
+                             float dirX, float dirY, float planeX, float planeY,
+                             int screenWidth, int firstColumn, int count, RayCast::Hit* hits);
+        void castColumnsAVX2(const WallBitmap& walls, float posX, float posY,
+                             float dirX, float dirY, float planeX, float planeY,
+                             int screenWidth, int firstColumn, int count, RayCast::Hit* hits);
+    }
+}
@@ -0,0 +1,279 @@
+#include "RayCastBatch.h"
+#include "SimdTarget.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * RayCastBatch 的 SSE2 / AVX2 实现（编译方式见 SimdTarget.h）
+ *
+ * 每个通道的状态和 RayCast::cast 的局部变量一一对应：
+ *   sideDistX/Y   到下一条格子边界的距离
+ *   deltaDistX/Y  每前进一格增加的距离
+ *   mapX/Y        当前格子（AVX2 另外维护 rowOff = mapY 行在位图中的32位字下标）
+ *   stepX/Y       -1 或 +1
+ *   side          最后一步跨过的是竖直边界（0）还是水平边界（1）
+ * 每一轮所有未停下的通道前进一格，再检查新格子是不是墙；
+ * 比较、加法的顺序和标量版本相同，所以每个通道走过的格子完全一样。
+ */
+
+namespace RayCastBatch {
+namespace detail {
+
+#if SIMD_X86
+
+    namespace {
+
+        // 向量结果写回每列的 Hit（只写前 lanes 个通道）
+        template <int Width, typename FloatVec, typename IntVec>
+        inline void storeHits(int lanes, const FloatVec& distance, const FloatVec& wallX,
+                              const IntVec& mapX, const IntVec& mapY, const IntVec& side, RayCast::Hit* hits) {
+            float outDistance[Width], outWallX[Width];
+            int outMapX[Width], outMapY[Width], outSide[Width];
+            std::memcpy(outDistance, &distance, sizeof(outDistance));
+            std::memcpy(outWallX, &wallX, sizeof(outWallX));
+            std::memcpy(outMapX, &mapX, sizeof(outMapX));
+            std::memcpy(outMapY, &mapY, sizeof(outMapY));
+            std::memcpy(outSide, &side, sizeof(outSide));
+            for (int lane = 0; lane < lanes; lane++) {
+                RayCast::Hit& hit = hits[lane];
+                hit.distance = outDistance[lane];
+                hit.side = outSide[lane];
+                hit.mapX = outMapX[lane];
+                hit.mapY = outMapY[lane];
+                hit.wallX = outWallX[lane];
+            }
+        }
+
+        // ===================== SSE2：4 通道 =====================
+
+        SIMD_TARGET_SSE2
+        inline __m128i select128(__m128i mask, __m128i a, __m128i b) {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        SIMD_TARGET_SSE2
+        inline __m128 select128(__m128 mask, __m128 a, __m128 b) {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+
+        SIMD_TARGET_SSE2
+        void castPacketSSE2(const WallBitmap& walls, float posX, float posY,
+                            float dirX, float dirY, float planeX, float planeY,
+                            int screenWidth, int firstColumn, int lanes, RayCast::Hit* hits) {
+            const int startX = static_cast<int>(posX);
+            const int startY = static_cast<int>(posY);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 vposX = _mm_set1_ps(posX);
+            const __m128 vposY = _mm_set1_ps(posY);
+            const __m128 vmapXf = _mm_set1_ps(static_cast<float>(startX));
+            const __m128 vmapYf = _mm_set1_ps(static_cast<float>(startY));
+
+            // 光线方向：cameraX = 2 * x / 屏幕宽度 - 1
+            __m128i columns = _mm_add_epi32(_mm_set1_epi32(firstColumn), _mm_set_epi32(3, 2, 1, 0));
+            __m128 cameraX = _mm_sub_ps(_mm_div_ps(_mm_mul_ps(_mm_set1_ps(2.0f), _mm_cvtepi32_ps(columns)),
+                                                   _mm_set1_ps(static_cast<float>(screenWidth))), one);
+            __m128 rayDirX = _mm_add_ps(_mm_set1_ps(dirX), _mm_mul_ps(_mm_set1_ps(planeX), cameraX));
+            __m128 rayDirY = _mm_add_ps(_mm_set1_ps(dirY), _mm_mul_ps(_mm_set1_ps(planeY), cameraX));
+
+            const __m128 huge = _mm_set1_ps(1e30f);
+            __m128 deltaX = select128(_mm_cmpeq_ps(rayDirX, zero), huge, _mm_andnot_ps(signMask, _mm_div_ps(one, rayDirX)));
+            __m128 deltaY = select128(_mm_cmpeq_ps(rayDirY, zero), huge, _mm_andnot_ps(signMask, _mm_div_ps(one, rayDirY)));
+
+            __m128 negX = _mm_cmplt_ps(rayDirX, zero);
+            __m128 negY = _mm_cmplt_ps(rayDirY, zero);
+            __m128 sideDistX = select128(negX, _mm_mul_ps(_mm_sub_ps(vposX, vmapXf), deltaX),
+                                         _mm_mul_ps(_mm_sub_ps(_mm_add_ps(vmapXf, one), vposX), deltaX));
+            __m128 sideDistY = select128(negY, _mm_mul_ps(_mm_sub_ps(vposY, vmapYf), deltaY),
+                                         _mm_mul_ps(_mm_sub_ps(_mm_add_ps(vmapYf, one), vposY), deltaY));
+            const __m128i oneI = _mm_set1_epi32(1);
+            const __m128i minusOne = _mm_set1_epi32(-1);
+            const __m128i stepX = select128(_mm_castps_si128(negX), minusOne, oneI);
+            const __m128i stepY = select128(_mm_castps_si128(negY), minusOne, oneI);
+            const int stride32 = walls.getStride() * 2;
+            const __m128i rowStep = select128(_mm_castps_si128(negY), _mm_set1_epi32(-stride32), _mm_set1_epi32(stride32));
+            const __m128i width = _mm_set1_epi32(walls.getWidth());
+            const __m128i height = _mm_set1_epi32(walls.getHeight());
+            const std::uint32_t* base = reinterpret_cast<const std::uint32_t*>(walls.data());
+
+            __m128i mapX = _mm_set1_epi32(startX);
+            __m128i mapY = _mm_set1_epi32(startY);
+            __m128i rowOff = _mm_set1_epi32(startY * stride32);
+            __m128i side = _mm_setzero_si128();
+            __m128i active = _mm_cmpgt_epi32(_mm_set1_epi32(lanes), _mm_set_epi32(3, 2, 1, 0));
+
+            alignas(16) int index[4], shift[4], fetch[4], bits[4];
+            while (_mm_movemask_epi8(active) != 0) {
+                // 前进一格：sideDistX < sideDistY 的通道走X，其余走Y
+                __m128i xm = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(sideDistX, sideDistY)), active);
+                __m128i ym = _mm_andnot_si128(xm, active);
+                sideDistX = select128(_mm_castsi128_ps(xm), _mm_add_ps(sideDistX, deltaX), sideDistX);
+                sideDistY = select128(_mm_castsi128_ps(ym), _mm_add_ps(sideDistY, deltaY), sideDistY);
+                mapX = _mm_add_epi32(mapX, _mm_and_si128(stepX, xm));
+                mapY = _mm_add_epi32(mapY, _mm_and_si128(stepY, ym));
+                rowOff = _mm_add_epi32(rowOff, _mm_and_si128(rowStep, ym));
+                side = select128(xm, _mm_setzero_si128(), select128(ym, oneI, side));
+
+                // SSE2 没有 gather：下标和位移量用向量算好，逐通道取位；地图外视为墙（不访问内存）
+                __m128i inBounds = _mm_and_si128(
+                    _mm_and_si128(_mm_cmpgt_epi32(mapX, minusOne), _mm_cmpgt_epi32(width, mapX)),
+                    _mm_and_si128(_mm_cmpgt_epi32(mapY, minusOne), _mm_cmpgt_epi32(height, mapY)));
+                _mm_store_si128(reinterpret_cast<__m128i*>(index), _mm_add_epi32(rowOff, _mm_srai_epi32(mapX, 5)));
+                _mm_store_si128(reinterpret_cast<__m128i*>(shift), _mm_and_si128(mapX, _mm_set1_epi32(31)));
+                _mm_store_si128(reinterpret_cast<__m128i*>(fetch), _mm_and_si128(inBounds, active));
+                for (int lane = 0; lane < 4; lane++) {
+                    bits[lane] = fetch[lane] ? static_cast<int>((base[index[lane]] >> shift[lane]) & 1u) : 0;
+                }
+                __m128i hit = _mm_or_si128(_mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(bits)), oneI),
+                                           _mm_xor_si128(inBounds, minusOne));
+                active = _mm_andnot_si128(hit, active);
+            }
+
+            // 垂直距离和击中点：运算顺序和 RayCast::makeHit 相同
+            __m128 distX = _mm_div_ps(_mm_add_ps(_mm_sub_ps(_mm_cvtepi32_ps(mapX), vposX), _mm_and_ps(negX, one)), rayDirX);
+            __m128 distY = _mm_div_ps(_mm_add_ps(_mm_sub_ps(_mm_cvtepi32_ps(mapY), vposY), _mm_and_ps(negY, one)), rayDirY);
+            __m128 sideY = _mm_castsi128_ps(_mm_cmpeq_epi32(side, oneI));
+            __m128 distance = select128(sideY, distY, distX);
+            const __m128 minDistance = _mm_set1_ps(RayCast::MIN_DISTANCE);
+            distance = select128(_mm_cmplt_ps(distance, minDistance), minDistance, distance);
+            __m128 wallX = select128(sideY, _mm_add_ps(vposX, _mm_mul_ps(distance, rayDirX)),
+                                     _mm_add_ps(vposY, _mm_mul_ps(distance, rayDirY)));
+            // SSE2 没有 floor：截断后对负数减1（地图坐标远小于 2^31，截断是精确的）
+            __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(wallX));
+            __m128 floored = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, wallX), one));
+            wallX = _mm_sub_ps(wallX, floored);
+
+            storeHits<4>(lanes, distance, wallX, mapX, mapY, side, hits);
+        }
+
+        // ===================== AVX2：8 通道 =====================
+
+        SIMD_TARGET_AVX2
+        void castPacketAVX2(const WallBitmap& walls, float posX, float posY,
+                            float dirX, float dirY, float planeX, float planeY,
+                            int screenWidth, int firstColumn, int lanes, RayCast::Hit* hits) {
+            // 位图按64位字存储；x86是小端，第 x 位就在第 x/32 个32位字的第 x%32 位
+            const int* base = reinterpret_cast<const int*>(walls.data());
+            const int stride32 = walls.getStride() * 2;
+            const __m256i width = _mm256_set1_epi32(walls.getWidth());
+            const __m256i height = _mm256_set1_epi32(walls.getHeight());
+            const __m256i minusOne = _mm256_set1_epi32(-1);
+            const __m256i oneI = _mm256_set1_epi32(1);
+
+            const int startX = static_cast<int>(posX);
+            const int startY = static_cast<int>(posY);
+            const __m256 zero = _mm256_setzero_ps();
+            const __m256 one = _mm256_set1_ps(1.0f);
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            const __m256 vposX = _mm256_set1_ps(posX);
+            const __m256 vposY = _mm256_set1_ps(posY);
+            const __m256 vmapXf = _mm256_set1_ps(static_cast<float>(startX));
+            const __m256 vmapYf = _mm256_set1_ps(static_cast<float>(startY));
+            const __m256i laneIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+            // 光线方向：cameraX = 2 * x / 屏幕宽度 - 1
+            __m256i columns = _mm256_add_epi32(_mm256_set1_epi32(firstColumn), laneIndex);
+            __m256 cameraX = _mm256_sub_ps(_mm256_div_ps(_mm256_mul_ps(_mm256_set1_ps(2.0f), _mm256_cvtepi32_ps(columns)),
+                                                         _mm256_set1_ps(static_cast<float>(screenWidth))), one);
+            __m256 rayDirX = _mm256_add_ps(_mm256_set1_ps(dirX), _mm256_mul_ps(_mm256_set1_ps(planeX), cameraX));
+            __m256 rayDirY = _mm256_add_ps(_mm256_set1_ps(dirY), _mm256_mul_ps(_mm256_set1_ps(planeY), cameraX));
+
+            const __m256 huge = _mm256_set1_ps(1e30f);
+            __m256 deltaX = _mm256_blendv_ps(_mm256_andnot_ps(signMask, _mm256_div_ps(one, rayDirX)), huge,
+                                             _mm256_cmp_ps(rayDirX, zero, _CMP_EQ_OQ));
+            __m256 deltaY = _mm256_blendv_ps(_mm256_andnot_ps(signMask, _mm256_div_ps(one, rayDirY)), huge,
+                                             _mm256_cmp_ps(rayDirY, zero, _CMP_EQ_OQ));
+
+            __m256 negX = _mm256_cmp_ps(rayDirX, zero, _CMP_LT_OQ);
+            __m256 negY = _mm256_cmp_ps(rayDirY, zero, _CMP_LT_OQ);
+            __m256 sideDistX = _mm256_blendv_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(vmapXf, one), vposX), deltaX),
+                                                _mm256_mul_ps(_mm256_sub_ps(vposX, vmapXf), deltaX), negX);
+            __m256 sideDistY = _mm256_blendv_ps(_mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(vmapYf, one), vposY), deltaY),
+                                                _mm256_mul_ps(_mm256_sub_ps(vposY, vmapYf), deltaY), negY);
+            // 负方向的掩码是 -1：step = mask | 1，rowStep = mask ? -stride : stride
+            const __m256i stepX = _mm256_or_si256(_mm256_castps_si256(negX), oneI);
+            const __m256i stepY = _mm256_or_si256(_mm256_castps_si256(negY), oneI);
+            const __m256i rowStep = _mm256_mullo_epi32(stepY, _mm256_set1_epi32(stride32));
+
+            __m256i mapX = _mm256_set1_epi32(startX);
+            __m256i mapY = _mm256_set1_epi32(startY);
+            __m256i rowOff = _mm256_set1_epi32(startY * stride32);
+            __m256i side = _mm256_setzero_si256();
+            __m256i active = _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), laneIndex);
+
+            while (_mm256_movemask_epi8(active) != 0) {
+                // 前进一格：sideDistX < sideDistY 的通道走X，其余走Y
+                __m256i xm = _mm256_and_si256(_mm256_castps_si256(_mm256_cmp_ps(sideDistX, sideDistY, _CMP_LT_OQ)), active);
+                __m256i ym = _mm256_andnot_si256(xm, active);
+                sideDistX = _mm256_blendv_ps(sideDistX, _mm256_add_ps(sideDistX, deltaX), _mm256_castsi256_ps(xm));
+                sideDistY = _mm256_blendv_ps(sideDistY, _mm256_add_ps(sideDistY, deltaY), _mm256_castsi256_ps(ym));
+                mapX = _mm256_add_epi32(mapX, _mm256_and_si256(stepX, xm));
+                mapY = _mm256_add_epi32(mapY, _mm256_and_si256(stepY, ym));
+                rowOff = _mm256_add_epi32(rowOff, _mm256_and_si256(rowStep, ym));
+                side = _mm256_blendv_epi8(_mm256_blendv_epi8(side, oneI, ym), _mm256_setzero_si256(), xm);
+
+                // 地图内的通道 gather 墙体位；地图外视为墙（不访问内存）
+                __m256i inBounds = _mm256_and_si256(
+                    _mm256_and_si256(_mm256_cmpgt_epi32(mapX, minusOne), _mm256_cmpgt_epi32(width, mapX)),
+                    _mm256_and_si256(_mm256_cmpgt_epi32(mapY, minusOne), _mm256_cmpgt_epi32(height, mapY)));
+                __m256i index = _mm256_add_epi32(rowOff, _mm256_srai_epi32(mapX, 5));
+                __m256i word = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), base, index,
+                                                           _mm256_and_si256(inBounds, active), 4);
+                __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(word, _mm256_and_si256(mapX, _mm256_set1_epi32(31))), oneI);
+                __m256i hit = _mm256_or_si256(_mm256_cmpeq_epi32(bit, oneI), _mm256_xor_si256(inBounds, minusOne));
+                active = _mm256_andnot_si256(hit, active);
+            }
+
+            // 垂直距离和击中点：运算顺序和 RayCast::makeHit 相同
+            __m256 distX = _mm256_div_ps(_mm256_add_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(mapX), vposX),
+                                                       _mm256_and_ps(negX, one)), rayDirX);
+            __m256 distY = _mm256_div_ps(_mm256_add_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(mapY), vposY),
+                                                       _mm256_and_ps(negY, one)), rayDirY);
+            __m256 sideY = _mm256_castsi256_ps(_mm256_cmpeq_epi32(side, oneI));
+            __m256 distance = _mm256_blendv_ps(distX, distY, sideY);
+            const __m256 minDistance = _mm256_set1_ps(RayCast::MIN_DISTANCE);
+            distance = _mm256_blendv_ps(distance, minDistance, _mm256_cmp_ps(distance, minDistance, _CMP_LT_OQ));
+            __m256 wallX = _mm256_blendv_ps(_mm256_add_ps(vposY, _mm256_mul_ps(distance, rayDirY)),
+                                            _mm256_add_ps(vposX, _mm256_mul_ps(distance, rayDirX)), sideY);
+            wallX = _mm256_sub_ps(wallX, _mm256_floor_ps(wallX));
+
+            storeHits<8>(lanes, distance, wallX, mapX, mapY, side, hits);
+        }
+
+        // 按包宽分组；最后不满一组时多余的通道从一开始就是停下的
+        template <int Width, typename Packet>
+        void forEachPacket(const WallBitmap& walls, float posX, float posY,
+                           float dirX, float dirY, float planeX, float planeY,
+                           int screenWidth, int firstColumn, int count, RayCast::Hit* hits, Packet packet) {
+            for (int i = 0; i < count; i += Width) {
+                packet(walls, posX, posY, dirX, dirY, planeX, planeY, screenWidth,
+                       firstColumn + i, std::min(Width, count - i), hits + i);
+            }
+        }
+    }
+
+    void castColumnsSSE2(const WallBitmap& walls, float posX, float posY,
+                         float dirX, float dirY, float planeX, float planeY,
+                         int screenWidth, int firstColumn, int count, RayCast::Hit* hits) {
+        forEachPacket<4>(walls, posX, posY, dirX, dirY, planeX, planeY, screenWidth, firstColumn, count, hits,
+                         castPacketSSE2);
+    }
+
+    void castColumnsAVX2(const WallBitmap& walls, float posX, float posY,
+                         float dirX, float dirY, float planeX, float planeY,
+                         int screenWidth, int firstColumn, int count, RayCast::Hit* hits) {
+        forEachPacket<8>(walls, posX, posY, dirX, dirY, planeX, planeY, screenWidth, firstColumn, count, hits,
+                         castPacketAVX2);
+    }
+
+#else  // 非x86平台：只有标量版本
+
+    void castColumnsSSE2(const WallBitmap&, float, float, float, float, float, float, int, int, int, RayCast::Hit*) {}
+    void castColumnsAVX2(const WallBitmap&, float, float, float, float, float, float, int, int, int, RayCast::Hit*) {}
+
+#endif
+
+}
+}
@@ -1,18 +1,107 @@
 #include "Renderer.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include "RayCastBatch.h"
 #include <cmath>
 #include <cstdint>
-#include <iostream>
+#include <cstring>
 #include <algorithm>
 #include <vector>
 #include <string>
 #include <stdexcept>
 
+namespace {
+
+    // sf::Image 的 RGBA 字节直接就是 Framebuffer 的打包格式
+    PackedTexture packImage(const sf::Image& image) {
+        PackedTexture texture;
+        texture.width = static_cast<int>(image.getSize().x);
+        texture.height = static_cast<int>(image.getSize().y);
+        texture.texels.resize(static_cast<std::size_t>(texture.width) * texture.height);
+        std::memcpy(texture.texels.data(), image.getPixelsPtr(), texture.texels.size() * sizeof(std::uint32_t));
+        return texture;
+    }
+
+    /**
+     * 逃生路线光斑：白色实心圆，边缘一像素抗锯齿，圆外透明（颜色由顶点给出）
+     */
+    sf::Image makeSpotImage(unsigned size) {
+        sf::Image image({size, size}, sf::Color::Transparent);
+        float radius = size * 0.5f;
+        for (unsigned y = 0; y < size; y++) {
+            for (unsigned x = 0; x < size; x++) {
+                float dx = x + 0.5f - radius;
+                float dy = y + 0.5f - radius;
+                float coverage = std::max(0.0f, std::min(1.0f, radius - std::sqrt(dx * dx + dy * dy)));
+                image.setPixel({x, y}, sf::Color(255, 255, 255, static_cast<std::uint8_t>(255 * coverage)));
+            }
+        }
+        return image;
+    }
+
+    /**
+     * 闪灵调色的片元着色器：和 ColorGrade::applyRow 相同，按 RGB 高 6 位在二维排布的查找表里取一格，
+     * 再乘上横竖两个方向的晕影因子
+     */
+    const char* const GRADE_FRAGMENT_SHADER = R"(
+        uniform sampler2D scene;
+        uniform sampler2D lut;
+        uniform float vignette;
+
+        void main() {
+            vec2 uv = gl_TexCoord[0].xy;
+            vec3 cell = floor(floor(texture2D(scene, uv).rgb * 255.0 + 0.5) / 4.0);
+            vec2 tile = vec2(mod(cell.b, 8.0), floor(cell.b / 8.0)) * 64.0;
+            vec3 graded = texture2D(lut, (tile + cell.rg + 0.5) / 512.0).rgb;
+
+            vec2 position = uv * 2.0 - 1.0;
+            vec2 falloff = clamp(1.0 - vignette * position * position, 0.0, 1.0);
+            gl_FragColor = vec4(graded * falloff.x * falloff.y, 1.0);
+        }
+    )";
+
+    /**
+     * 按和墙纹理相同的几个目录查找一张可选的纹理
+     */
+    bool loadFloorTexture(const std::string& fileName, PackedTexture& texture) {
+        const std::vector<std::string> directories = {
+            "assets/textures/",
+            "../../assets/textures/",
+            "E:/cs106A data structures/Final_Project/HorrorMazeFinal/assets/textures/"
+        };
+        sf::Image image;
+        for (const auto& directory : directories) {
+            if (image.loadFromFile(directory + fileName) && image.getSize().x > 0 && image.getSize().y > 0) {
+                LOG_INFO("Floor texture loaded from: " << directory << fileName);
+                texture = packImage(image);
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
 Renderer::Renderer(int w, int h)
     : screenWidth(w)
     , screenHeight(h)
     , zBuffer(w, 0.0f)  // 初始化深度缓冲
+    , snowWallBatch(sf::PrimitiveType::Triangles)
+    , exitWallBatch(sf::PrimitiveType::Triangles)
+    , escapeSpotBatch(sf::PrimitiveType::Triangles)
+    , softwareRendering(false)
+    , framebuffer(w, h)
+    , gradeShaderReady(false)
+    , gradeShaderFailed(false)
+    , rayHits(w)
+    , columns(w)
 {
-    std::cout << "Renderer initialized: " << w << "x" << h << std::endl;
+    LOG_INFO("Renderer initialized: " << w << "x" << h << ", ray casting threads: " << rayWorkers.getThreadCount());
+
+    // 墙条合批数组预先分配到整屏（每列6个顶点），之后每帧只 clear/append
+    snowWallBatch.resize(static_cast<std::size_t>(w) * 6);
+    snowWallBatch.clear();
+    exitWallBatch.resize(static_cast<std::size_t>(w) * 6);
+    exitWallBatch.clear();
 
     // 加载雪墙纹理
     std::vector<std::string> texturePaths = {
@@ -24,7 +113,7 @@ Renderer::Renderer(int w, int h)
     bool textureLoaded = false;
     for (const auto& path : texturePaths) {
         if (snowWallImage.loadFromFile(path)) {
-            std::cout << "Snow wall texture loaded from: " << path << std::endl;
+            LOG_INFO("Snow wall texture loaded from: " << path);
             if (snowWallTexture.loadFromImage(snowWallImage)) {
                 textureLoaded = true;
                 break;
@@ -46,7 +135,7 @@ Renderer::Renderer(int w, int h)
     bool exitTextureLoaded = false;
     for (const auto& path : exitTexturePaths) {
         if (exitImage.loadFromFile(path)) {
-            std::cout << "Exit texture loaded from: " << path << std::endl;
+            LOG_INFO("Exit texture loaded from: " << path);
             if (exitTexture.loadFromImage(exitImage)) {
                 exitTextureLoaded = true;
                 break;
@@ -55,11 +144,76 @@ Renderer::Renderer(int w, int h)
     }
 
     if (!exitTextureLoaded) {
-        std::cerr << "WARNING: Exit texture (exit.png) not found! Using default wall texture." << std::endl;
+        LOG_WARN("WARNING: Exit texture (exit.png) not found! Using default wall texture.");
         // 不抛出异常，使用默认墙壁纹理作为备用
         exitTexture = snowWallTexture;
         exitImage = snowWallImage;
     }
+
+    // 逃生路线光斑的圆形纹理（程序生成）
+    if (!spotTexture.loadFromImage(makeSpotImage(64))) {
+        throw std::runtime_error("Failed to create escape path spot texture");
+    }
+    spotTexture.setSmooth(true);
+
+    // 地板/天花板纹理（只有软件渲染用到），缺失时用雪墙纹理
+    PackedTexture snowWallPacked = packImage(snowWallImage);
+    PackedTexture exitPacked = packImage(exitImage);
+    PackedTexture floorPacked;
+    PackedTexture ceilingPacked;
+    if (!loadFloorTexture("snow_floor.png", floorPacked)) {
+        LOG_WARN("Floor texture (snow_floor.png) not found, using the snow wall texture.");
+        floorPacked = snowWallPacked;
+    }
+    if (!loadFloorTexture("snow_ceiling.png", ceilingPacked)) {
+        LOG_WARN("Ceiling texture (snow_ceiling.png) not found, using the snow wall texture.");
+        ceilingPacked = snowWallPacked;
+    }
+
+    // 软件路径：四张纹理共用一个调色板，转成 8 位下标
+    palette.build({&snowWallPacked, &exitPacked, &floorPacked, &ceilingPacked});
+    snowWallIndexed = palette.convert(snowWallPacked);
+    exitIndexed = palette.convert(exitPacked);
+    floorTexture = palette.convert(floorPacked);
+    ceilingTexture = palette.convert(ceilingPacked);
+
+    // 墙的颜色表：每种光照模式 × 每个亮度
+    const int modeCount = static_cast<int>(LightMode::Count);
+    wallColormaps.resize(static_cast<std::size_t>(modeCount) * LIGHT_LEVELS * Palette::SIZE);
+    for (int mode = 0; mode < modeCount; mode++) {
+        for (int level = 0; level < LIGHT_LEVELS; level++) {
+            std::size_t table = static_cast<std::size_t>(mode) * LIGHT_LEVELS + level;
+            palette.buildColormap(Framebuffer::pack(getLightColor(static_cast<LightMode>(mode), level)),
+                                  &wallColormaps[table * Palette::SIZE]);
+        }
+    }
+    LOG_INFO("Software renderer palette: " << palette.size() << " colors, "
+             << modeCount * LIGHT_LEVELS << " wall colormaps");
+
+    // 闪灵视觉的整帧调色
+    colorGrade.build(ColorGrade::spiritVision);
+    colorGrade.setVignette(w, h, VIGNETTE_STRENGTH);
+}
+
+/**
+ * 地平线高度（蹲下时视角下移），限制在屏幕内
+ */
+float Renderer::getHorizon(const Player& player) const {
+    float horizon = screenHeight * 0.5f + player.getCameraOffsetY();
+    if (horizon < 1.0f) {
+        horizon = 1.0f;
+    }
+    if (horizon > screenHeight - 1.0f) {
+        horizon = screenHeight - 1.0f;
+    }
+    return horizon;
+}
+
+void Renderer::setSoftwareRendering(bool enabled) {
+    if (enabled != softwareRendering) {
+        LOG_INFO("First-person renderer: " << (enabled ? "software framebuffer" : "SFML draw calls"));
+    }
+    softwareRendering = enabled;
 }
 
 /**
@@ -68,235 +222,299 @@ Renderer::Renderer(int w, int h)
  * 流程：
  * 1. 绘制天空和地板
  * 2. 使用光线投射绘制墙壁
- * 3. 如果激活闪灵，应用特殊视觉效果
+ * 3. 如果激活闪灵，对整帧调色，再在地板上绘制逃生路径光斑
+ *
+ * 1、2 两步有两条路径：默认天空/地板一次、墙按纹理两次 SFML 绘制；软件渲染时逐像素写进 CPU 帧缓冲，
+ * 整个画面只上传一张纹理、绘制一次。两条路径共用同一组颜色和光线计算，墙画面一致；
+ * 地板和天花板只有软件路径带纹理（SFML 路径是渐变）。
+ * 调色同样有两条路径：软件路径上传前查 CPU 查找表；SFML 路径先画进离屏纹理，再用着色器画一次
+ * （显卡不支持着色器时闪灵期间改走软件路径）。
  */
 void Renderer::renderFirstPerson(sf::RenderWindow& window,
                                  const Player& player,
                                  const Maze& maze,
                                  const std::vector<sf::Vector2i>& escapePath) {
-    bool spiritVisionActive = player.isSpiritVisionActive();
-    float horizon = screenHeight * 0.5f + player.getCameraOffsetY();
-    if (horizon < 1.0f) {
-        horizon = 1.0f;
+    float horizon = getHorizon(player);
+    bool grade = player.isSpiritVisionActive();
+
+    if (softwareRendering || (grade && !prepareGradeShader())) {
+        renderSoftware(window, player, maze, horizon, grade);
+    } else if (grade) {
+        sceneTarget.clear();
+        drawSkyAndFloor(sceneTarget, player, horizon);
+        castRays(sceneTarget, player, maze);
+        sceneTarget.display();
+        presentGraded(window);
+    } else {
+        drawSkyAndFloor(window, player, horizon);
+        castRays(window, player, maze);
     }
-    if (horizon > screenHeight - 1.0f) {
-        horizon = screenHeight - 1.0f;
+
+    if (player.isSpiritVisionActive() && !escapePath.empty()) {
+        drawEscapePathSpots(window, player, horizon, escapePath);
     }
-    int horizonY = static_cast<int>(horizon);
+}
 
-    // 步骤1：绘制天空渐变（上半部分）
-    for (int y = 0; y < horizonY; y++) {
-        float gradient = (horizonY > 0) ? static_cast<float>(y) / horizonY : 0.0f;
+/**
+ * 画出本帧收集的 sprite（鬼、双胞胎）
+ * 在 renderFirstPerson 之后调用：深度缓冲和地平线都是这一帧的
+ */
+void Renderer::renderSprites(sf::RenderWindow& window, const Player& player) {
+    sprites.render(window, player, depthPyramid, screenHeight, getHorizon(player));
+}
 
-        // 正常模式：从深灰 (50, 50, 55) 到更深的灰 (40, 40, 45)
-        // 注意：地平线要和地板衔接（都是黑色）
-        int r = static_cast<int>(50 - gradient * 50);  // 50 → 0
-        int g = static_cast<int>(50 - gradient * 50);  // 50 → 0
-        int b = static_cast<int>(55 - gradient * 55);  // 55 → 0
+/**
+ * 天空第 y 行的颜色（y < horizonY）
+ */
+sf::Color Renderer::getSkyColor(int y, int horizonY) const {
+    float gradient = (horizonY > 0) ? static_cast<float>(y) / horizonY : 0.0f;
 
-        // 闪灵模式：反转颜色 + 添加诡异的暗红色偏色 + 晕影
-        if (spiritVisionActive) {
-            r = 255 - r;
-            g = 255 - g;
-            b = 255 - b;
-
-            // 降低整体亮度（深灰色调）- 和地板一致
-            r = static_cast<int>(r * 0.4f);
-            g = static_cast<int>(g * 0.4f);
-            b = static_cast<int>(b * 0.4f);
-
-            // 添加暗红色偏色（血腥恐怖感）- 和地板一致
-            r = std::min(255, static_cast<int>(r * 1.1f));   // 轻微增强红色
-            g = static_cast<int>(g * 0.5f);   // 中度减弱绿色
-            b = static_cast<int>(b * 0.4f);   // 中度减弱蓝色
-
-            // 轻微增强对比度
-            float contrast = 1.15f;
-            r = static_cast<int>((r - 128) * contrast + 128);
-            g = static_cast<int>((g - 128) * contrast + 128);
-            b = static_cast<int>((b - 128) * contrast + 128);
-
-            // 晕影效果 - 和地板一致
-            float vignette = 1.0f - std::abs(gradient - 0.5f) * 0.3f;
-            r = static_cast<int>(r * vignette);
-            g = static_cast<int>(g * vignette);
-            b = static_cast<int>(b * vignette);
-
-            // 天空额外亮度提升（地平线处=1.0，顶部=1.6倍）
-            float skyBrightness = 1.0f + (1.0f - gradient) * 0.6f;
-            r = static_cast<int>(r * skyBrightness);
-            g = static_cast<int>(g * skyBrightness);
-            b = static_cast<int>(b * skyBrightness);
-
-            r = std::min(255, std::max(0, r));
-            g = std::min(255, std::max(0, g));
-            b = std::min(255, std::max(0, b));
-        }
+    // 正常模式：从深灰 (50, 50, 55) 到更深的灰 (40, 40, 45)
+    // 注意：地平线要和地板衔接（都是黑色）
+    int r = static_cast<int>(50 - gradient * 50);  // 50 → 0
+    int g = static_cast<int>(50 - gradient * 50);  // 50 → 0
+    int b = static_cast<int>(55 - gradient * 55);  // 55 → 0
 
-        sf::RectangleShape skyLine({static_cast<float>(screenWidth), 1.0f});
-        skyLine.setFillColor(sf::Color(r, g, b));
-        skyLine.setPosition({0, static_cast<float>(y)});
-        window.draw(skyLine);
-    }
+    return sf::Color(static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(g), static_cast<std::uint8_t>(b));
+}
 
-    // 步骤2：绘制地板渐变（下半部分）
+/**
+ * 地板第 y 行的颜色（y >= 地平线）
+ */
+sf::Color Renderer::getFloorColor(int y, float horizon, bool lighterOn) const {
     float floorDenom = screenHeight - horizon;
     if (floorDenom < 1.0f) {
         floorDenom = 1.0f;
     }
-    for (int y = horizonY; y < screenHeight; y++) {
-        // distanceFactor: 0（地平线/远）到 1（脚下/近）
-        float distanceFactor = (static_cast<float>(y) - horizon) / floorDenom;
-
-        int r, g, b;
-
-        if (player.isLighterOn()) {
-            // 打火机开启：白色/灰色调（匹配雪墙），近处亮 → 远处黑色
-            if (distanceFactor > 0.6f) {
-                // 近处（distanceFactor > 0.6）：灰白色 (180, 180, 180)
-                float t = (distanceFactor - 0.6f) / 0.4f;
-                r = static_cast<int>(57 + t * 123);   // 57 → 180
-                g = static_cast<int>(55 + t * 125);   // 55 → 180
-                b = static_cast<int>(50 + t * 130);   // 50 → 180
-            } else {
-                // 远处（distanceFactor < 0.6）：黑色 (0, 0, 0) → 深灰色 (57, 55, 50)
-                float t = distanceFactor / 0.6f;
-                r = static_cast<int>(57 * t);
-                g = static_cast<int>(55 * t);
-                b = static_cast<int>(50 * t);
-            }
+    // distanceFactor: 0（地平线/远）到 1（脚下/近）
+    float distanceFactor = (static_cast<float>(y) - horizon) / floorDenom;
+
+    int r, g, b;
+
+    if (lighterOn) {
+        // 打火机开启：白色/灰色调（匹配雪墙），近处亮 → 远处黑色
+        if (distanceFactor > 0.6f) {
+            // 近处（distanceFactor > 0.6）：灰白色 (180, 180, 180)
+            float t = (distanceFactor - 0.6f) / 0.4f;
+            r = static_cast<int>(57 + t * 123);   // 57 → 180
+            g = static_cast<int>(55 + t * 125);   // 55 → 180
+            b = static_cast<int>(50 + t * 130);   // 50 → 180
         } else {
-            // 打火机关闭：近处深灰 → 远处黑色
-            // 近处深灰 (35)，远处黑色 (0)
-            int gray = static_cast<int>(35 * distanceFactor);
-            r = g = b = gray;
+            // 远处（distanceFactor < 0.6）：黑色 (0, 0, 0) → 深灰色 (57, 55, 50)
+            float t = distanceFactor / 0.6f;
+            r = static_cast<int>(57 * t);
+            g = static_cast<int>(55 * t);
+            b = static_cast<int>(50 * t);
         }
+    } else {
+        // 打火机关闭：近处深灰 → 远处黑色
+        // 近处深灰 (35)，远处黑色 (0)
+        int gray = static_cast<int>(35 * distanceFactor);
+        r = g = b = gray;
+    }
+
+    return sf::Color(static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(g), static_cast<std::uint8_t>(b));
+}
+
+/**
+ * 重建天空/地板渐变缓存（地平线、打火机、闪灵任一变化时）
+ *
+ * 渐变只和行有关，整行颜色相同：算一次每行的颜色，
+ * 同时生成 SFML 路径用的网格（每行两个三角形，顶点带颜色）。
+ * 平时站着不动或走路时这三样都不变，每帧只剩一次绘制。
+ */
+void Renderer::updateBackground(const Player& player, float horizon) {
+    bool lighterOn = player.isLighterOn();
+    bool spiritVisionActive = player.isSpiritVisionActive();
+    if (background.valid && background.horizon == horizon &&
+        background.lighterOn == lighterOn && background.spiritVisionActive == spiritVisionActive) {
+        return;
+    }
+    background.valid = true;
+    background.horizon = horizon;
+    background.lighterOn = lighterOn;
+    background.spiritVisionActive = spiritVisionActive;
 
-        // 闪灵模式：反转颜色 + 添加诡异的暗红色偏色 + 边缘晕影
+    int horizonY = static_cast<int>(horizon);
+    background.rowPixels.resize(screenHeight);
+    background.rowDistance.resize(screenHeight);
+    background.colormapsValid = false;
+    background.mesh.setPrimitiveType(sf::PrimitiveType::Triangles);
+    background.mesh.resize(static_cast<std::size_t>(screenHeight) * 6);
+
+    float width = static_cast<float>(screenWidth);
+    for (int y = 0; y < screenHeight; y++) {
+        sf::Color color = (y < horizonY)
+            ? getSkyColor(y, horizonY)
+            : getFloorColor(y, horizon, lighterOn);
+
+        // 闪灵：光照反转（和墙的亮度反转相同，见 castColumn），偏色等在整帧调色时统一做
         if (spiritVisionActive) {
-            r = 255 - r;
-            g = 255 - g;
-            b = 255 - b;
-
-            // 降低整体亮度（深灰色调）
-            r = static_cast<int>(r * 0.4f);
-            g = static_cast<int>(g * 0.4f);
-            b = static_cast<int>(b * 0.4f);
-
-            // 添加暗红色偏色（血腥恐怖感）
-            r = std::min(255, static_cast<int>(r * 1.1f));   // 轻微增强红色
-            g = static_cast<int>(g * 0.5f);   // 中度减弱绿色
-            b = static_cast<int>(b * 0.4f);   // 中度减弱蓝色
-
-            // 轻微增强对比度
-            float contrast = 1.15f;
-            r = static_cast<int>((r - 128) * contrast + 128);
-            g = static_cast<int>((g - 128) * contrast + 128);
-            b = static_cast<int>((b - 128) * contrast + 128);
-
-            // 边缘晕影效果（让边缘更暗）
-            float vignette = 1.0f - std::abs(distanceFactor - 0.5f) * 0.3f;
-            r = static_cast<int>(r * vignette);
-            g = static_cast<int>(g * vignette);
-            b = static_cast<int>(b * vignette);
-
-            r = std::min(255, std::max(0, r));
-            g = std::min(255, std::max(0, g));
-            b = std::min(255, std::max(0, b));
+            color = sf::Color(static_cast<std::uint8_t>(255 - color.r), static_cast<std::uint8_t>(255 - color.g),
+                              static_cast<std::uint8_t>(255 - color.b));
+        }
+        background.rowPixels[y] = Framebuffer::pack(color);
+
+        // 地板/天花板在眼睛下方/上方半格：距离 d 处的墙高 screenHeight / d，
+        // 墙脚（墙顶）离地平线 screenHeight / (2d)，反过来就是这一行的距离（取像素中心）
+        float offset = std::max(0.5f, std::abs(y + 0.5f - horizon));
+        background.rowDistance[y] = 0.5f * screenHeight / offset;
+
+        float top = static_cast<float>(y);
+        float bottom = top + 1.0f;
+        sf::Vertex* row = &background.mesh[static_cast<std::size_t>(y) * 6];
+        row[0].position = {0.0f, top};
+        row[1].position = {width, top};
+        row[2].position = {0.0f, bottom};
+        row[3].position = {0.0f, bottom};
+        row[4].position = {width, top};
+        row[5].position = {width, bottom};
+        for (int i = 0; i < 6; i++) {
+            row[i].color = color;
+        }
+    }
+}
+
+/**
+ * 天空和地板渐变：缓存的网格，一次绘制
+ */
+void Renderer::drawSkyAndFloor(sf::RenderTarget& target, const Player& player, float horizon) {
+    PROFILE_SCOPE(SkyFloor);
+    updateBackground(player, horizon);
+    target.draw(background.mesh);
+}
+
+/**
+ * 闪灵：在地板上绘制荧光蓝路径光斑（被墙挡住的不画）
+ *
+ * 光斑按路径顺序挑选，和已选光斑在屏幕上太近的跳过；
+ * 间距检查用屏幕空间的分桶网格（桶边长 = 最小间距），每个光斑只查周围 3×3 个桶。
+ * 所有光斑是同一张圆形渐隐纹理上的四边形，合成一批、一次绘制。
+ */
+void Renderer::drawEscapePathSpots(sf::RenderWindow& window, const Player& player, float horizon,
+                                   const std::vector<sf::Vector2i>& escapePath) {
+    int horizonY = static_cast<int>(horizon);
+
+    // 获取玩家信息（相机变换的行列式整帧相同）
+    float posX = player.getX();
+    float posY = player.getY();
+    float dirX = player.getDirX();
+    float dirY = player.getDirY();
+    float planeX = player.getPlaneX();
+    float planeY = player.getPlaneY();
+    float invDet = 1.0f / (planeX * dirY - dirX * planeY);
+
+    // 分桶网格覆盖光斑可能出现的范围：x ∈ [0, screenWidth)，y ∈ [horizonY, screenHeight + 50)
+    const int bucketColumns = screenWidth / SPOT_SPACING + 1;
+    const int bucketRows = (screenHeight + 50) / SPOT_SPACING + 1;
+    spotBucketHead.assign(static_cast<std::size_t>(bucketColumns) * bucketRows, -1);
+    spotPositions.clear();
+    spotNext.clear();
+    escapeSpotBatch.clear();
+
+    const float spotTextureSize = static_cast<float>(spotTexture.getSize().x);
+
+    // 遍历所有路径格子
+    for (const auto& pathCell : escapePath) {
+        // 计算路径格子中心相对于玩家的位置，转换到相机空间
+        float relX = pathCell.x + 0.5f - posX;
+        float relY = pathCell.y + 0.5f - posY;
+        float transformX = invDet * (dirY * relX - dirX * relY);
+        float transformY = invDet * (-planeY * relX + planeX * relY);
+
+        // 在前方且距离合理
+        if (transformY <= 0.5f || transformY >= 20.0f) {
+            continue;
+        }
+
+        // 在屏幕上的X位置（屏幕外的不画）
+        int screenX = static_cast<int>((screenWidth / 2) * (1 + transformX / transformY));
+        if (screenX < 0 || screenX >= screenWidth) {
+            continue;
+        }
+
+        // 在屏幕上的Y位置（地板投影，限制在屏幕下半部分）
+        int screenY = static_cast<int>(horizon + (screenHeight / 2.0f) / transformY);
+        if (screenY < horizonY || screenY >= screenHeight + 50) {
+            continue;
+        }
+
+        // 计算光斑大小（近大远小，稍微缩小一点）
+        float spotRadius = (screenHeight / transformY) * 0.15f;
+        spotRadius = std::max(6.0f, std::min(100.0f, spotRadius));
+
+        // === 深度测试：光斑覆盖的所有列都比墙近时才绘制（不会画到近处的墙上）===
+        int spotLeft = std::max(0, screenX - static_cast<int>(spotRadius));
+        int spotRight = std::min(screenWidth - 1, screenX + static_cast<int>(spotRadius));
+        if (!depthPyramid.isVisible(spotLeft, spotRight, transformY)) {
+            continue;
         }
 
-        sf::RectangleShape floorLine({static_cast<float>(screenWidth), 1.0f});
-        floorLine.setFillColor(sf::Color(r, g, b));
-        floorLine.setPosition({0, static_cast<float>(y)});
-        window.draw(floorLine);
-    }
-
-    // 步骤3：光线投射 - 绘制墙壁
-    castRays(window, player, maze, escapePath);
-
-    // 步骤4：如果闪灵激活，在地板上绘制荧光蓝路径光斑
-    if (spiritVisionActive && !escapePath.empty()) {
-        // 获取玩家信息
-        float posX = player.getX();
-        float posY = player.getY();
-        float dirX = player.getDirX();
-        float dirY = player.getDirY();
-        float planeX = player.getPlaneX();
-        float planeY = player.getPlaneY();
-
-        // 用于避免路径标记重叠的已绘制位置集合
-        std::vector<sf::Vector2i> drawnPositions;
-        const int MIN_SPACING = 25;  // 最小间距（像素）
-
-        // 遍历所有路径格子
-        for (const auto& pathCell : escapePath) {
-            // 计算路径格子中心相对于玩家的位置
-            float relX = pathCell.x + 0.5f - posX;
-            float relY = pathCell.y + 0.5f - posY;
-
-            // 转换到相机空间
-            float invDet = 1.0f / (planeX * dirY - dirX * planeY);
-            float transformX = invDet * (dirY * relX - dirX * relY);
-            float transformY = invDet * (-planeY * relX + planeX * relY);
-
-            // 如果在视野内且在前方（距离合理）
-            if (transformY > 0.5f && transformY < 20.0f) {
-                // 计算在屏幕上的X位置
-                int screenX = static_cast<int>((screenWidth / 2) * (1 + transformX / transformY));
-
-                // 检查是否在屏幕范围内
-                if (screenX >= 0 && screenX < screenWidth) {
-                    // === 深度测试：检查是否被墙遮挡 ===
-                    // 只有当路径点比墙更近时才绘制
-                    if (transformY < zBuffer[screenX]) {
-                        // 计算在屏幕上的Y位置（地板投影）
-                        int screenY = static_cast<int>(horizon + (screenHeight / 2.0f) / transformY);
-
-                        // 限制在屏幕下半部分
-                        if (screenY >= horizonY && screenY < screenHeight + 50) {
-                            // === 检查是否与已绘制的标记距离过近 ===
-                            bool tooClose = false;
-                            for (const auto& drawn : drawnPositions) {
-                                int dx = screenX - drawn.x;
-                                int dy = screenY - drawn.y;
-                                if (dx*dx + dy*dy < MIN_SPACING*MIN_SPACING) {
-                                    tooClose = true;
-                                    break;
-                                }
-                            }
-
-                            if (tooClose) {
-                                continue;  // 跳过这个标记
-                            }
-
-                            // 记录这个位置
-                            drawnPositions.push_back({screenX, screenY});
-
-                            // 计算光斑大小（近大远小，稍微缩小一点）
-                            float spotRadius = (screenHeight / transformY) * 0.15f;
-                            spotRadius = std::max(6.0f, std::min(100.0f, spotRadius));
-
-                            // 计算亮度（距离衰减）
-                            float brightness = 1.0f / (1.0f + transformY * 0.15f);
-                            brightness = std::max(0.4f, std::min(1.0f, brightness));
-
-                            // 绘制荧光蓝色光斑（贴地）
-                            sf::CircleShape spot(spotRadius);
-                            spot.setOrigin({spotRadius, spotRadius});
-                            spot.setPosition({static_cast<float>(screenX), static_cast<float>(screenY)});
-
-                            // 荧光蓝色
-                            int r = static_cast<int>(20 * brightness);
-                            int g = std::min(255, static_cast<int>(180 * brightness));
-                            int b = std::min(255, static_cast<int>(255 * brightness));
-
-                            spot.setFillColor(sf::Color(r, g, b, 80));  // 降低透明度
-                            window.draw(spot);  // 使用默认混合（BlendAlpha）
-                        }
+        // === 检查是否与已绘制的标记距离过近（只查周围 3×3 个桶）===
+        int bucketX = screenX / SPOT_SPACING;
+        int bucketY = screenY / SPOT_SPACING;
+        bool tooClose = false;
+        for (int by = std::max(0, bucketY - 1); by <= std::min(bucketRows - 1, bucketY + 1) && !tooClose; by++) {
+            for (int bx = std::max(0, bucketX - 1); bx <= std::min(bucketColumns - 1, bucketX + 1) && !tooClose; bx++) {
+                for (int i = spotBucketHead[by * bucketColumns + bx]; i >= 0; i = spotNext[i]) {
+                    int dx = screenX - spotPositions[i].x;
+                    int dy = screenY - spotPositions[i].y;
+                    if (dx * dx + dy * dy < SPOT_SPACING * SPOT_SPACING) {
+                        tooClose = true;
+                        break;
                     }
                 }
             }
         }
+        if (tooClose) {
+            continue;  // 跳过这个标记
+        }
+
+        // 记录这个位置（挂到所在桶的链表头）
+        int& head = spotBucketHead[bucketY * bucketColumns + bucketX];
+        spotNext.push_back(head);
+        head = static_cast<int>(spotPositions.size());
+        spotPositions.push_back({screenX, screenY});
+
+        // 计算亮度（距离衰减）
+        float brightness = 1.0f / (1.0f + transformY * 0.15f);
+        brightness = std::max(0.4f, std::min(1.0f, brightness));
+
+        // 荧光蓝色（降低透明度），乘上纹理的圆形渐隐
+        int r = static_cast<int>(20 * brightness);
+        int g = std::min(255, static_cast<int>(180 * brightness));
+        int b = std::min(255, static_cast<int>(255 * brightness));
+        sf::Color color(static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(g), static_cast<std::uint8_t>(b), 80);
+
+        // 贴地的四边形（两个三角形）
+        float left = screenX - spotRadius;
+        float right = screenX + spotRadius;
+        float top = screenY - spotRadius;
+        float bottom = screenY + spotRadius;
+        sf::Vertex corners[4];
+        corners[0].position = {left, top};
+        corners[0].texCoords = {0.0f, 0.0f};
+        corners[1].position = {right, top};
+        corners[1].texCoords = {spotTextureSize, 0.0f};
+        corners[2].position = {left, bottom};
+        corners[2].texCoords = {0.0f, spotTextureSize};
+        corners[3].position = {right, bottom};
+        corners[3].texCoords = {spotTextureSize, spotTextureSize};
+        for (sf::Vertex& corner : corners) {
+            corner.color = color;
+        }
+        escapeSpotBatch.append(corners[0]);
+        escapeSpotBatch.append(corners[1]);
+        escapeSpotBatch.append(corners[2]);
+        escapeSpotBatch.append(corners[2]);
+        escapeSpotBatch.append(corners[1]);
+        escapeSpotBatch.append(corners[3]);
+    }
+
+    if (escapeSpotBatch.getVertexCount() > 0) {
+        sf::RenderStates states;
+        states.texture = &spotTexture;
+        window.draw(escapeSpotBatch, states);  // 使用默认混合（BlendAlpha）
     }
 }
 
@@ -308,269 +526,388 @@ void Renderer::renderFirstPerson(sf::RenderWindow& window,
  * - 光线沿着方向前进，直到碰到墙
  * - 根据距离计算墙的高度
  * - 绘制垂直条带
- * - 如果闪灵激活，应用特殊视觉效果
  */
-void Renderer::castRays(sf::RenderWindow& window,
+void Renderer::castRays(sf::RenderTarget& target,
                        const Player& player,
-                       const Maze& maze,
-                       const std::vector<sf::Vector2i>& escapePath) {
-    bool spiritVisionActive = player.isSpiritVisionActive();
-    float horizon = screenHeight * 0.5f + player.getCameraOffsetY();
-    if (horizon < 1.0f) {
-        horizon = 1.0f;
+                       const Maze& maze) {
+    PROFILE_SCOPE(CastRays);
+    float horizon = getHorizon(player);
+
+    snowWallBatch.clear();
+    exitWallBatch.clear();
+
+    // 计算阶段：所有列并行投射光线
+    computeColumns(player, maze, horizon, false);
+
+    // 提交阶段：墙条按纹理追加到对应的合批数组
+    for (int x = 0; x < screenWidth; x++) {
+        const WallColumn& column = columns[x];
+        if (column.drawEnd <= column.drawStart) {
+            continue;
+        }
+        sf::VertexArray& batch = column.isExit ? exitWallBatch : snowWallBatch;
+
+        // 纹理坐标（使用整列纹理）
+        float texLeft = static_cast<float>(column.texX);
+        float texRight = texLeft + 1.0f;
+        float left = static_cast<float>(x);
+        float right = left + 1.0f;
+        float top = static_cast<float>(column.drawStart);
+        float bottom = static_cast<float>(column.drawEnd);
+
+        // 四边形拆成两个三角形（左上、右上、左下 / 左下、右上、右下），顶点颜色是光照
+        sf::Vertex topLeft, topRight, bottomLeft, bottomRight;
+        topLeft.position = {left, top};
+        topLeft.texCoords = {texLeft, column.texTop};
+        topRight.position = {right, top};
+        topRight.texCoords = {texRight, column.texTop};
+        bottomLeft.position = {left, bottom};
+        bottomLeft.texCoords = {texLeft, column.texBottom};
+        bottomRight.position = {right, bottom};
+        bottomRight.texCoords = {texRight, column.texBottom};
+        topLeft.color = topRight.color = bottomLeft.color = bottomRight.color = column.light;
+
+        batch.append(topLeft);
+        batch.append(topRight);
+        batch.append(bottomLeft);
+        batch.append(bottomLeft);
+        batch.append(topRight);
+        batch.append(bottomRight);
     }
-    if (horizon > screenHeight - 1.0f) {
-        horizon = screenHeight - 1.0f;
+
+    // 整层墙两次绘制（墙条互不重叠，纹理半透明时混合结果和逐列绘制相同）
+    if (snowWallBatch.getVertexCount() > 0) {
+        sf::RenderStates states;
+        states.texture = &snowWallTexture;
+        target.draw(snowWallBatch, states);
+    }
+    if (exitWallBatch.getVertexCount() > 0) {
+        sf::RenderStates states;
+        states.texture = &exitTexture;
+        target.draw(exitWallBatch, states);
     }
+}
 
-    // 辅助函数：检查格子是否在逃生路径上
-    auto isInPath = [&escapePath](int x, int y) -> bool {
-        for (const auto& pos : escapePath) {
-            if (pos.x == x && pos.y == y) {
-                return true;
+/**
+ * 光线投射的计算阶段：屏幕列分段交给线程池
+ *
+ * 每段先成组求交（RayCastBatch），再逐列算墙条。
+ * 每列只读玩家、地图和纹理，只写自己的 rayHits[x]、columns[x]、zBuffer[x]（和帧缓冲的第 x 列），
+ * 线程之间没有共享的可写数据，不需要加锁。
+ */
+void Renderer::computeColumns(const Player& player, const Maze& maze, float horizon, bool rasterize) {
+    rayWorkers.parallelFor(screenWidth, COLUMNS_PER_TASK, [&](int begin, int end) {
+        RayCastBatch::castColumns(maze.getWallBitmap(), player.getX(), player.getY(),
+                                  player.getDirX(), player.getDirY(), player.getPlaneX(), player.getPlaneY(),
+                                  screenWidth, begin, end - begin, &rayHits[begin]);
+        for (int x = begin; x < end; x++) {
+            columns[x] = castColumn(x, rayHits[x], player, maze, horizon);
+            if (rasterize) {
+                rasterizeWallColumn(x, columns[x]);
             }
         }
-        return false;
-    };
-    // 获取玩家信息
-    float posX = player.getX();
-    float posY = player.getY();
-    float dirX = player.getDirX();
-    float dirY = player.getDirY();
-    float planeX = player.getPlaneX();
-    float planeY = player.getPlaneY();
+    });
 
-    // 对屏幕的每一列投射一条光线
-    for (int x = 0; x < screenWidth; x++) {
-        // === 1. 计算光线方向 ===
+    // 深度缓冲写完后重建金字塔（sprite 和逃生路线光斑按列段做深度测试）
+    depthPyramid.build(zBuffer);
+}
 
-        // cameraX: 当前列在屏幕上的归一化位置 [-1, 1]
-        // -1 = 屏幕最左边, 0 = 屏幕中间, 1 = 屏幕最右边
-        float cameraX = 2.0f * x / static_cast<float>(screenWidth) - 1.0f;
+/**
+ * 第 x 列的墙条：由求交结果写深度缓冲、算出墙条的屏幕范围、纹理坐标和光照颜色
+ */
+Renderer::WallColumn Renderer::castColumn(int x, const RayCast::Hit& hit, const Player& player, const Maze& maze, float horizon) {
+    bool spiritVisionActive = player.isSpiritVisionActive();
 
-        // 光线方向 = 玩家朝向 + 相机平面 × 位置
-        // 这样可以形成一个扇形的视野
-        float rayDirX = dirX + planeX * cameraX;
-        float rayDirY = dirY + planeY * cameraX;
+    // === 1. 计算光线方向 ===
 
-        // === 2. 初始化DDA变量 ===
+    // cameraX: 当前列在屏幕上的归一化位置 [-1, 1]
+    // -1 = 屏幕最左边, 0 = 屏幕中间, 1 = 屏幕最右边
+    float cameraX = RayCast::cameraX(x, screenWidth);
 
-        // 玩家当前所在的地图格子
-        int mapX = static_cast<int>(posX);
-        int mapY = static_cast<int>(posY);
+    // 光线方向 = 玩家朝向 + 相机平面 × 位置
+    // 这样可以形成一个扇形的视野
+    float rayDirX = player.getDirX() + player.getPlaneX() * cameraX;
+    float rayDirY = player.getDirY() + player.getPlaneY() * cameraX;
 
-        // 光线每前进1格在X/Y方向上移动的距离
-        // 使用三角函数计算：1 / cos(angle)
-        float deltaDistX = (rayDirX == 0) ? 1e30f : std::abs(1.0f / rayDirX);
-        float deltaDistY = (rayDirY == 0) ? 1e30f : std::abs(1.0f / rayDirY);
+    // === 2. DDA求交结果（computeColumns 里成组算好，见 RayCastBatch.h）===
 
-        // 光线前进的方向（-1 或 +1）
-        int stepX, stepY;
+    int side = hit.side;
+    float perpWallDist = hit.distance;
 
-        // 从当前位置到下一个格子边界的距离
-        float sideDistX, sideDistY;
+    // === 记录深度到Z-Buffer（用于sprite深度测试）===
+    zBuffer[x] = perpWallDist;
 
-        // === 3. 计算步进方向和初始边界距离 ===
+    // === 3. 计算墙在屏幕上的高度 ===
 
-        if (rayDirX < 0) {
-            stepX = -1;
-            sideDistX = (posX - mapX) * deltaDistX;
-        } else {
-            stepX = 1;
-            sideDistX = (mapX + 1.0f - posX) * deltaDistX;
-        }
+    WallColumn column;
 
-        if (rayDirY < 0) {
-            stepY = -1;
-            sideDistY = (posY - mapY) * deltaDistY;
-        } else {
-            stepY = 1;
-            sideDistY = (mapY + 1.0f - posY) * deltaDistY;
-        }
+    // 距离越近，墙越高
+    int lineHeight = std::max(1, static_cast<int>(screenHeight / perpWallDist));
+    float wallTop = -lineHeight / 2.0f + horizon;
 
-        // === 4. DDA算法 - 沿光线前进直到碰到墙 ===
-
-        bool hit = false;  // 是否碰到墙
-        int side = 0;      // 碰到的墙的方向（0=垂直墙, 1=水平墙）
-
-        while (!hit) {
-            // 选择距离更近的边界前进
-            if (sideDistX < sideDistY) {
-                sideDistX += deltaDistX;
-                mapX += stepX;
-                side = 0;  // 垂直墙（东西方向）
-            } else {
-                sideDistY += deltaDistY;
-                mapY += stepY;
-                side = 1;  // 水平墙（南北方向）
-            }
+    // 计算墙在屏幕上的起始和结束Y坐标
+    column.drawStart = static_cast<int>(wallTop);
+    if (column.drawStart < 0) column.drawStart = 0;
 
-            // 检查是否碰到墙
-            if (maze.isWall(mapX, mapY)) {
-                hit = true;
-            }
-        }
+    column.drawEnd = static_cast<int>(lineHeight / 2.0f + horizon);
+    if (column.drawEnd >= screenHeight) column.drawEnd = screenHeight - 1;
 
-        // === 5. 计算墙的距离（重要：避免鱼眼效果！）===
+    // === 4. 计算纹理坐标 ===
 
-        // 使用垂直距离，而不是真实距离
-        // 这样可以避免图像边缘的扭曲（鱼眼效果）
-        float perpWallDist;
-        if (side == 0) {
-            perpWallDist = (mapX - posX + (1 - stepX) / 2) / rayDirX;
-        } else {
-            perpWallDist = (mapY - posY + (1 - stepY) / 2) / rayDirY;
-        }
+    // 检查当前墙格子是否是出口（cell value = 2），根据是否是出口选择纹理
+    column.isExit = (maze.getCell(hit.mapX, hit.mapY) == 2);
+    const sf::Image& wallImage = column.isExit ? exitImage : snowWallImage;
 
-        // 避免除以0
-        if (perpWallDist < 0.01f) perpWallDist = 0.01f;
+    // 计算纹理的 X 坐标（光线击中墙的精确位置 wallX 在 0.0 到 1.0 之间）
+    int texWidth = wallImage.getSize().x;
+    int texHeight = wallImage.getSize().y;
+    int texX = std::min(texWidth - 1, static_cast<int>(hit.wallX * texWidth));
+    if ((side == 0 && rayDirX > 0) || (side == 1 && rayDirY < 0)) {
+        texX = texWidth - texX - 1;
+    }
+    column.texX = texX;
 
-        // === 记录深度到Z-Buffer（用于sprite深度测试）===
-        zBuffer[x] = perpWallDist;
+    // 纹理 V 坐标按未裁剪的墙高计算：贴近墙时墙条超出屏幕，只显示纹理的中间一段
+    float texPerPixel = static_cast<float>(texHeight) / lineHeight;
+    column.texTop = std::max(0.0f, (column.drawStart - wallTop) * texPerPixel);
+    column.texBottom = std::min(static_cast<float>(texHeight), (column.drawEnd - wallTop) * texPerPixel);
 
-        // === 6. 计算墙在屏幕上的高度 ===
+    // === 5. 计算光照因子 ===
 
-        // 距离越近，墙越高
-        int lineHeight = static_cast<int>(screenHeight / perpWallDist);
+    float rayAngle = cameraX;  // 光线角度（用于打火机光照）
 
-        // 计算墙在屏幕上的起始和结束Y坐标
-        int drawStart = static_cast<int>(-lineHeight / 2.0f + horizon);
-        if (drawStart < 0) drawStart = 0;
+    // 计算光照亮度（但不应用颜色，让纹理本身的颜色显示）
+    float brightness;
+    if (!player.isLighterOn()) {
+        // 打火机关闭：极暗环境光，远处墙与地面融为一体
+        float ambientLight = 0.08f;   // 降低到 8%
+        float fogFactor = 0.15f;      // 增强雾效果
+        brightness = ambientLight / (1.0f + perpWallDist * fogFactor);
+        brightness = std::max(0.03f, std::min(0.12f, brightness));  // 极暗范围
+    } else {
+        // 打火机开启：降低亮度和范围，匹配地板
+        float distanceFactor = 1.0f / (1.0f + perpWallDist * 0.6f);  // 更快衰减
+        float angleFactor = calculateConeEffect(rayAngle);
+        brightness = distanceFactor * angleFactor;
+        brightness = std::max(0.10f, std::min(0.45f, brightness));  // 降低最大亮度到 45%
+    }
 
-        int drawEnd = static_cast<int>(lineHeight / 2.0f + horizon);
-        if (drawEnd >= screenHeight) drawEnd = screenHeight - 1;
+    // 侧面阴影：水平墙比垂直墙暗一些
+    if (side == 1) {
+        brightness *= 0.75f;
+    }
 
-        // === 7. 计算纹理坐标 ===
+    // 闪灵：黑暗处反而看得清（亮度反转，负片效果）。反转的是光照而不是最终颜色：
+    // 纹理本身的明暗保留下来；直接反相整帧的话，暗处的墙只有几级灰度，反相后糊成一片
+    if (spiritVisionActive) {
+        brightness = 1.0f - brightness;
+    }
 
-        // 检查当前墙格子是否是出口（cell value = 2）
-        bool isExit = (maze.getCell(mapX, mapY) == 2);
+    // === 6. 光照颜色（和纹理颜色相乘）和对应的颜色表 ===
+    // 亮度换算成 0..255 的等级，色调由模式决定（见 getLightColor）；
+    // 闪灵时不加打火机色调，压暗、偏色、对比度、晕影在整帧调色时统一做（见 ColorGrade）
+    LightMode mode = (player.isLighterOn() && !spiritVisionActive) ? LightMode::Lighter : LightMode::Darkness;
+    int level = std::min(LIGHT_LEVELS - 1, std::max(0, static_cast<int>(255 * brightness)));
+    column.light = getLightColor(mode, level);
+    column.colormap = wallColormap(mode, level);
+    return column;
+}
 
-        // 根据是否是出口选择纹理
-        const sf::Image& wallImage = isExit ? exitImage : snowWallImage;
-        const sf::Texture& wallTexture = isExit ? exitTexture : snowWallTexture;
+/**
+ * 光照颜色：灰度 level 按模式加色调
+ * - 黑暗：灰色
+ * - 打火机：微弱的橙黄色调
+ */
+sf::Color Renderer::getLightColor(LightMode mode, int level) {
+    int r = level;
+    int g = level;
+    int b = level;
+
+    // 正常模式且打火机开启时添加微弱的橙黄色调
+    if (mode == LightMode::Lighter) {
+        r = static_cast<int>(r * 1.10f);  // 只稍微增强暖色
+        g = static_cast<int>(g * 1.05f);
+        b = static_cast<int>(b * 0.90f);  // 只稍微减弱蓝色
+    }
 
-        // 计算光线击中墙的精确位置（wallX）
-        float wallX;  // 0.0 到 1.0 之间
-        if (side == 0) {
-            wallX = posY + perpWallDist * rayDirY;
-        } else {
-            wallX = posX + perpWallDist * rayDirX;
-        }
-        wallX -= std::floor(wallX);  // 只保留小数部分
-
-        // 计算纹理的 X 坐标
-        int texWidth = wallImage.getSize().x;
-        int texHeight = wallImage.getSize().y;
-        int texX = static_cast<int>(wallX * texWidth);
-        if ((side == 0 && rayDirX > 0) || (side == 1 && rayDirY < 0)) {
-            texX = texWidth - texX - 1;
-        }
+    r = std::min(255, std::max(0, r));
+    g = std::min(255, std::max(0, g));
+    b = std::min(255, std::max(0, b));
 
-        // === 8. 计算光照因子 ===
+    return sf::Color(static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(g), static_cast<std::uint8_t>(b));
+}
 
-        float rayAngle = cameraX;  // 光线角度（用于打火机光照）
+/**
+ * 软件渲染：天空、地板和墙全部写进帧缓冲（闪灵时再整帧调色），最后一次上传、一次绘制
+ */
+void Renderer::renderSoftware(sf::RenderWindow& window, const Player& player, const Maze& maze, float horizon, bool grade) {
+    {
+        PROFILE_SCOPE(SkyFloor);
+        updateBackground(player, horizon);
+        castFloorAndCeiling(player, horizon);
+    }
 
-        // 计算光照亮度（但不应用颜色，让纹理本身的颜色显示）
-        float brightness;
-        if (!player.isLighterOn()) {
-            // 打火机关闭：极暗环境光，远处墙与地面融为一体
-            float ambientLight = 0.08f;   // 降低到 8%
-            float fogFactor = 0.15f;      // 增强雾效果
-            brightness = ambientLight / (1.0f + perpWallDist * fogFactor);
-            brightness = std::max(0.03f, std::min(0.12f, brightness));  // 极暗范围
-        } else {
-            // 打火机开启：降低亮度和范围，匹配地板
-            float distanceFactor = 1.0f / (1.0f + perpWallDist * 0.6f);  // 更快衰减
-            float angleFactor = calculateConeEffect(rayAngle);
-            brightness = distanceFactor * angleFactor;
-            brightness = std::max(0.10f, std::min(0.45f, brightness));  // 降低最大亮度到 45%
-        }
+    {
+        PROFILE_SCOPE(CastRays);
+        computeColumns(player, maze, horizon, true);
+    }
 
-        // 侧面阴影：水平墙比垂直墙暗一些
-        if (side == 1) {
-            brightness *= 0.75f;
-        }
+    if (grade) {
+        // 各行互不相关，分给光线投射的线程池
+        PROFILE_SCOPE(Grade);
+        rayWorkers.parallelFor(screenHeight, ROWS_PER_TASK, [&](int begin, int end) {
+            for (int y = begin; y < end; y++) {
+                colorGrade.applyRow(framebuffer.row(y), y);
+            }
+        });
+    }
 
-        // 闪灵模式：反转亮度（负片效果）
-        if (spiritVisionActive) {
-            brightness = 1.0f - brightness;
-        }
+    framebuffer.present(window);
+}
 
-        // === 9. 高效渲染纹理墙条（使用 VertexArray 批量绘制）===
+/**
+ * 第一次用到着色器调色时创建着色器、查找表纹理和离屏纹理；
+ * 任何一步失败都记一次警告，之后闪灵改走软件帧缓冲（CPU 查找表）
+ */
+bool Renderer::prepareGradeShader() {
+    if (gradeShaderReady) {
+        return true;
+    }
+    if (gradeShaderFailed) {
+        return false;
+    }
+    gradeShaderFailed = true;
 
-        // 创建顶点数组：4个顶点组成一个四边形
-        sf::VertexArray quad(sf::PrimitiveType::TriangleStrip, 4);
+    if (!sf::Shader::isAvailable()) {
+        LOG_WARN("Shaders are not available, spirit vision falls back to the software framebuffer.");
+        return false;
+    }
+    if (!gradeShader.loadFromMemory(GRADE_FRAGMENT_SHADER, sf::Shader::Type::Fragment)) {
+        LOG_WARN("Cannot compile the spirit vision shader, falling back to the software framebuffer.");
+        return false;
+    }
 
-        // 纹理坐标（使用整列纹理）
-        float texLeft = static_cast<float>(texX);
-        float texRight = texLeft + 1.0f;
+    const unsigned atlasSize = static_cast<unsigned>(ColorGrade::ATLAS_SIZE);
+    if (!gradeLutTexture.resize({atlasSize, atlasSize})) {
+        LOG_WARN("Cannot create the color grading LUT texture, falling back to the software framebuffer.");
+        return false;
+    }
+    std::vector<std::uint32_t> atlas = colorGrade.makeAtlas();
+    gradeLutTexture.update(reinterpret_cast<const std::uint8_t*>(atlas.data()));
 
-        // 设置4个顶点的位置和纹理坐标
-        // 顶点0：左上角
-        quad[0].position = sf::Vector2f(static_cast<float>(x), static_cast<float>(drawStart));
-        quad[0].texCoords = sf::Vector2f(texLeft, 0.0f);
-
-        // 顶点1：右上角
-        quad[1].position = sf::Vector2f(static_cast<float>(x + 1), static_cast<float>(drawStart));
-        quad[1].texCoords = sf::Vector2f(texRight, 0.0f);
-
-        // 顶点2：左下角
-        quad[2].position = sf::Vector2f(static_cast<float>(x), static_cast<float>(drawEnd));
-        quad[2].texCoords = sf::Vector2f(texLeft, static_cast<float>(texHeight));
-
-        // 顶点3：右下角
-        quad[3].position = sf::Vector2f(static_cast<float>(x + 1), static_cast<float>(drawEnd));
-        quad[3].texCoords = sf::Vector2f(texRight, static_cast<float>(texHeight));
-
-        // 计算光照颜色
-        int r = static_cast<int>(255 * brightness);
-        int g = static_cast<int>(255 * brightness);
-        int b = static_cast<int>(255 * brightness);
-
-        // 正常模式且打火机开启时添加微弱的橙黄色调
-        if (!spiritVisionActive && player.isLighterOn()) {
-            r = static_cast<int>(r * 1.10f);  // 只稍微增强暖色
-            g = static_cast<int>(g * 1.05f);
-            b = static_cast<int>(b * 0.90f);  // 只稍微减弱蓝色
-        }
+    if (!sceneTarget.resize({static_cast<unsigned>(screenWidth), static_cast<unsigned>(screenHeight)})) {
+        LOG_WARN("Cannot create the off-screen scene texture, falling back to the software framebuffer.");
+        return false;
+    }
 
-        // 闪灵模式：添加诡异的暗红色偏色 + 降低亮度
-        if (spiritVisionActive) {
-            // 降低整体亮度（深灰色调）
-            r = static_cast<int>(r * 0.6f);
-            g = static_cast<int>(g * 0.6f);
-            b = static_cast<int>(b * 0.6f);
-
-            // 添加暗红色偏色（血腥恐怖感）
-            r = std::min(255, static_cast<int>(r * 1.1f));   // 轻微增强红色
-            g = static_cast<int>(g * 0.5f);   // 中度减弱绿色
-            b = static_cast<int>(b * 0.4f);   // 中度减弱蓝色
-
-            // 轻微增强对比度
-            float contrast = 1.15f;
-            r = static_cast<int>((r - 128) * contrast + 128);
-            g = static_cast<int>((g - 128) * contrast + 128);
-            b = static_cast<int>((b - 128) * contrast + 128);
-        }
+    gradeShader.setUniform("scene", sf::Shader::CurrentTexture);
+    gradeShader.setUniform("lut", gradeLutTexture);
+    gradeShader.setUniform("vignette", colorGrade.getVignetteStrength());
+
+    gradeShaderFailed = false;
+    gradeShaderReady = true;
+    LOG_INFO("Spirit vision color grading: fragment shader");
+    return true;
+}
+
+/**
+ * 离屏纹理上的画面经过调色着色器，画成一个全屏四边形
+ */
+void Renderer::presentGraded(sf::RenderWindow& window) {
+    PROFILE_SCOPE(Grade);
+    sf::Sprite sprite(sceneTarget.getTexture());
+    sf::RenderStates states;
+    states.shader = &gradeShader;
+    window.draw(sprite, states);
+}
+
+/**
+ * 地板和天花板的按行投射
+ *
+ * 第 y 行的水平距离查表（rowDistance），最左、最右两条光线在这个距离上的落点
+ * 确定了这一行的起点和每像素的步长；每行是一个光照等级：调色板乘上原来渐变在这一行的颜色
+ * 得到这一行的颜色表，所以打火机、闪灵下的明暗和色调和渐变一致。各行互不相关，分给光线投射的线程池。
+ */
+void Renderer::castFloorAndCeiling(const Player& player, float horizon) {
+    int horizonY = static_cast<int>(horizon);
+    float rayDirLeftX = player.getDirX() - player.getPlaneX();
+    float rayDirLeftY = player.getDirY() - player.getPlaneY();
+    float spanX = 2.0f * player.getPlaneX() / screenWidth;
+    float spanY = 2.0f * player.getPlaneY() / screenWidth;
+    float posX = player.getX();
+    float posY = player.getY();
 
-        r = std::min(255, std::max(0, r));
-        g = std::min(255, std::max(0, g));
-        b = std::min(255, std::max(0, b));
+    // 渐变重建过以后，每行的颜色表跟着重建（各行互不相关，在同一次并行里顺便做）
+    bool buildColormaps = !background.colormapsValid;
+    if (buildColormaps) {
+        background.rowColormaps.resize(static_cast<std::size_t>(screenHeight) * Palette::SIZE);
+    }
 
-        // 闪灵模式：墙壁不透明（避免地平线分界）
-        int alpha = spiritVisionActive ? 180 : 255;
+    rayWorkers.parallelFor(screenHeight, ROWS_PER_TASK, [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            std::uint32_t* colormap = &background.rowColormaps[static_cast<std::size_t>(y) * Palette::SIZE];
+            if (buildColormaps) {
+                palette.buildColormap(background.rowPixels[y], colormap);
+            }
+
+            float distance = background.rowDistance[y];
+            const IndexedTexture& texture = (y < horizonY) ? ceilingTexture : floorTexture;
+            FloorCast::shadeRow(texture, posX + distance * rayDirLeftX, posY + distance * rayDirLeftY,
+                                distance * spanX, distance * spanY, colormap,
+                                framebuffer.row(y), screenWidth);
+        }
+    });
+    background.colormapsValid = true;
+}
 
-        sf::Color lightColor(r, g, b, alpha);
+/**
+ * 把一条墙写进帧缓冲：按调色板下标查这一列的颜色表，纹素半透明时和已有的天空/地板混合
+ * （颜色表就是纹理颜色 × 光照颜色，和 GPU 路径的顶点颜色调制、BlendAlpha 混合结果相同）
+ */
+void Renderer::rasterizeWallColumn(int x, const WallColumn& column) {
+    int count = column.drawEnd - column.drawStart;
+    if (count <= 0) {
+        return;
+    }
 
-        // 应用光照到所有顶点
-        for (int i = 0; i < 4; i++) {
-            quad[i].color = lightColor;
+    const IndexedTexture& texture = column.isExit ? exitIndexed : snowWallIndexed;
+    const std::uint8_t* texels = texture.indices.data() + column.texX;
+    const int texWidth = texture.width;
+    const int texHeight = texture.height;
+    const std::uint32_t* colormap = column.colormap;
+
+    // 每个像素取其中心对应的纹理行
+    float texStep = (column.texBottom - column.texTop) / count;
+    float texY = column.texTop + texStep * 0.5f;
+
+    // 不透明纹理：每个像素一次查表
+    if (palette.isOpaque()) {
+        for (int y = column.drawStart; y < column.drawEnd; y++, texY += texStep) {
+            int row = std::min(texHeight - 1, std::max(0, static_cast<int>(texY)));
+            framebuffer.row(y)[x] = colormap[texels[static_cast<std::size_t>(row) * texWidth]];
         }
+        return;
+    }
 
-        // 一次性绘制整条墙（只需1次 draw call！）
-        sf::RenderStates states;
-        states.texture = &wallTexture;  // 使用根据出口检测选择的纹理
-        window.draw(quad, states);
+    for (int y = column.drawStart; y < column.drawEnd; y++, texY += texStep) {
+        int row = std::min(texHeight - 1, std::max(0, static_cast<int>(texY)));
+        std::uint8_t src[4];
+        Framebuffer::unpack(colormap[texels[static_cast<std::size_t>(row) * texWidth]], src);
+        int r = src[0];
+        int g = src[1];
+        int b = src[2];
+        int a = src[3];
+
+        std::uint32_t* pixel = framebuffer.row(y) + x;
+        if (a < 255) {
+            std::uint8_t dst[4];
+            Framebuffer::unpack(*pixel, dst);
+            r = (r * a + dst[0] * (255 - a)) / 255;
+            g = (g * a + dst[1] * (255 - a)) / 255;
+            b = (b * a + dst[2] * (255 - a)) / 255;
+        }
+        *pixel = Framebuffer::pack(static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(g),
+                                   static_cast<std::uint8_t>(b));
     }
 }
 
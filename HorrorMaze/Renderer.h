@@ -2,6 +2,16 @@
 #include <SFML/Graphics.hpp>
 #include "Player.h"
 #include "Maze.h"
+#include "ColorGrade.h"
+#include "DepthPyramid.h"
+#include "Framebuffer.h"
+#include "FloorCast.h"
+#include "Palette.h"
+#include "RayCast.h"
+#include "SpriteRenderer.h"
+#include "WorkerPool.h"
+#include <cstdint>
+#include <vector>
 
 /**
  * Renderer类：负责渲染游戏画面
@@ -9,6 +19,23 @@
  * 支持两种渲染模式：
  * 1. 俯视图（TopDown）- 2D视角
  * 2. 第一人称（FirstPerson）- 3D视角（光线投射）
+ *
+ * 第一人称有两条渲染路径（墙、sprite 和光照相同，地板/天花板不同）：
+ * - SFML：天空/地板一个顶点着色网格（渐变），墙按纹理合批（雪墙、出口各一次绘制，默认）
+ * - 软件帧缓冲：整个画面在 CPU 上逐像素写好，上传一张纹理、绘制一次；
+ *   地板和天花板是按行投射的纹理。纹理转成 256 色调色板下标，
+ *   光照事先算进颜色表（每种光照模式 × 每个亮度一张），每个像素只查一次表
+ *
+ * 闪灵视觉不在各个图元里单独着色：天空、地板、墙只是光照反转（暗处变亮），
+ * 压暗、暗红偏色、对比度和晕影在最后整帧做一遍调色（ColorGrade）。
+ * 软件帧缓冲路径在 CPU 上查 3D 查找表；SFML 路径先画进离屏纹理，再用着色器画一个全屏四边形
+ * （显卡不支持着色器时闪灵期间改走软件帧缓冲）。逃生路线光斑和 sprite 在调色之后画，不受影响。
+ *
+ * 鬼、双胞胎等 sprite 每帧先收集进 getSprites()，墙画完后由 renderSprites 统一排序、深度测试、合批绘制；
+ * 深度测试用深度缓冲的分层最小/最大值（DepthPyramid），整段列一次判断。
+ *
+ * 光线投射分两个阶段：计算阶段把屏幕列分段交给常驻线程池并行求交
+ * （每段内相邻列成组用 SIMD 步进，见 RayCastBatch），结果写进每列的墙条缓冲和深度缓冲；提交阶段在渲染线程上按顺序生成顶点并绘制。
  */
 class Renderer {
 public:
@@ -25,8 +52,13 @@ public:
                       const Player& player,
                       const Maze& maze);
 
-    // 获取深度缓冲（用于sprite深度测试）
-    const std::vector<float>& getZBuffer() const { return zBuffer; }
+    // 本帧的 sprite（调用者先 clear 再逐个 add），renderFirstPerson 之后用 renderSprites 画出
+    SpriteRenderer& getSprites() { return sprites; }
+    void renderSprites(sf::RenderWindow& window, const Player& player);
+
+    // 第一人称使用软件帧缓冲（F4 切换，HORRORMAZE_SOFTWARE_RENDER=1 启动时打开）
+    void setSoftwareRendering(bool enabled);
+    bool isSoftwareRendering() const { return softwareRendering; }
 
 private:
     int screenWidth;
@@ -40,14 +72,124 @@ private:
     sf::Texture exitTexture;
     sf::Image exitImage;  // 用于像素级访问
 
+    // 软件路径的调色板纹理：雪墙、出口、地板、天花板共用一个调色板
+    // （地板/天花板纹理缺失时用雪墙纹理代替）
+    Palette palette;
+    IndexedTexture snowWallIndexed;
+    IndexedTexture exitIndexed;
+    IndexedTexture floorTexture;
+    IndexedTexture ceilingTexture;
+
+    // 墙的光照模式：决定亮度到光照颜色的换算（色调），每种模式一组颜色表
+    enum class LightMode { Darkness, Lighter, Count };
+    static constexpr int LIGHT_LEVELS = 256;  // 亮度 0..255（光照颜色换算前的灰度值）
+
+    // 墙的颜色表：[模式][亮度][调色板下标] → 打包颜色（构造时算好，之后只读）
+    std::vector<std::uint32_t> wallColormaps;
+    const std::uint32_t* wallColormap(LightMode mode, int level) const {
+        return &wallColormaps[(static_cast<std::size_t>(mode) * LIGHT_LEVELS + level) * Palette::SIZE];
+    }
+
+    // 某种模式下亮度 level 的光照颜色（SFML 路径的顶点颜色，也是颜色表的乘数）
+    static sf::Color getLightColor(LightMode mode, int level);
+
     // 深度缓冲（Z-Buffer）- 记录每列的墙壁距离
     std::vector<float> zBuffer;
+    DepthPyramid depthPyramid;  // zBuffer 每 8/64/512 列的最小/最大值（整段列的深度测试）
+
+    // 墙条合批：每列的四边形按纹理追加进这两个数组，整层墙两次绘制。
+    // 数组跨帧复用，每帧 clear 后重新追加，容量不变，不再分配内存
+    sf::VertexArray snowWallBatch;
+    sf::VertexArray exitWallBatch;
+
+    // 闪灵逃生路线光斑：圆形纹理上的四边形合成一批；间距检查的屏幕分桶网格（桶内链表，跨帧复用）
+    sf::Texture spotTexture;
+    sf::VertexArray escapeSpotBatch;
+    std::vector<int> spotBucketHead;         // 每个桶第一个光斑的下标，-1 = 空
+    std::vector<int> spotNext;               // 同一个桶里的下一个光斑
+    std::vector<sf::Vector2i> spotPositions; // 已选光斑的屏幕位置
+    static constexpr int SPOT_SPACING = 25;  // 光斑之间的最小间距（像素），也是桶的边长
+
+    // 鬼、双胞胎等 billboard（按距离排序，和深度缓冲比较）
+    SpriteRenderer sprites;
+
+    // 软件渲染
+    bool softwareRendering;
+    Framebuffer framebuffer;
+
+    // 闪灵视觉的整帧调色：CPU 查找表（软件路径），以及 SFML 路径的着色器和离屏纹理（第一次用到时创建）
+    ColorGrade colorGrade;
+    sf::Shader gradeShader;
+    sf::Texture gradeLutTexture;
+    sf::RenderTexture sceneTarget;
+    bool gradeShaderReady;
+    bool gradeShaderFailed;   // 不支持或创建失败后不再重试，改走软件帧缓冲
+    static constexpr float VIGNETTE_STRENGTH = 0.3f;
+
+    // 一列墙条（castColumn 计算，两条渲染路径共用）
+    struct WallColumn {
+        int drawStart, drawEnd;      // 屏幕上的起止行（已裁剪到屏幕内）
+        int texX;                    // 纹理列
+        float texTop, texBottom;     // drawStart/drawEnd 对应的纹理行（像素）
+        bool isExit;                 // 出口纹理还是雪墙纹理
+        sf::Color light;             // 光照颜色（和纹理相乘）
+        const std::uint32_t* colormap;  // 同一光照的颜色表（软件路径）
+    };
+
+    // 光线投射的计算阶段：每列的结果（castColumn 写入，提交阶段读取）
+    std::vector<RayCast::Hit> rayHits;
+    std::vector<WallColumn> columns;
+    WorkerPool rayWorkers;
+    static constexpr int COLUMNS_PER_TASK = 64;  // 每次领取的列数（太小时调度开销大，太大时负载不均）
+    static constexpr int ROWS_PER_TASK = 32;     // 地板/天花板投射每次领取的行数
+
+    float getHorizon(const Player& player) const;  // 地平线高度（随蹲下偏移）
+
+    // 天空/地板每行的颜色
+    sf::Color getSkyColor(int y, int horizonY) const;
+    sf::Color getFloorColor(int y, float horizon, bool lighterOn) const;
+
+    // 天空/地板渐变缓存：只随地平线（蹲下偏移）、打火机、闪灵变化，
+    // 这三样不变时每帧直接复用，不重新计算颜色
+    struct BackgroundCache {
+        bool valid = false;
+        float horizon = 0.0f;
+        bool lighterOn = false;
+        bool spiritVisionActive = false;
+        std::vector<std::uint32_t> rowPixels;  // 每行的颜色（软件路径，已打包；地板/天花板纹理乘上这个颜色）
+        std::vector<float> rowDistance;        // 每行地板/天花板到玩家的水平距离（只随地平线变化）
+        std::vector<std::uint32_t> rowColormaps; // 每行的颜色表（调色板 × 这一行的颜色；软件路径第一次用到时生成）
+        bool colormapsValid = false;
+        sf::VertexArray mesh;                  // 每行一个矩形的顶点着色网格（SFML 路径，一次绘制）
+    };
+    BackgroundCache background;
+
+    void updateBackground(const Player& player, float horizon);  // 状态变化时重建缓存
+
+    // SFML 路径（闪灵时画进离屏纹理）
+    void drawSkyAndFloor(sf::RenderTarget& target, const Player& player, float horizon);
 
     // 光线投射核心函数
-    void castRays(sf::RenderWindow& window,
+    void castRays(sf::RenderTarget& target,
                  const Player& player,
-                 const Maze& maze,
-                 const std::vector<sf::Vector2i>& escapePath);
+                 const Maze& maze);
+    WallColumn castColumn(int x, const RayCast::Hit& hit, const Player& player, const Maze& maze, float horizon);
+
+    // 计算阶段：并行填好 columns 和 zBuffer；rasterize 时顺便把墙写进帧缓冲（各列互不重叠）
+    void computeColumns(const Player& player, const Maze& maze, float horizon, bool rasterize);
+
+    // 软件帧缓冲路径（grade：上传前对整帧调色）
+    void renderSoftware(sf::RenderWindow& window, const Player& player, const Maze& maze, float horizon, bool grade);
+    void rasterizeWallColumn(int x, const WallColumn& column);
+    void castFloorAndCeiling(const Player& player, float horizon);
+
+    // 闪灵调色的着色器路径：准备好着色器和离屏纹理（不可用时返回 false），以及把离屏纹理调色后画到窗口
+    bool prepareGradeShader();
+    void presentGraded(sf::RenderWindow& window);
+
+    // 闪灵逃生路径光斑（两条路径都在墙之后用 SFML 绘制）
+    void drawEscapePathSpots(sf::RenderWindow& window, const Player& player, float horizon,
+                             const std::vector<sf::Vector2i>& escapePath);
 
     // 辅助函数：根据墙的方向、距离和光照计算颜色
     sf::Color getWallColor(int side, float distance, const Player& player, float rayAngle);
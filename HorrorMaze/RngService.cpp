@@ -0,0 +1,44 @@
+#include "RngService.h"
+#include "Logger.h"
+#include "Environment.h"
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+    // SplitMix64：把相邻的 (种子, 流编号) 打散成互不相关的 PCG 初始状态
+    std::uint64_t splitMix64(std::uint64_t value) {
+        value += 0x9e3779b97f4a7c15ULL;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+        return value ^ (value >> 31);
+    }
+}
+
+RngService::RngService(std::uint64_t masterSeed)
+    : masterSeed(masterSeed)
+{
+}
+
+std::uint64_t RngService::seedFromEnvironment() {
+    std::string text;
+    if (readEnvironmentVariable("HORRORMAZE_SEED", text) && !text.empty()) {
+        char* end = nullptr;
+        unsigned long long seed = std::strtoull(text.c_str(), &end, 0);
+        if (end != nullptr && *end == '\0') {
+            LOG_INFO("RNG seed (HORRORMAZE_SEED): " << seed);
+            return seed;
+        }
+        LOG_WARN("WARNING: Invalid HORRORMAZE_SEED '" << text << "', using a random seed.");
+    }
+
+    std::random_device rd;
+    std::uint64_t seed = (static_cast<std::uint64_t>(rd()) << 32) | rd();
+    LOG_INFO("RNG seed: " << seed << " (set HORRORMAZE_SEED to reproduce)");
+    return seed;
+}
+
+Pcg32 RngService::stream(RngStream id, std::uint64_t index) const {
+    std::uint64_t streamId = static_cast<std::uint64_t>(id) + index;
+    return Pcg32(splitMix64(masterSeed ^ splitMix64(streamId)), streamId);
+}
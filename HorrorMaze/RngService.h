@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * Pcg32：PCG-XSH-RR 32位随机数生成器
+ *
+ * 状态只有两个 uint64（16字节），构造和拷贝都几乎零开销，适合每个实体各持一份。
+ * increment 决定"流"：同一个种子、不同 increment 得到互不相关的序列。
+ *
+ * 不使用 std::uniform_int_distribution：它的结果依赖标准库实现，
+ * 同一个种子在 MSVC 和 libstdc++ 上会得到不同的序列，回放时无法复现。
+ */
+class Pcg32 {
+public:
+    Pcg32() : Pcg32(0x853c49e6748fea9bULL, 0xda3e39cb94b95bdbULL) {}
+
+    Pcg32(std::uint64_t seed, std::uint64_t stream)
+        : state(0)
+        , increment((stream << 1) | 1u)
+    {
+        nextU32();
+        state += seed;
+        nextU32();
+    }
+
+    std::uint32_t nextU32() {
+        std::uint64_t old = state;
+        state = old * 6364136223846793005ULL + increment;
+        std::uint32_t xorshifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        std::uint32_t rot = static_cast<std::uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    // [0, bound) 内的无偏整数（Lemire 乘法取高位 + 拒绝采样）
+    std::uint32_t nextBelow(std::uint32_t bound) {
+        std::uint64_t m = static_cast<std::uint64_t>(nextU32()) * bound;
+        std::uint32_t low = static_cast<std::uint32_t>(m);
+        if (low < bound) {
+            std::uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                m = static_cast<std::uint64_t>(nextU32()) * bound;
+                low = static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+
+    // [minValue, maxValue] 闭区间内的整数
+    int nextInt(int minValue, int maxValue) {
+        std::uint32_t span = static_cast<std::uint32_t>(maxValue - minValue) + 1u;
+        return minValue + static_cast<int>(nextBelow(span));
+    }
+
+    // [0, 1) 内的浮点数
+    float nextFloat() {
+        return static_cast<float>(nextU32() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    bool nextBool() {
+        return (nextU32() >> 31) != 0;
+    }
+
+private:
+    std::uint64_t state;
+    std::uint64_t increment;
+};
+
+/**
+ * 随机数流编号：每个用途一条独立的流
+ */
+enum class RngStream : std::uint64_t {
+    Spawn = 1,        // 鬼的刷新区域和位置
+    TwinVoice = 2,    // 第三次及以后遭遇双胞胎时随机选台词
+    Headless = 3,     // 无头程序的自动输入
+    Ghost = 0x100     // 每只鬼一条流（再加上鬼的序号）
+};
+
+/**
+ * RngService：随机数服务
+ *
+ * 整局游戏只有一个主种子，所有随机数流都由 主种子 + 流编号 派生，
+ * 因此同一个种子下每次运行的随机结果完全一致（性能回归回放依赖这一点）。
+ *
+ * 主种子默认来自 std::random_device（只在启动时构造一次），
+ * 设置环境变量 HORRORMAZE_SEED 可以固定种子。
+ */
+class RngService {
+public:
+    explicit RngService(std::uint64_t masterSeed);
+
+    // HORRORMAZE_SEED 环境变量；未设置时用 std::random_device 生成
+    static std::uint64_t seedFromEnvironment();
+
+    std::uint64_t getSeed() const { return masterSeed; }
+    void reseed(std::uint64_t seed) { masterSeed = seed; }
+
+    // 派生一条独立的流（同样的 id/index 总是得到同样的序列）
+    Pcg32 stream(RngStream id, std::uint64_t index = 0) const;
+
+private:
+    std::uint64_t masterSeed;
+};
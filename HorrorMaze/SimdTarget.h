@@ -0,0 +1,28 @@
+#pragma once
+
+/**
+ * SIMD 实现文件（*Simd.cpp）共用的编译开关
+ *
+ * 不依赖整个文件的编译选项（/arch 或 -mavx2）：
+ * - MSVC 允许在任何函数里直接使用 AVX2 intrinsic
+ * - GCC/Clang 用 target 属性只对标了 SIMD_TARGET_* 的函数开启对应指令集
+ * 这样 g++ *.cpp 直接编译也能得到 AVX2 版本，并且其它代码不会
+ * 被编译成 AVX2 指令（在不支持的CPU上运行时由 CpuFeatures::detectIsa 选择退回）。
+ *
+ * 非x86平台 SIMD_X86 为 0，各内核只编译标量版本（detectIsa 也不会选到 SIMD 版本）。
+ */
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+#if SIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_SSE2
+#define SIMD_TARGET_AVX2
+#endif
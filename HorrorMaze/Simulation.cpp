@@ -0,0 +1,708 @@
+#include "Simulation.h"
+#include "PerceptionBatch.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <set>
+
+Simulation::Simulation(std::uint64_t seed, const SimulationParams& params)
+    : maze(std::make_shared<Maze>())
+    , params(params)
+    , rng(seed)
+    , spawnRng(rng.stream(RngStream::Spawn))
+    , twinVoiceRng(rng.stream(RngStream::TwinVoice))
+    , ghostSpawnCount(0)
+    , perceptionChannel(aiScheduler.addChannel("perception", AI_PERCEPTION_RATE))
+    , decisionChannel(aiScheduler.addChannel("decision", AI_DECISION_RATE))
+    , movementChannel(aiScheduler.addChannel("movement", 0.0f))  // 移动和碰撞每步执行
+    , status(SimulationStatus::Running)
+    , deathCause(DeathCause::None)
+    , gameTimer(GAME_TIME_LIMIT)
+    , stepCount(0)
+    , playerFrozen(false)
+    , frozenTimer(0.0f)
+    , activeTwinIndex(-1)
+    , twinEncounterCount(0)
+    , twinVoiceDurations{0.0f, 0.0f}
+    , inWallWarningShown(false)
+    , previousPlayerPose(player.getPose())
+{
+    stimuli.setAttenuation(params.airAttenuation, params.wallAttenuationMult);
+}
+
+bool Simulation::loadMap(const std::string& filename) {
+    auto loaded = std::make_shared<Maze>();
+    if (!loaded->loadFromFile(filename)) {
+        return false;
+    }
+    setMap(std::move(loaded));
+    return true;
+}
+
+void Simulation::setMap(std::shared_ptr<const Maze> map) {
+    maze = std::move(map);
+
+    // 刺激系统按地图尺寸分桶
+    stimuli.resize(maze->getWidth(), maze->getHeight());
+    findSpawnCells();
+    reset();
+}
+
+void Simulation::setTwinVoiceDurations(float voice1, float voice2) {
+    twinVoiceDurations[0] = voice1;
+    twinVoiceDurations[1] = voice2;
+}
+
+/**
+ * 重新开始一局
+ */
+void Simulation::reset() {
+    // 重置玩家位置
+    sf::Vector2i startPos = maze->getPlayerStart();
+    player = Player(startPos.x + 0.5f, startPos.y + 0.5f);
+    LOG_INFO("Player spawned at: (" << startPos.x << ", " << startPos.y << ")");
+
+    aiScheduler.reset();  // 鬼列表整体替换，清空调度游标
+    stimuli.clear();
+    escapePath.clear();   // 清空逃生路径
+    events.clear();
+
+    spawnGhosts();
+    spawnTwins();
+
+    status = SimulationStatus::Running;
+    deathCause = DeathCause::None;
+    gameTimer = GAME_TIME_LIMIT;
+    stepCount = 0;
+    playerFrozen = false;
+    frozenTimer = 0.0f;
+    activeTwinIndex = -1;
+
+    storePreviousState();  // 玩家和鬼都是瞬移到出生点，不做插值
+}
+
+/**
+ * 出生点候选：鬼在左下或右上1/4区域的道路上，双胞胎在标记为3的格子
+ */
+void Simulation::findSpawnCells() {
+    int halfWidth = maze->getWidth() / 2;
+    int halfHeight = maze->getHeight() / 2;
+    ghostSpawnCells[0].clear();
+    ghostSpawnCells[1].clear();
+    twinCells.clear();
+
+    for (int y = 0; y < maze->getHeight(); y++) {
+        for (int x = 0; x < maze->getWidth(); x++) {
+            if (maze->getCell(x, y) == 3) {
+                twinCells.push_back({x, y});
+            }
+            if (maze->isWall(x, y)) {
+                continue;
+            }
+            if (x >= halfWidth && y < halfHeight) {
+                ghostSpawnCells[0].push_back({x, y});  // 右上区域：x: [width/2, width), y: [0, height/2)
+            } else if (x < halfWidth && y >= halfHeight) {
+                ghostSpawnCells[1].push_back({x, y});  // 左下区域：x: [0, width/2), y: [height/2, height)
+            }
+        }
+    }
+}
+
+/**
+ * 刷新鬼：在迷宫左下或右上1/4区域的道路上随机选一个位置
+ */
+void Simulation::spawnGhosts() {
+    ghosts.clear();
+
+    // 随机决定在左下还是右上区域生成
+    bool spawnInBottomLeft = spawnRng.nextBool();
+    LOG_INFO((spawnInBottomLeft ? "Spawning ghost in BOTTOM-LEFT quarter..." : "Spawning ghost in TOP-RIGHT quarter..."));
+    const std::vector<sf::Vector2i>& validSpawnPositions = ghostSpawnCells[spawnInBottomLeft ? 1 : 0];
+
+    // 随机选择一个位置生成鬼
+    if (!validSpawnPositions.empty()) {
+        sf::Vector2i spawnPos = validSpawnPositions[spawnRng.nextBelow(static_cast<std::uint32_t>(validSpawnPositions.size()))];
+        ghosts.emplace_back(spawnPos.x + 0.5f, spawnPos.y + 0.5f, rng.stream(RngStream::Ghost, ghostSpawnCount++), params);
+        LOG_INFO("Ghost spawned at: (" << spawnPos.x << ", " << spawnPos.y << ")");
+    } else {
+        LOG_WARN("Warning: No valid spawn positions found for ghost!");
+    }
+}
+
+/**
+ * 放置双胞胎：地图中所有标记为3的格子
+ */
+void Simulation::spawnTwins() {
+    twins.clear();
+    for (const sf::Vector2i& cell : twinCells) {
+        twins.emplace_back(cell.x + 0.5f, cell.y + 0.5f);
+        LOG_DEBUG("  Twin #" << twins.size() << " at grid (" << cell.x << ", " << cell.y << ")");
+    }
+    LOG_INFO("Twins spawned: " << twins.size() << " traps");
+}
+
+void Simulation::storePreviousState() {
+    previousPlayerPose = player.getPose();
+    for (auto& ghost : ghosts) {
+        ghost.storePreviousPosition();
+    }
+}
+
+/**
+ * 保存快照：头部（魔数、版本、步数、地图尺寸）+ 模拟状态 + 各对象
+ */
+void Simulation::saveSnapshot(SimulationSnapshot& snapshot) const {
+    PROFILE_SCOPE(Snapshot);
+    snapshot.data.clear();  // 保留容量，第二次保存起不再分配
+    snapshot.step = stepCount;
+
+    SnapshotWriter out(snapshot.data);
+    out.write(SimulationSnapshot::MAGIC);
+    out.write(SimulationSnapshot::VERSION);
+    out.write(stepCount);
+    out.write(maze->getWidth());
+    out.write(maze->getHeight());
+
+    out.write(rng.getSeed());
+    out.write(spawnRng);
+    out.write(twinVoiceRng);
+    out.write(ghostSpawnCount);
+    out.write(status);
+    out.write(deathCause);
+    out.write(gameTimer);
+    out.write(playerFrozen);
+    out.write(frozenTimer);
+    out.write(activeTwinIndex);
+    out.write(twinEncounterCount);
+    out.write(inWallWarningShown);
+    out.writeVector(escapePath);
+    out.write(previousPlayerPose);
+
+    player.saveState(out);
+    out.write(static_cast<std::uint32_t>(ghosts.size()));
+    for (const auto& ghost : ghosts) {
+        ghost.saveState(out);
+    }
+    out.write(static_cast<std::uint32_t>(twins.size()));
+    for (const auto& twin : twins) {
+        twin.saveState(out);
+    }
+    aiScheduler.saveState(out);
+    stimuli.saveState(out);
+}
+
+/**
+ * 恢复快照：先检查头部，再按保存的顺序读回
+ *
+ * 头部不符时什么都不改；读到一半失败（文件损坏）时状态已经不完整，重新开始一局。
+ */
+bool Simulation::restoreSnapshot(const SimulationSnapshot& snapshot) {
+    PROFILE_SCOPE(Snapshot);
+    SnapshotReader in(snapshot.data.data(), snapshot.data.size());
+    char magic[4] = {};
+    std::uint32_t version = 0;
+    std::uint64_t savedStep = 0;
+    int width = 0, height = 0;
+    in.read(magic);
+    in.read(version);
+    in.read(savedStep);
+    in.read(width);
+    in.read(height);
+    if (!in.isOk() || std::memcmp(magic, SimulationSnapshot::MAGIC, sizeof(magic)) != 0 ||
+        version != SimulationSnapshot::VERSION) {
+        LOG_ERROR("ERROR: Not a valid snapshot (or made by a different version)");
+        return false;
+    }
+    if (width != maze->getWidth() || height != maze->getHeight()) {
+        LOG_ERROR("ERROR: Snapshot was made on a different map (" << width << "x" << height << ")");
+        return false;
+    }
+
+    std::uint64_t seed = 0;
+    in.read(seed);
+    rng.reseed(seed);
+    in.read(spawnRng);
+    in.read(twinVoiceRng);
+    in.read(ghostSpawnCount);
+    in.read(status);
+    in.read(deathCause);
+    in.read(gameTimer);
+    in.read(playerFrozen);
+    in.read(frozenTimer);
+    in.read(activeTwinIndex);
+    in.read(twinEncounterCount);
+    in.read(inWallWarningShown);
+    in.readVector(escapePath);
+    in.read(previousPlayerPose);
+    stepCount = savedStep;
+
+    bool ok = player.loadState(in);
+
+    // 鬼和双胞胎的数量一般不变（同一张地图），不同时先补齐或截断再逐个覆盖
+    const std::uint32_t maxEntities = static_cast<std::uint32_t>(width * height);
+    std::uint32_t ghostCount = 0;
+    ok = ok && in.read(ghostCount) && ghostCount <= maxEntities;
+    if (ok) {
+        while (ghosts.size() > ghostCount) {
+            ghosts.pop_back();
+        }
+        while (ghosts.size() < ghostCount) {
+            ghosts.emplace_back(0.0f, 0.0f, Pcg32(), params);
+        }
+        for (auto& ghost : ghosts) {
+            ok = ok && ghost.loadState(in);
+        }
+    }
+
+    std::uint32_t twinCount = 0;
+    ok = ok && in.read(twinCount) && twinCount <= maxEntities;
+    if (ok) {
+        while (twins.size() > twinCount) {
+            twins.pop_back();
+        }
+        while (twins.size() < twinCount) {
+            twins.emplace_back(0.0f, 0.0f);
+        }
+        for (auto& twin : twins) {
+            ok = ok && twin.loadState(in);
+        }
+    }
+
+    ok = ok && aiScheduler.loadState(in) && stimuli.loadState(in) && in.atEnd();
+    events.clear();
+
+    if (!ok) {
+        LOG_ERROR("ERROR: Snapshot is corrupted, starting a new game instead");
+        reset();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 推进一个模拟步长
+ *
+ * 顺序：输入开关 → 冻结/视角 → 刺激系统和玩家 → 双胞胎触发 → 计时器
+ *       → 鬼（感知/决策/移动）→ 闪灵 → 抓捕 → 出口
+ */
+void Simulation::step(float deltaTime, const PlayerInput& input) {
+    PROFILE_SCOPE(Simulation);
+    events.clear();
+    storePreviousState();
+    if (status != SimulationStatus::Running) {
+        return;
+    }
+    stepCount++;
+
+    // F：打火机，E：钻墙/出墙
+    if (input.toggleLighter) {
+        player.toggleLighter();
+    }
+    if (input.toggleWallPhase) {
+        player.toggleWallPhase(*maze);
+    }
+
+    // === 更新双胞胎冻结状态 ===
+    if (playerFrozen) {
+        updateFrozen(deltaTime);
+    }
+
+    // 鼠标转向（冻结和钻墙动画期间视角由程序控制）
+    if (!playerFrozen && !player.isEnteringWall() && input.turn != 0.0f) {
+        player.rotate(input.turn);
+    }
+
+    // 推进刺激系统（移除上一步的脚步声和过期的声音）
+    stimuli.update(deltaTime);
+
+    // 更新玩家（处理移动）
+    {
+        PROFILE_SCOPE(PlayerUpdate);
+        player.update(deltaTime, *maze, input);
+    }
+
+    // 玩家脚步声（强度取决于移动模式）；在墙内且关闭打火机时不发声
+    if (!player.isInWall() || player.isLighterOn()) {
+        stimuli.emit(StimulusType::Footstep, player.getX(), player.getY(),
+                     player.getFootstepLoudness(), 0.0f);
+    }
+
+    // === 检测双胞胎触发 ===
+    if (!playerFrozen) {
+        checkTwinTriggers();
+    }
+
+    // 更新所有双胞胎（声音衰减）
+    for (auto& twin : twins) {
+        twin.update(deltaTime);
+    }
+
+    // 更新玩家的闪灵状态
+    player.updateSpiritVision(deltaTime);
+
+    // 更新游戏计时器
+    gameTimer -= deltaTime * 1.5f;
+    if (gameTimer <= 0.0f) {
+        // 时间耗尽，冻死
+        LOG_INFO("\n*** YOU ARE FROZEN TO DEATH! ***\n");
+        status = SimulationStatus::GameOver;
+        deathCause = DeathCause::Frozen;
+        events.push_back({SimulationEventType::FrozenToDeath, 0, 0.0f});
+        return;
+    }
+
+    // 更新所有鬼：感知/决策按各自频率错峰执行，移动每步执行
+    updateGhosts(deltaTime);
+
+    // === 检测鬼距离，触发闪灵 ===
+    if (!player.isSpiritVisionActive()) {  // 未激活时才检测
+        checkSpiritVision();
+    }
+
+    // === 检查鬼是否抓到玩家 ===
+    if (checkGhostCatch()) {
+        return;  // 立即停止更新
+    }
+
+    // === 检查玩家是否到达出口 ===
+    int playerGridX = static_cast<int>(player.getX());
+    int playerGridY = static_cast<int>(player.getY());
+
+    if (maze->getCell(playerGridX, playerGridY) == 2) {
+        // 到达出口！
+        LOG_INFO("\n*** CONGRATULATIONS! You found the exit! ***\n");
+        status = SimulationStatus::Victory;
+        events.push_back({SimulationEventType::ReachedExit, 0, 0.0f});
+    }
+}
+
+/**
+ * 冻结期间：视角逐渐转向触发的双胞胎，计时结束后解冻
+ */
+void Simulation::updateFrozen(float deltaTime) {
+    // 如果有激活的双胞胎，让玩家视角逐渐转向它
+    if (activeTwinIndex >= 0 && activeTwinIndex < static_cast<int>(twins.size())) {
+        const Twin& atwin = twins[activeTwinIndex];
+        float dx = atwin.getX() - player.getX();
+        float dy = atwin.getY() - player.getY();
+        float targetAngle = std::atan2(dy, dx);
+        float playerAngle = std::atan2(player.getDirY(), player.getDirX());
+
+        // 计算角度差并归一到[-pi, pi]
+        float diff = targetAngle - playerAngle;
+        const float PI = std::acos(-1.0f);
+        while (diff > PI) diff -= 2.0f * PI;
+        while (diff < -PI) diff += 2.0f * PI;
+
+        // 平滑转向，限制每步最大旋转量
+        float rotateSpeed = 2.5f; // rad/s
+        float maxStep = rotateSpeed * deltaTime;
+        if (std::abs(diff) > maxStep) {
+            diff = (diff > 0.0f) ? maxStep : -maxStep;
+        }
+        player.rotate(diff);
+    }
+
+    // 计时器递减并在结束时解除冻结
+    frozenTimer -= deltaTime;
+    if (frozenTimer <= 0.0f) {
+        playerFrozen = false;
+        frozenTimer = 0.0f;
+        player.unfreeze();
+        player.enableLighter();
+
+        // 活动双胞胎索引重置
+        activeTwinIndex = -1;
+
+        events.push_back({SimulationEventType::PlayerUnfrozen, 0, 0.0f});
+        LOG_INFO("Player unfrozen!");
+    }
+}
+
+/**
+ * 双胞胎触发检测
+ *
+ * 触发条件：玩家和双胞胎在同一行或同一列，且中间没有墙（需要直视/直达）
+ */
+void Simulation::checkTwinTriggers() {
+    PROFILE_SCOPE(TwinChecks);
+    for (size_t ti = 0; ti < twins.size(); ++ti) {
+        auto& twin = twins[ti];
+        if (twin.isActivated()) continue; // 已触发的跳过
+
+        int playerGX = static_cast<int>(player.getX());
+        int playerGY = static_cast<int>(player.getY());
+        int twinGX = static_cast<int>(twin.getX());
+        int twinGY = static_cast<int>(twin.getY());
+
+        bool sameLine = (playerGX == twinGX) || (playerGY == twinGY);
+        if (!sameLine) {
+            continue; // 不在同一行或列，跳过
+        }
+
+        // 检查是否被墙阻挡（同一行/列，查预计算的通道表）
+        // 忽略起点和终点自身的格子（如果玩家或双胞胎正好在墙里会另外处理）
+        bool blocked = !maze->isAxisLineClear(playerGX, playerGY, twinGX, twinGY);
+
+        if (blocked) {
+            // 被墙阻挡，不能触发
+            continue;
+        }
+
+        // 触发硬控：根据遭遇次数选择台词
+        twinEncounterCount++;  // 增加遭遇次数
+
+        // 确定播放哪个台词
+        int voice = 0;
+        if (twinEncounterCount == 1) {
+            // 第一次遭遇：播放 Twins1
+            voice = 0;
+            LOG_INFO("\n>>> FIRST TWIN ENCOUNTER! Playing Twins1.mp3 <<<");
+        } else if (twinEncounterCount == 2) {
+            // 第二次遭遇：播放 Twins2
+            voice = 1;
+            LOG_INFO("\n>>> SECOND TWIN ENCOUNTER! Playing Twins2.mp3 <<<");
+        } else {
+            // 第三次及以后：随机播放
+            voice = twinVoiceRng.nextBool() ? 0 : 1;
+            LOG_INFO("\n>>> TWIN ENCOUNTER #" << twinEncounterCount << "! Randomly playing Twins"
+                     << (voice + 1) << ".mp3 <<<");
+        }
+
+        // 台词时长作为冻结时长（参数里指定了冻结时长时以参数为准）
+        float audioDuration = Twin::getDefaultSoundDuration(); // fallback
+        if (params.freezeDuration > 0.0f) {
+            audioDuration = params.freezeDuration;
+        } else if (twinVoiceDurations[voice] > 0.0f) {
+            audioDuration = twinVoiceDurations[voice];
+        }
+
+        twin.activate(audioDuration);
+        // 台词声音投递到刺激系统（随时间线性衰减），吸引附近的鬼
+        stimuli.emit(StimulusType::TwinVoice, twin.getX(), twin.getY(),
+                     Twin::getPeakSoundLevel(), audioDuration, true);
+        playerFrozen = true;
+        frozenTimer = audioDuration;
+        player.freeze();
+        player.disableLighter();
+        activeTwinIndex = static_cast<int>(ti);
+
+        events.push_back({SimulationEventType::TwinEncounter, voice, audioDuration});
+        break; // 一次只触发一个
+    }
+}
+
+void Simulation::updateGhosts(float deltaTime) {
+    PROFILE_SCOPE(GhostUpdate);
+    aiScheduler.beginFrame(deltaTime, ghosts.size());
+    perceptionQueue.clear();
+    aiScheduler.forEachDue(perceptionChannel, [this](std::size_t i, float) {
+        perceptionQueue.push_back(i);  // 本步到期的鬼排队批量处理
+    });
+    perceiveGhostsBatch();
+    aiScheduler.forEachDue(decisionChannel, [this](std::size_t i, float elapsed) {
+        ghosts[i].think(elapsed);
+    });
+    aiScheduler.forEachDue(movementChannel, [this](std::size_t i, float elapsed) {
+        ghosts[i].act(elapsed, *maze);
+    });
+}
+
+/**
+ * 批量感知玩家
+ *
+ * 所有排队的鬼都以玩家所在格为终点，一次调用 PerceptionBatch
+ * 算出每个鬼到玩家的墙数（只用于打火机光照检测，数到第2堵墙就停），再交给各自的感知逻辑
+ * （视线查预计算可见集，声音从刺激系统里听）。打火机没开时不需要墙数，逐个感知即可。
+ */
+void Simulation::perceiveGhostsBatch() {
+    std::size_t count = perceptionQueue.size();
+    if (count == 0) {
+        return;
+    }
+    if (!player.isLighterOn()) {
+        for (std::size_t index : perceptionQueue) {
+            ghosts[index].perceive(player, *maze, stimuli);
+        }
+        return;
+    }
+
+    perceptionSourceX.resize(count);
+    perceptionSourceY.resize(count);
+    perceptionWalls.resize(count);
+    for (std::size_t k = 0; k < count; k++) {
+        const Ghost& ghost = ghosts[perceptionQueue[k]];
+        perceptionSourceX[k] = static_cast<int>(ghost.getX());
+        perceptionSourceY[k] = static_cast<int>(ghost.getY());
+    }
+
+    PerceptionBatch::countWallsToTarget(maze->getWallBitmap(),
+        perceptionSourceX.data(), perceptionSourceY.data(), count,
+        static_cast<int>(player.getX()), static_cast<int>(player.getY()),
+        perceptionWalls.data(), Ghost::LIGHTER_WALL_LIMIT);
+
+    for (std::size_t k = 0; k < count; k++) {
+        ghosts[perceptionQueue[k]].perceive(player, perceptionWalls[k], *maze, stimuli);
+    }
+}
+
+/**
+ * 鬼靠近时激活闪灵，并计算到出口的逃生路径
+ */
+void Simulation::checkSpiritVision() {
+    for (const auto& ghost : ghosts) {
+        float dx = ghost.getX() - player.getX();
+        float dy = ghost.getY() - player.getY();
+        float distance = std::sqrt(dx * dx + dy * dy);
+
+        if (distance < SPIRIT_VISION_TRIGGER_DISTANCE) {
+            // 鬼靠近！激活闪灵
+            player.activateSpiritVision();
+
+            // 计算逃生路径
+            sf::Vector2i playerPos(static_cast<int>(player.getX()), static_cast<int>(player.getY()));
+            sf::Vector2i exitPos(18, 19);  // 根据地图获取终点位置
+
+            // 尝试从地图中找到终点（2=出口）
+            for (int y = 0; y < maze->getHeight(); y++) {
+                for (int x = 0; x < maze->getWidth(); x++) {
+                    if (maze->getCell(x, y) == 2) {
+                        exitPos = {x, y};
+                        break;
+                    }
+                }
+            }
+
+            escapePath = findPathToExit(playerPos, exitPos);
+            LOG_INFO("Escape path calculated: " << escapePath.size() << " steps");
+            events.push_back({SimulationEventType::SpiritVision, 0, 0.0f});
+            break;  // 只需要触发一次
+        }
+    }
+}
+
+/**
+ * 检查鬼是否抓到玩家
+ *
+ * 玩家在墙内且关闭打火机时免疫碰撞检测；
+ * 如果在墙内但开着打火机，仍然会被抓到
+ */
+bool Simulation::checkGhostCatch() {
+    if (player.isInWall() && !player.isLighterOn()) {
+        // 调试输出：玩家在墙内且打火机关闭，免疫碰撞（每个模拟实例只输出一次）
+        if (!inWallWarningShown) {
+            LOG_DEBUG("Player is in wall with lighter OFF - immune to ghost collision");
+            inWallWarningShown = true;
+        }
+        return false;
+    }
+
+    for (const auto& ghost : ghosts) {
+        float dx = ghost.getX() - player.getX();
+        float dy = ghost.getY() - player.getY();
+        float distance = std::sqrt(dx * dx + dy * dy);
+
+        // 增大碰撞范围到0.8格，更容易触发
+        if (distance < CATCH_DISTANCE) {
+            LOG_INFO("\n*** YOU ARE CHOPPED! ***\n");
+            LOG_INFO("Ghost caught player at distance: " << distance);
+
+            status = SimulationStatus::GameOver;
+            deathCause = DeathCause::Chopped;
+            events.push_back({SimulationEventType::PlayerCaught, 0, 0.0f});
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * A*寻路算法：找到从起点到终点的最短路径
+ */
+std::vector<sf::Vector2i> Simulation::findPathToExit(sf::Vector2i start, sf::Vector2i goal) const {
+    struct Node {
+        int x, y;
+        float g, h, f;
+        int parentIndex;  // 使用索引代替指针
+
+        Node(int x_, int y_, float g_, float h_, int pIdx)
+            : x(x_), y(y_), g(g_), h(h_), f(g_ + h_), parentIndex(pIdx) {}
+
+        bool operator>(const Node& other) const {
+            return f > other.f;
+        }
+    };
+
+    // 检查起点和终点是否有效
+    if (maze->isWall(start.x, start.y) || maze->isWall(goal.x, goal.y)) {
+        return {};
+    }
+
+    std::set<std::pair<int, int>> closedSet;
+    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> openQueue;
+    std::vector<Node> allNodes;
+    allNodes.reserve(1000);  // 预留空间，减少重新分配
+
+    auto heuristic = [goal](int x, int y) -> float {
+        return static_cast<float>(std::abs(x - goal.x) + std::abs(y - goal.y));
+    };
+
+    // 添加起点（parentIndex = -1 表示没有父节点）
+    openQueue.emplace(start.x, start.y, 0.0f, heuristic(start.x, start.y), -1);
+
+    while (!openQueue.empty()) {
+        Node current = openQueue.top();
+        openQueue.pop();
+
+        if (closedSet.count({current.x, current.y})) {
+            continue;
+        }
+
+        closedSet.insert({current.x, current.y});
+
+        // 保存当前节点并记录索引
+        int currentIndex = static_cast<int>(allNodes.size());
+        allNodes.push_back(current);
+
+        // 到达目标
+        if (current.x == goal.x && current.y == goal.y) {
+            std::vector<sf::Vector2i> path;
+            int idx = currentIndex;
+            while (idx != -1) {
+                path.push_back({allNodes[idx].x, allNodes[idx].y});
+                idx = allNodes[idx].parentIndex;
+            }
+            std::reverse(path.begin(), path.end());
+            return path;
+        }
+
+        // 扩展邻居
+        const int dx[] = {0, 0, -1, 1};
+        const int dy[] = {-1, 1, 0, 0};
+
+        for (int i = 0; i < 4; i++) {
+            int nx = current.x + dx[i];
+            int ny = current.y + dy[i];
+
+            if (nx < 0 || ny < 0 || nx >= maze->getWidth() || ny >= maze->getHeight()) {
+                continue;
+            }
+            if (maze->isWall(nx, ny)) {
+                continue;
+            }
+            if (closedSet.count({nx, ny})) {
+                continue;
+            }
+
+            float newG = current.g + 1.0f;
+            float newH = heuristic(nx, ny);
+
+            openQueue.emplace(nx, ny, newG, newH, currentIndex);  // 使用索引
+        }
+    }
+
+    return {};  // 未找到路径
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "Maze.h"
+#include "Player.h"
+#include "Ghost.h"
+#include "Twin.h"
+#include "UpdateScheduler.h"  // 多频率调度器
+#include "StimulusSystem.h"   // 刺激（声音事件）系统
+#include "RngService.h"       // 可复现的随机数流
+#include "SimulationParams.h" // 可调的平衡参数
+#include "SimulationSnapshot.h" // 状态快照
+
+enum class DeathCause {
+    None,         // 未死亡
+    Chopped,      // 被鬼抓到
+    Frozen        // 时间耗尽，冻死
+};
+
+/**
+ * 一局游戏的结果
+ */
+enum class SimulationStatus {
+    Running,      // 进行中
+    Victory,      // 到达出口
+    GameOver      // 死亡（原因见 DeathCause）
+};
+
+/**
+ * 模拟事件：step 中发生、需要表现层（声音、鼠标、界面）响应的事情
+ */
+enum class SimulationEventType {
+    TwinEncounter,    // 触发双胞胎：voice = 台词编号（0/1），duration = 冻结时长
+    PlayerUnfrozen,   // 冻结结束
+    SpiritVision,     // 鬼靠近触发闪灵（逃生路径已算好）
+    PlayerCaught,     // 被鬼抓到
+    FrozenToDeath,    // 时间耗尽
+    ReachedExit       // 到达出口
+};
+
+struct SimulationEvent {
+    SimulationEventType type;
+    int voice;
+    float duration;
+};
+
+/**
+ * Simulation：游戏模拟核心
+ *
+ * 迷宫、玩家、鬼、双胞胎、计时器和胜负规则都在这里，
+ * 不依赖窗口、声音和图形（只用到 SFML 的 Vector2 头文件）。
+ *
+ * 外部每个固定步长调用一次 step(dt, input)，之后读取状态和本步产生的事件：
+ *   - Game：从键盘/鼠标采样输入，根据事件播放声音、切换界面，渲染状态
+ *   - HorrorMazeHeadless：自动生成输入，没有显示器也能每秒跑上万步
+ */
+class Simulation {
+public:
+    static constexpr float GAME_TIME_LIMIT = 300.0f;  // 5分钟时间限制
+    static constexpr float SPIRIT_VISION_TRIGGER_DISTANCE = 5.0f;  // 触发距离（格）
+    static constexpr float AI_PERCEPTION_RATE = 15.0f;  // 感知频率（Hz）
+    static constexpr float AI_DECISION_RATE = 10.0f;    // 决策频率（Hz）
+    static constexpr float CATCH_DISTANCE = 0.8f;       // 鬼抓到玩家的距离（格）
+
+    explicit Simulation(std::uint64_t seed, const SimulationParams& params = SimulationParams());
+
+    // 加载地图并开始新的一局
+    bool loadMap(const std::string& filename);
+
+    // 使用已加载的地图并开始新的一局（批量模拟时所有实例共享同一份只读地图）
+    void setMap(std::shared_ptr<const Maze> map);
+
+    // 重新开始一局：玩家回到起点，重新刷新鬼和双胞胎，计时器复位
+    void reset();
+
+    /**
+     * 快照：保存/恢复整局状态（玩家、鬼的路径和计时器、双胞胎、刺激、调度器、计时器、随机数流）
+     *
+     * 地图不在快照里：恢复时必须已经加载了同一张地图（尺寸不同时拒绝恢复）。
+     * 可调参数和台词时长属于配置，也不保存。快照对象的缓冲区会被复用，
+     * 保存到同一个快照对象时不分配内存；恢复后的继续运行和保存时的继续运行逐步相同。
+     *
+     * @return restoreSnapshot：快照无效或和当前地图不符时返回 false（此时重新开始一局）
+     */
+    void saveSnapshot(SimulationSnapshot& snapshot) const;
+    bool restoreSnapshot(const SimulationSnapshot& snapshot);
+
+    // 推进一个模拟步长（只有 Running 状态下才会推进）
+    void step(float deltaTime, const PlayerInput& input);
+
+    // 双胞胎台词的时长（秒，决定冻结时长；由游戏按音频长度设置，<= 0 时用默认值）
+    void setTwinVoiceDurations(float voice1, float voice2);
+
+    // === 状态查询 ===
+    SimulationStatus getStatus() const { return status; }
+    DeathCause getDeathCause() const { return deathCause; }
+    float getTimeRemaining() const { return gameTimer; }
+    std::uint64_t getStepCount() const { return stepCount; }
+    bool isPlayerFrozen() const { return playerFrozen; }
+    const Maze& getMaze() const { return *maze; }
+    const SimulationParams& getParams() const { return params; }
+    const Player& getPlayer() const { return player; }
+    const std::vector<Ghost>& getGhosts() const { return ghosts; }
+    const std::vector<Twin>& getTwins() const { return twins; }
+    const std::vector<sf::Vector2i>& getEscapePath() const { return escapePath; }
+    const RngService& getRng() const { return rng; }
+
+    // 上一步开始时的玩家位姿（渲染插值用；鬼的上一位置由 Ghost 自己记录）
+    const Player::Pose& getPreviousPlayerPose() const { return previousPlayerPose; }
+
+    // 最近一次 step 产生的事件
+    const std::vector<SimulationEvent>& getEvents() const { return events; }
+
+    // A*寻路：闪灵的逃生路径（基于当前地图）
+    std::vector<sf::Vector2i> findPathToExit(sf::Vector2i start, sf::Vector2i goal) const;
+
+private:
+    std::shared_ptr<const Maze> maze;  // 地图只读，多个模拟实例可以共享同一份
+    SimulationParams params;
+    Player player;
+    std::vector<Ghost> ghosts;
+    std::vector<Twin> twins;
+
+    // 随机数：所有流都从同一个主种子派生，固定种子即可复现整局游戏
+    RngService rng;
+    Pcg32 spawnRng;                  // 鬼的刷新区域/位置
+    Pcg32 twinVoiceRng;              // 双胞胎台词选择
+    std::uint64_t ghostSpawnCount;   // 已生成的鬼数量（决定下一只鬼的流编号）
+
+    // 出生点候选（setMap 时扫描一次，重新开始时不再遍历地图）
+    std::vector<sf::Vector2i> ghostSpawnCells[2];  // [0] 右上1/4，[1] 左下1/4 的可行走格子
+    std::vector<sf::Vector2i> twinCells;           // 标记为3的格子
+
+    // AI调度：感知/决策低频错峰执行，移动每步执行
+    UpdateScheduler aiScheduler;
+    UpdateScheduler::ChannelId perceptionChannel;
+    UpdateScheduler::ChannelId decisionChannel;
+    UpdateScheduler::ChannelId movementChannel;
+
+    // 声音事件：玩家脚步、双胞胎台词等都投递到这里，鬼从这里听
+    StimulusSystem stimuli;
+
+    // 批量感知的临时缓冲（每步复用，避免分配）
+    std::vector<std::size_t> perceptionQueue;
+    std::vector<int> perceptionSourceX;
+    std::vector<int> perceptionSourceY;
+    std::vector<int> perceptionWalls;
+
+    // 游戏状态
+    SimulationStatus status;
+    DeathCause deathCause;
+    float gameTimer;                 // 游戏剩余时间（秒）
+    std::uint64_t stepCount;         // 本局已推进的步数
+
+    // 双胞胎冻结状态
+    bool playerFrozen;               // 玩家是否被冻结
+    float frozenTimer;               // 冻结剩余时间
+    int activeTwinIndex;             // 当前导致硬控的双胞胎索引（-1表示无）
+    int twinEncounterCount;          // 双胞胎遭遇次数（0=未遇到，1=第一次，2=第二次，3+=随机）
+    float twinVoiceDurations[2];     // 两段台词的时长
+    bool inWallWarningShown;         // "墙内免疫"调试日志已输出
+
+    // 闪灵
+    std::vector<sf::Vector2i> escapePath;  // 逃生路径（A*计算）
+
+    Player::Pose previousPlayerPose;
+    std::vector<SimulationEvent> events;
+
+    void findSpawnCells();               // 扫描地图，记录鬼和双胞胎的出生点候选
+    void spawnGhosts();                  // 在左下或右上1/4区域随机刷新鬼
+    void spawnTwins();                   // 按地图标记放置双胞胎
+    void storePreviousState();           // 记录当前状态为"上一个状态"
+    void updateFrozen(float deltaTime);  // 冻结时视角转向双胞胎，计时结束解冻
+    void checkTwinTriggers();
+    void updateGhosts(float deltaTime);
+    void perceiveGhostsBatch();          // 对本步排队的鬼批量感知（SIMD数墙）
+    void checkSpiritVision();
+    bool checkGhostCatch();
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <array>
+#include <cstring>
+
+/**
+ * SimulationParams：可调的平衡参数
+ *
+ * 默认值就是游戏里使用的值。批量模拟（HorrorMazeHeadless --batch）
+ * 可以给每组实例换一套参数，比较抓捕时间和逃脱率。
+ */
+struct SimulationParams {
+    // === 鬼的听觉（衰减后的声音强度超过阈值才能听到） ===
+    float hearingThreshold = 10.0f;       // 玩家脚步声的听觉阈值
+    float twinLureThreshold = 15.0f;      // 双胞胎声音超过此值时鬼被吸引过去
+
+    // === 声音衰减（StimulusSystem） ===
+    float airAttenuation = 0.08f;         // 空气中每单位距离的衰减系数
+    float wallAttenuationMult = 0.3f;     // 穿墙衰减倍数（每堵墙）
+
+    // === 鬼的移动 ===
+    float ghostChaseSpeed = 3.5f;         // 追逐速度（格/秒；玩家走路2、奔跑4）
+
+    // === 双胞胎 ===
+    float freezeDuration = 0.0f;          // 冻结时长（秒）；<= 0 时等于台词时长
+};
+
+/**
+ * 参数名表（命令行按名字设置参数、输出结果时列出参数）
+ *
+ * 每个参数带一个有效范围（含两端），命令行给出的值超出范围时拒绝。
+ * 衰减系数的范围保证 StimulusSystem 的查询半径和数墙上限是有限值。
+ */
+struct SimulationParamField {
+    const char* name;
+    float SimulationParams::* member;
+    float minValue;
+    float maxValue;
+};
+
+inline const std::array<SimulationParamField, 6>& getSimulationParamFields() {
+    static const std::array<SimulationParamField, 6> fields = {{
+        {"hearingThreshold", &SimulationParams::hearingThreshold, 0.01f, 1000.0f},
+        {"twinLureThreshold", &SimulationParams::twinLureThreshold, 0.01f, 1000.0f},
+        {"airAttenuation", &SimulationParams::airAttenuation, 0.001f, 10.0f},
+        {"wallAttenuationMult", &SimulationParams::wallAttenuationMult, 0.01f, 0.99f},
+        {"ghostChaseSpeed", &SimulationParams::ghostChaseSpeed, 0.1f, 20.0f},
+        {"freezeDuration", &SimulationParams::freezeDuration, 0.0f, 60.0f}
+    }};
+    return fields;
+}
+
+// 按名字找参数表项；名字不存在时返回 nullptr
+inline const SimulationParamField* findSimulationParamField(const char* name) {
+    for (const auto& field : getSimulationParamFields()) {
+        if (std::strcmp(field.name, name) == 0) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+// 按名字找参数；名字不存在时返回 nullptr
+inline float* findSimulationParam(SimulationParams& params, const char* name) {
+    const SimulationParamField* field = findSimulationParamField(name);
+    return field ? &(params.*(field->member)) : nullptr;
+}
@@ -0,0 +1,82 @@
+#include "SimulationSnapshot.h"
+#include "Logger.h"
+#include <fstream>
+#include <iterator>
+
+/**
+ * 快照文件就是快照的字节本身（头部里已经有魔数、版本和步数）
+ */
+bool SimulationSnapshot::saveToFile(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG_ERROR("ERROR: Cannot create snapshot file: " << filename);
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    LOG_INFO("Snapshot saved: " << filename << " (step " << step << ", " << data.size() << " bytes)");
+    return true;
+}
+
+bool SimulationSnapshot::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        LOG_ERROR("ERROR: Cannot open snapshot file: " << filename);
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+    // 只检查头部，其余部分由 Simulation::restoreSnapshot 验证
+    SnapshotReader in(data.data(), data.size());
+    char magic[4] = {};
+    std::uint32_t version = 0;
+    in.read(magic);
+    in.read(version);
+    in.read(step);
+    if (!in.isOk() || std::memcmp(magic, MAGIC, sizeof(magic)) != 0) {
+        LOG_ERROR("ERROR: Not a valid snapshot file: " << filename);
+        data.clear();
+        return false;
+    }
+    if (version != VERSION) {
+        LOG_ERROR("ERROR: Snapshot file version " << version << " is not supported (expected "
+                  << VERSION << "): " << filename);
+        data.clear();
+        return false;
+    }
+    LOG_INFO("Snapshot loaded: " << filename << " (step " << step << ")");
+    return true;
+}
+
+// ==================== SnapshotRing ====================
+
+SnapshotRing::SnapshotRing(std::size_t capacity)
+    : slots(capacity > 0 ? capacity : 1)
+    , next(0)
+    , count(0)
+{
+}
+
+SimulationSnapshot& SnapshotRing::push() {
+    SimulationSnapshot& slot = slots[next];
+    next = (next + 1) % slots.size();
+    if (count < slots.size()) {
+        count++;
+    }
+    return slot;
+}
+
+const SimulationSnapshot* SnapshotRing::fromNewest(std::size_t age) const {
+    if (age >= count) {
+        return nullptr;
+    }
+    std::size_t index = (next + slots.size() - 1 - age) % slots.size();
+    return &slots[index];
+}
+
+void SnapshotRing::dropNewest() {
+    if (count == 0) {
+        return;
+    }
+    next = (next + slots.size() - 1) % slots.size();
+    count--;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * SnapshotWriter / SnapshotReader：快照的二进制读写
+ *
+ * 每个字段按内存表示原样拷贝（memcpy），没有格式化和分支，
+ * 整个模拟状态约 600 字节（level1；逃生路径和刺激多时略大），保存和恢复都在微秒级。
+ * 字节序和对齐跟随平台：快照用于同一程序内的重开/回退，
+ * 写成文件时只保证同平台、同版本可读（见 SimulationSnapshot::VERSION）。
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<unsigned char>& buffer) : buffer(buffer) {}
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        std::size_t offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    // 数组：元素个数 + 元素
+    template <typename T>
+    void writeVector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        write(static_cast<std::uint32_t>(values.size()));
+        std::size_t offset = buffer.size();
+        buffer.resize(offset + values.size() * sizeof(T));
+        if (!values.empty()) {
+            std::memcpy(buffer.data() + offset, values.data(), values.size() * sizeof(T));
+        }
+    }
+
+private:
+    std::vector<unsigned char>& buffer;
+};
+
+class SnapshotReader {
+public:
+    SnapshotReader(const unsigned char* data, std::size_t size) : data(data), size(size), offset(0), ok(true) {}
+
+    // 读失败（数据不够）后所有读取都返回 false，调用者最后检查一次 isOk 即可
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        if (!ok || size - offset < sizeof(T)) {
+            ok = false;
+            return false;
+        }
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool readVector(std::vector<T>& values) {
+        std::uint32_t count = 0;
+        if (!read(count) || (size - offset) / sizeof(T) < count) {
+            ok = false;
+            return false;
+        }
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), data + offset, count * sizeof(T));
+        }
+        offset += count * sizeof(T);
+        return true;
+    }
+
+    bool isOk() const { return ok; }
+    bool atEnd() const { return offset == size; }
+
+private:
+    const unsigned char* data;
+    std::size_t size;
+    std::size_t offset;
+    bool ok;
+};
+
+/**
+ * 一份完整的模拟状态（Simulation::saveSnapshot 写入，restoreSnapshot 读取）
+ *
+ * 格式：魔数 "HMSS" + 版本 + 步数 + 地图尺寸 + 各对象的字段。
+ * 地图本身只读、在实例之间共享，不存进快照（恢复时检查尺寸一致）。
+ * 缓冲区反复使用：同一个快照对象第二次保存起不再分配内存。
+ */
+struct SimulationSnapshot {
+    static constexpr char MAGIC[4] = {'H', 'M', 'S', 'S'};
+    static constexpr std::uint32_t VERSION = 1;  // 任何被保存对象的字段变化时加1
+
+    std::vector<unsigned char> data;
+    std::uint64_t step = 0;     // 保存时的步数（和 Simulation::getStepCount 相同）
+
+    bool empty() const { return data.empty(); }
+
+    bool saveToFile(const std::string& filename) const;
+    bool loadFromFile(const std::string& filename);
+};
+
+/**
+ * SnapshotRing：固定容量的快照环形缓冲区
+ *
+ * 满了以后新快照覆盖最旧的，槽位的缓冲区一直复用。
+ * 用于定时存档（回退到几秒前）、慢帧前的状态（性能分析时回到现场）。
+ */
+class SnapshotRing {
+public:
+    explicit SnapshotRing(std::size_t capacity);
+
+    // 取得下一个要写入的槽位（覆盖最旧的），由调用者填入快照
+    SimulationSnapshot& push();
+
+    // 最新的往前数第 age 个（0 = 最新）；不存在时返回 nullptr
+    const SimulationSnapshot* fromNewest(std::size_t age) const;
+
+    // 丢弃最新的一个（回退之后，比当前状态更新的快照不再有意义）
+    void dropNewest();
+
+    void clear() { count = 0; }
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return slots.size(); }
+
+private:
+    std::vector<SimulationSnapshot> slots;
+    std::size_t next;     // 下一个写入的槽位
+    std::size_t count;    // 有效快照数
+};
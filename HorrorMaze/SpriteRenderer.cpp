@@ -0,0 +1,161 @@
+#include "SpriteRenderer.h"
+#include "Player.h"
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * 画出本帧收集的所有 billboard
+ *
+ * 算法原理（DOOM式sprite渲染）：
+ * 1. 计算 billboard 相对于玩家的位置（世界坐标 → 相机坐标）
+ * 2. 投影到屏幕空间，根据距离计算大小
+ * 3. 从远到近逐个处理，用深度金字塔找出比墙近的列段（整个被挡住时 O(log 宽度) 就能排除）
+ * 4. 每个列段一个四边形，追加进对应纹理的批次，最后按批次顺序绘制
+ */
+void SpriteRenderer::render(sf::RenderWindow& window, const Player& player,
+                            const DepthPyramid& depth, int screenHeight, float horizon) {
+    const int screenWidth = depth.getWidth();
+    const int horizonY = static_cast<int>(horizon);
+
+    // === 步骤1、2：变换到相机坐标系并投影 ===
+    float invDet = 1.0f / (player.getPlaneX() * player.getDirY() - player.getDirX() * player.getPlaneY());
+
+    projected.clear();
+    for (const Billboard& billboard : billboards) {
+        float spriteX = billboard.x - player.getX();
+        float spriteY = billboard.y - player.getY();
+
+        float transformX = invDet * (player.getDirY() * spriteX - player.getDirX() * spriteY);
+        float transformY = invDet * (-player.getPlaneY() * spriteX + player.getPlaneX() * spriteY);
+
+        if (transformY <= 0.1f) {
+            continue;  // 在玩家背后或太近，不渲染
+        }
+
+        int size = static_cast<int>(screenHeight / transformY * billboard.scale);
+        if (size <= 0) {
+            continue;
+        }
+        int screenX = static_cast<int>((screenWidth / 2) * (1 + transformX / transformY));
+        projected.push_back({&billboard, transformY, screenX, size});
+    }
+
+    // 从远到近（距离相同时保持收集顺序，画面逐帧稳定）
+    std::stable_sort(projected.begin(), projected.end(),
+                     [](const Projected& a, const Projected& b) { return a.depth > b.depth; });
+
+    for (std::size_t i = 0; i < batchCount; i++) {
+        batches[i].vertices.clear();
+    }
+    batchCount = 0;
+
+    // === 步骤3、4：深度测试，按列段生成四边形 ===
+    for (const Projected& sprite : projected) {
+        const Billboard& billboard = *sprite.billboard;
+
+        int left = -sprite.size / 2 + sprite.screenX;
+        int drawStartX = std::max(0, left);
+        int drawEndX = std::min(screenWidth, sprite.size / 2 + sprite.screenX);
+
+        // 可见列段（完全被墙挡住时不占批次）
+        int lastX = drawEndX - 1;
+        runs.clear();
+        int x = depth.findVisible(drawStartX, lastX, sprite.depth);
+        while (x <= lastX) {
+            int runEnd = depth.findHidden(x, lastX, sprite.depth);
+            runs.push_back({x, runEnd});
+            x = depth.findVisible(runEnd, lastX, sprite.depth);
+        }
+        if (runs.empty()) {
+            continue;
+        }
+
+        // 垂直位置：超出屏幕的部分由 SFML 裁剪，纹理不会被压扁
+        int drawStartY = -sprite.size / 2 + horizonY + static_cast<int>(sprite.size * billboard.drop);
+        float top = static_cast<float>(drawStartY);
+        float bottom = static_cast<float>(drawStartY + sprite.size);
+
+        sf::Color color = billboard.color;
+        float textureWidth = 0.0f;
+        float textureHeight = 0.0f;
+        if (billboard.texture) {
+            // 根据距离调整亮度
+            float brightness = 1.0f / (1.0f + sprite.depth * 0.1f);
+            brightness = std::max(0.3f, std::min(1.0f, brightness));
+
+            // 打火机开启时降低亮度（让鬼更隐蔽）
+            if (billboard.dimWithLighter && player.isLighterOn()) {
+                brightness *= 0.5f;
+            }
+
+            std::uint8_t colorValue = static_cast<std::uint8_t>(255 * brightness);
+            color = sf::Color(colorValue, colorValue, colorValue);
+
+            sf::Vector2u texSize = billboard.texture->getSize();
+            textureWidth = static_cast<float>(texSize.x);
+            textureHeight = static_cast<float>(texSize.y);
+        }
+        float texelsPerColumn = textureWidth / sprite.size;
+
+        Batch& batch = batchFor(billboard.texture, runs.front().x, runs.back().y - 1);
+        for (const sf::Vector2i& run : runs) {
+            appendQuad(batch.vertices, static_cast<float>(run.x), static_cast<float>(run.y), top, bottom,
+                       (run.x - left) * texelsPerColumn, (run.y - left) * texelsPerColumn, textureHeight, color);
+        }
+    }
+
+    for (std::size_t i = 0; i < batchCount; i++) {
+        sf::RenderStates states;
+        states.texture = batches[i].texture;
+        window.draw(batches[i].vertices, states);
+    }
+}
+
+SpriteRenderer::Batch& SpriteRenderer::batchFor(const sf::Texture* texture, int minX, int maxX) {
+    // 从最新的批次往前找：遇到同纹理的就并进去；
+    // 遇到和它横向重叠的其他纹理批次就停下（那一批更近，必须画在后面）
+    for (std::size_t i = batchCount; i-- > 0;) {
+        Batch& batch = batches[i];
+        if (batch.texture == texture) {
+            batch.minX = std::min(batch.minX, minX);
+            batch.maxX = std::max(batch.maxX, maxX);
+            return batch;
+        }
+        if (batch.minX <= maxX && minX <= batch.maxX) {
+            break;
+        }
+    }
+
+    if (batchCount == batches.size()) {
+        batches.emplace_back();
+    }
+    Batch& batch = batches[batchCount++];
+    batch.texture = texture;
+    batch.minX = minX;
+    batch.maxX = maxX;
+    return batch;
+}
+
+void SpriteRenderer::appendQuad(sf::VertexArray& vertices, float x0, float x1, float y0, float y1,
+                                float u0, float u1, float textureHeight, sf::Color color) {
+    sf::Vertex corners[4];
+    corners[0].position = {x0, y0};
+    corners[0].texCoords = {u0, 0.0f};
+    corners[1].position = {x1, y0};
+    corners[1].texCoords = {u1, 0.0f};
+    corners[2].position = {x0, y1};
+    corners[2].texCoords = {u0, textureHeight};
+    corners[3].position = {x1, y1};
+    corners[3].texCoords = {u1, textureHeight};
+    for (sf::Vertex& corner : corners) {
+        corner.color = color;
+    }
+
+    // 两个三角形
+    vertices.append(corners[0]);
+    vertices.append(corners[1]);
+    vertices.append(corners[2]);
+    vertices.append(corners[2]);
+    vertices.append(corners[1]);
+    vertices.append(corners[3]);
+}
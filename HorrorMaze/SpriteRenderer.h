@@ -0,0 +1,71 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include "DepthPyramid.h"
+#include <cstddef>
+#include <vector>
+
+class Player;
+
+/**
+ * SpriteRenderer：第一人称的 billboard（鬼、双胞胎、以后的道具）统一绘制
+ *
+ * 每帧先 add 收集本帧所有 billboard，再 render 一次画完：
+ * 1. 统一变换到相机坐标系，按距离从远到近排序（近的盖住远的）
+ * 2. 用深度金字塔找出比墙近的列段（整块挡住/整块可见的直接跳过），每段一个四边形
+ * 3. 四边形按纹理追加进顶点数组，整层 sprite 每种纹理通常只画一次
+ *
+ * 不同纹理的 sprite 在屏幕上横向重叠时，远的那批必须先画：
+ * 一个 sprite 只能并进“之后没有和它重叠的其他纹理批次”的同纹理批次，
+ * 否则另开一批。顶点数组跨帧复用，开销只和可见的列段数有关。
+ */
+class SpriteRenderer {
+public:
+    struct Billboard {
+        float x, y;                          // 世界坐标（格子单位）
+        const sf::Texture* texture;          // nullptr：画成纯色块（纹理没加载时）
+        float scale;                         // 高度相对同距离墙高的比例
+        float drop;                          // 向下偏移（占 sprite 高度的比例，让鬼“站”在地上）
+        bool dimWithLighter;                 // 打火机开启时亮度减半
+        sf::Color color;                     // 纯色块的颜色（有纹理时不用）
+    };
+
+    SpriteRenderer() = default;
+
+    // 开始新的一帧（清空上一帧收集的 billboard）
+    void clear() { billboards.clear(); }
+
+    void add(const Billboard& billboard) { billboards.push_back(billboard); }
+
+    // 画出本帧收集的所有 billboard（depth：本帧的深度金字塔；horizon：地平线高度）
+    void render(sf::RenderWindow& window, const Player& player,
+                const DepthPyramid& depth, int screenHeight, float horizon);
+
+private:
+    // 投影到屏幕后的 billboard
+    struct Projected {
+        const Billboard* billboard;
+        float depth;                         // 相机坐标系的深度（排序、深度测试用）
+        int screenX;                         // 中心所在的屏幕列
+        int size;                            // 屏幕上的高度和宽度（像素）
+    };
+
+    // 同一纹理的一批四边形（一次 draw call）
+    struct Batch {
+        const sf::Texture* texture;
+        int minX, maxX;                      // 批内所有四边形覆盖的屏幕列范围
+        sf::VertexArray vertices{sf::PrimitiveType::Triangles};
+    };
+
+    std::vector<Billboard> billboards;
+    std::vector<Projected> projected;
+    std::vector<sf::Vector2i> runs;          // 当前 sprite 的可见列段 [x, y)
+    std::vector<Batch> batches;              // 跨帧复用，前 batchCount 个是本帧的
+    std::size_t batchCount = 0;
+
+    // 找一个可以追加 [minX, maxX] 的同纹理批次（保持远近顺序），没有时新开一批
+    Batch& batchFor(const sf::Texture* texture, int minX, int maxX);
+
+    // 追加一个 x0..x1 列、y0..y1 行的四边形（u0/u1：两侧的纹理列）
+    static void appendQuad(sf::VertexArray& vertices, float x0, float x1, float y0, float y1,
+                           float u0, float u1, float textureHeight, sf::Color color);
+};
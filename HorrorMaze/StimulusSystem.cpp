@@ -0,0 +1,263 @@
+#include "StimulusSystem.h"
+#include "GridTrace.h"
+#include "SimulationParams.h"
+#include "SimulationSnapshot.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+StimulusSystem::StimulusSystem()
+    : bucketsX(0)
+    , bucketsY(0)
+    , maxIntensity(0.0f)
+    , airAttenuation(SimulationParams().airAttenuation)
+    , wallAttenuationMult(SimulationParams().wallAttenuationMult)
+{
+}
+
+/**
+ * 负数和 NaN 按 0 处理（0 = 空气不衰减 / 一堵墙就完全隔音），墙倍数最大为 1（穿墙不会放大声音，
+ * findStrongest 的各种提前跳过都依赖这一点）。空气不衰减时查询扫描所有桶，墙倍数为 1 时数墙不设上限
+ */
+void StimulusSystem::setAttenuation(float air, float wallMult) {
+    airAttenuation = (air > 0.0f) ? air : 0.0f;
+    wallAttenuationMult = (wallMult > 0.0f) ? std::min(wallMult, 1.0f) : 0.0f;
+}
+
+void StimulusSystem::resize(int mapWidth, int mapHeight) {
+    bucketsX = std::max(1, (mapWidth + BUCKET_SIZE - 1) / BUCKET_SIZE);
+    bucketsY = std::max(1, (mapHeight + BUCKET_SIZE - 1) / BUCKET_SIZE);
+    buckets.assign(static_cast<std::size_t>(bucketsX) * bucketsY, std::vector<int>());
+    bucketMaxIntensity.assign(buckets.size(), 0.0f);
+    clear();
+}
+
+void StimulusSystem::clear() {
+    stimuli.clear();
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    std::fill(bucketMaxIntensity.begin(), bucketMaxIntensity.end(), 0.0f);
+    maxIntensity = 0.0f;
+}
+
+/**
+ * 投递刺激：直接追加到所在的桶
+ */
+void StimulusSystem::emit(StimulusType type, float x, float y, float intensity, float duration, bool fades) {
+    if (intensity <= 0.0f || buckets.empty()) {
+        return;
+    }
+
+    Stimulus s;
+    s.type = type;
+    s.x = x;
+    s.y = y;
+    s.intensity = intensity;
+    s.duration = duration;
+    s.age = 0.0f;
+    s.fades = fades;
+
+    int bucket = bucketIndexAt(x, y);
+    buckets[bucket].push_back(static_cast<int>(stimuli.size()));
+    stimuli.push_back(s);
+    bucketMaxIntensity[bucket] = std::max(bucketMaxIntensity[bucket], intensity);
+    maxIntensity = std::max(maxIntensity, intensity);
+}
+
+/**
+ * 推进时间：只存在一帧的刺激（duration <= 0）和到期的刺激被移除
+ */
+void StimulusSystem::update(float deltaTime) {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < stimuli.size(); i++) {
+        Stimulus& s = stimuli[i];
+        s.age += deltaTime;
+        if (s.duration > 0.0f && s.age < s.duration) {
+            stimuli[kept++] = s;
+        }
+    }
+
+    if (kept != stimuli.size()) {
+        stimuli.resize(kept);
+        rebuildBuckets();
+    }
+}
+
+/**
+ * 查询最强刺激
+ *
+ * 1. 查询半径：最强的刺激在没有墙时衰减到最低阈值的距离，只查这个范围内的桶
+ * 2. 每个桶再按桶内最强的刺激算自己的可达距离，听者离桶比这个还远就整桶跳过
+ *    （一声很响的台词不会让整张图上的脚步声桶都被扫一遍）
+ * 3. 只靠空气衰减都不可能超过当前最强值（或阈值）的刺激直接跳过
+ * 4. 数墙时最多数到"再多一堵就不可能胜出"为止（StopAfterWalls）
+ *
+ * 空气不衰减（airAttenuation == 0）时没有查询半径，1、2 不做，扫描所有桶；
+ * 墙不衰减（wallAttenuationMult == 1）时 4 不做，数完整条线。
+ */
+bool StimulusSystem::findStrongest(const WallBitmap& walls, float listenerX, float listenerY,
+                                   const Thresholds& thresholds, HeardStimulus& out) const {
+    if (stimuli.empty()) {
+        return false;
+    }
+
+    float minThreshold = *std::min_element(thresholds.begin(), thresholds.end());
+    minThreshold = std::max(minThreshold, 0.001f);
+    if (maxIntensity < minThreshold) {
+        return false;
+    }
+
+    // 半径超过整张图时按整张图算（airAttenuation 很小时半径可能是 inf，不能直接转成 int）
+    const bool bounded = (airAttenuation > 0.0f);
+    const float mapExtent = static_cast<float>((bucketsX + bucketsY) * BUCKET_SIZE);
+    float radius = bounded ? (maxIntensity / minThreshold - 1.0f) / airAttenuation : mapExtent;
+    radius = std::min(radius, mapExtent);
+
+    int bx0 = std::max(0, static_cast<int>(std::max(listenerX - radius, 0.0f) / BUCKET_SIZE));
+    int by0 = std::max(0, static_cast<int>(std::max(listenerY - radius, 0.0f) / BUCKET_SIZE));
+    int bx1 = std::min(bucketsX - 1, static_cast<int>(std::min(listenerX + radius, mapExtent) / BUCKET_SIZE));
+    int by1 = std::min(bucketsY - 1, static_cast<int>(std::min(listenerY + radius, mapExtent) / BUCKET_SIZE));
+
+    // 每堵墙的对数衰减（一堵墙就隔音时是 inf）；为 0（墙不衰减）时数墙不设上限
+    const float wallFactor = (wallAttenuationMult > 0.0f) ? std::log(1.0f / wallAttenuationMult)
+                                                          : std::numeric_limits<float>::infinity();
+    const int NO_WALL_CAP = 1 << 20;
+    int listenerGX = static_cast<int>(listenerX);
+    int listenerGY = static_cast<int>(listenerY);
+    bool found = false;
+    float best = 0.0f;
+
+    for (int by = by0; by <= by1; by++) {
+        // 听者到桶的最近距离（边缘的桶向外不设边界：地图外的刺激也归在边缘桶里）
+        float nearY = 0.0f;
+        if (by > 0 && listenerY < by * BUCKET_SIZE) {
+            nearY = by * BUCKET_SIZE - listenerY;
+        } else if (by < bucketsY - 1 && listenerY > (by + 1) * BUCKET_SIZE) {
+            nearY = listenerY - (by + 1) * BUCKET_SIZE;
+        }
+        for (int bx = bx0; bx <= bx1; bx++) {
+            std::size_t bucket = static_cast<std::size_t>(by) * bucketsX + bx;
+            if (bucketMaxIntensity[bucket] < minThreshold) {
+                continue;
+            }
+            float reach = bounded ? (bucketMaxIntensity[bucket] / minThreshold - 1.0f) / airAttenuation : mapExtent;
+            float nearX = 0.0f;
+            if (bx > 0 && listenerX < bx * BUCKET_SIZE) {
+                nearX = bx * BUCKET_SIZE - listenerX;
+            } else if (bx < bucketsX - 1 && listenerX > (bx + 1) * BUCKET_SIZE) {
+                nearX = listenerX - (bx + 1) * BUCKET_SIZE;
+            }
+            if (nearX * nearX + nearY * nearY > reach * reach) {
+                continue;
+            }
+
+            for (int index : buckets[bucket]) {
+                const Stimulus& s = stimuli[index];
+
+                float dx = s.x - listenerX;
+                float dy = s.y - listenerY;
+                float distance = std::sqrt(dx * dx + dy * dy);
+                float level = s.currentIntensity() / (1.0f + distance * airAttenuation);
+
+                float minLevel = std::max(thresholds[static_cast<int>(s.type)], found ? best : 0.0f);
+                if (level <= minLevel) {
+                    continue;
+                }
+
+                // 超过 maxWalls 堵墙后强度一定不超过 minLevel，数到 maxWalls+1 就可以停
+                int maxWalls = NO_WALL_CAP;
+                if (wallFactor > 0.0f && minLevel > 0.0f) {
+                    float wallBudget = std::log(level / minLevel) / wallFactor;
+                    maxWalls = (wallBudget < NO_WALL_CAP) ? static_cast<int>(wallBudget) : NO_WALL_CAP;
+                }
+                int wallCount = GridTrace::trace(
+                    walls, listenerGX, listenerGY,
+                    static_cast<int>(s.x), static_cast<int>(s.y),
+                    GridTrace::StopAfterWalls(maxWalls + 1)).walls;
+                if (wallCount > maxWalls) {
+                    continue;
+                }
+
+                for (int i = 0; i < wallCount; i++) {
+                    level *= wallAttenuationMult;
+                }
+                if (level <= minLevel) {
+                    continue;
+                }
+
+                found = true;
+                best = level;
+                out.type = s.type;
+                out.level = level;
+                out.x = s.x;
+                out.y = s.y;
+            }
+        }
+    }
+    return found;
+}
+
+int StimulusSystem::bucketIndexAt(float x, float y) const {
+    int bx = std::min(bucketsX - 1, std::max(0, static_cast<int>(x) / BUCKET_SIZE));
+    int by = std::min(bucketsY - 1, std::max(0, static_cast<int>(y) / BUCKET_SIZE));
+    return by * bucketsX + bx;
+}
+
+void StimulusSystem::rebuildBuckets() {
+    for (auto& bucket : buckets) {
+        bucket.clear();
+    }
+    std::fill(bucketMaxIntensity.begin(), bucketMaxIntensity.end(), 0.0f);
+    maxIntensity = 0.0f;
+    for (std::size_t i = 0; i < stimuli.size(); i++) {
+        const Stimulus& s = stimuli[i];
+        int bucket = bucketIndexAt(s.x, s.y);
+        buckets[bucket].push_back(static_cast<int>(i));
+        bucketMaxIntensity[bucket] = std::max(bucketMaxIntensity[bucket], s.intensity);
+        maxIntensity = std::max(maxIntensity, s.intensity);
+    }
+}
+
+/**
+ * 快照：刺激逐个字段写入（结构体有填充字节，不整体拷贝，保证同样的状态得到同样的字节）
+ */
+void StimulusSystem::saveState(SnapshotWriter& out) const {
+    out.write(static_cast<std::uint32_t>(stimuli.size()));
+    for (const Stimulus& s : stimuli) {
+        out.write(s.type);
+        out.write(s.x);
+        out.write(s.y);
+        out.write(s.intensity);
+        out.write(s.duration);
+        out.write(s.age);
+        out.write(s.fades);
+    }
+    out.write(maxIntensity);
+}
+
+bool StimulusSystem::loadState(SnapshotReader& in) {
+    std::uint32_t count = 0;
+    if (!in.read(count)) {
+        return false;
+    }
+    stimuli.clear();
+    for (std::uint32_t i = 0; i < count && in.isOk(); i++) {
+        Stimulus s;
+        in.read(s.type);
+        in.read(s.x);
+        in.read(s.y);
+        in.read(s.intensity);
+        in.read(s.duration);
+        in.read(s.age);
+        in.read(s.fades);
+        stimuli.push_back(s);
+    }
+    if (!in.isOk() || buckets.empty()) {
+        stimuli.clear();
+        return false;
+    }
+    rebuildBuckets();
+    in.read(maxIntensity);
+    return in.isOk();
+}
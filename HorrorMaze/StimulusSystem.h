@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "WallBitmap.h"
+
+class SnapshotWriter;
+class SnapshotReader;
+
+/**
+ * 刺激（声音事件）类型
+ */
+enum class StimulusType {
+    Footstep,    // 玩家脚步声（强度取决于移动模式）
+    TwinVoice,   // 双胞胎台词（随时间线性衰减）
+    Count
+};
+
+/**
+ * 一个带位置和寿命的刺激
+ */
+struct Stimulus {
+    StimulusType type;
+    float x, y;          // 发声位置
+    float intensity;     // 初始强度
+    float duration;      // 持续时间（<= 0 表示只存在一帧）
+    float age;           // 已存在时间
+    bool fades;          // 是否随时间线性衰减到0
+
+    // 当前强度
+    float currentIntensity() const {
+        if (!fades || duration <= 0.0f) {
+            return intensity;
+        }
+        float ratio = 1.0f - age / duration;
+        return (ratio > 0.0f) ? intensity * ratio : 0.0f;
+    }
+};
+
+/**
+ * 听者感知到的最强刺激
+ */
+struct HeardStimulus {
+    StimulusType type;
+    float level;         // 衰减后的强度
+    float x, y;          // 发声位置
+};
+
+/**
+ * StimulusSystem：刺激系统
+ *
+ * 发声方（玩家脚步、双胞胎、以后的道具）把带位置和寿命的刺激投递进来，
+ * 刺激按所在格子分桶存放（每桶 BUCKET_SIZE × BUCKET_SIZE 格）。
+ * 听者只查询可能听得到的那些桶，取衰减后最强的一个。
+ *
+ * 衰减规则（和原来的玩家声音/双胞胎声音一致）：
+ *   S = S0 / (1 + 距离 × airAttenuation)
+ *   每穿过一堵墙 S ×= wallAttenuationMult
+ * 两个系数默认取 SimulationParams 的默认值，批量模拟调参时用 setAttenuation 修改。
+ */
+class StimulusSystem {
+public:
+    static constexpr int BUCKET_SIZE = 8;                   // 每个桶的边长（格）
+
+    // 每种刺激的听觉阈值（按 StimulusType 下标）
+    using Thresholds = std::array<float, static_cast<int>(StimulusType::Count)>;
+
+    StimulusSystem();
+
+    // 按地图尺寸重建桶（加载地图后调用），同时清空所有刺激
+    void resize(int mapWidth, int mapHeight);
+
+    // 设置衰减系数（空气中每单位距离的衰减系数 >= 0、每堵墙的衰减倍数 0..1，超出范围的值被截断）
+    void setAttenuation(float air, float wallMult);
+
+    // 清空所有刺激（重新开始游戏时调用）
+    void clear();
+
+    // 投递一个刺激
+    void emit(StimulusType type, float x, float y, float intensity, float duration, bool fades = false);
+
+    // 推进时间并移除过期的刺激（每帧开始时调用）
+    void update(float deltaTime);
+
+    /**
+     * 查询听者位置能听到的最强刺激
+     *
+     * @param thresholds 每种刺激的听觉阈值，衰减后强度必须大于阈值
+     * @return 是否听到了任何刺激
+     */
+    bool findStrongest(const WallBitmap& walls, float listenerX, float listenerY,
+                       const Thresholds& thresholds, HeardStimulus& out) const;
+
+    std::size_t getCount() const { return stimuli.size(); }
+
+    // 快照：只保存刺激本身，桶在恢复时重建（桶的划分由地图尺寸决定）
+    void saveState(SnapshotWriter& out) const;
+    bool loadState(SnapshotReader& in);
+
+private:
+    int bucketsX;
+    int bucketsY;
+    std::vector<Stimulus> stimuli;
+    std::vector<std::vector<int>> buckets;   // 每个桶里的刺激下标
+    std::vector<float> bucketMaxIntensity;   // 每个桶里刺激的最大强度（决定这个桶的可达距离）
+    float maxIntensity;                      // 当前所有刺激的最大强度（决定查询半径）
+    float airAttenuation;
+    float wallAttenuationMult;
+
+    int bucketIndexAt(float x, float y) const;
+    void rebuildBuckets();
+};
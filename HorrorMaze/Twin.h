@@ -1,8 +1,12 @@
 #pragma once
-#include <SFML/Graphics.hpp>
 #include <string>
+#include <vector>
 
 class Player;
+class SnapshotWriter;
+class SnapshotReader;
+class SpriteRenderer;
+namespace sf { class RenderWindow; class Texture; }
 
 /**
  * Twin类：双胞胎陷阱
@@ -27,7 +31,7 @@ public:
     float getX() const { return x; }
     float getY() const { return y; }
 
-    // 获取声音强度（用于吸引鬼）
+    // 获取当前声音强度（随时间衰减；吸引鬼的声音由 StimulusSystem 负责）
     float getSoundLevel() const;
 
     // 是否已被触发
@@ -36,13 +40,15 @@ public:
     // 更新状态（声音衰减）
     void update(float deltaTime);
 
-    // 渲染（俯视图）
+    // 快照：保存/恢复状态（见 SimulationSnapshot.h）
+    void saveState(SnapshotWriter& out) const;
+    bool loadState(SnapshotReader& in);
+
+    // 渲染（俯视图，渲染函数都定义在 TwinRender.cpp）
     void renderTopDown(sf::RenderWindow& window, float cellSize) const;
 
-    // 渲染（第一人称）
-    void renderFirstPerson(sf::RenderWindow& window, const Player& player,
-                          int screenWidth, int screenHeight,
-                          const std::vector<float>& zBuffer) const;
+    // 渲染（第一人称：作为 billboard 交给 SpriteRenderer）
+    void addBillboard(SpriteRenderer& sprites) const;
 
     // 加载sprite纹理（所有双胞胎共享）
     static bool loadSpriteTexture(const std::string& filename);
@@ -50,6 +56,9 @@ public:
     // 获取默认声音持续时长
     static float getDefaultSoundDuration() { return SOUND_DURATION; }
 
+    // 激活瞬间的声音强度（投递给刺激系统，之后随时间线性衰减）
+    static float getPeakSoundLevel() { return SOUND_LEVEL; }
+
 private:
     float x, y;  // 双胞胎位置（格子中心）
     bool activated;  // 是否已被触发
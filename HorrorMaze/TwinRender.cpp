@@ -0,0 +1,70 @@
+#include "Twin.h"
+#include "Logger.h"
+#include "SpriteRenderer.h"
+#include <SFML/Graphics.hpp>
+
+// Twin 的绘制部分和共享纹理（只有游戏程序编译；模拟核心和无头程序不依赖图形模块）
+
+// 静态成员初始化
+sf::Texture Twin::s_spriteTexture;
+bool Twin::s_textureLoaded = false;
+
+/**
+ * 渲染双胞胎（俯视图）
+ */
+void Twin::renderTopDown(sf::RenderWindow& window, float cellSize) const {
+    // 保持在激活期间仍然渲染（图像在声效结束后消失）
+    // 如果已经激活但声音结束，则隐藏
+    if (activated && soundTimer <= 0.0f) {
+        return;
+    }
+
+    // 绘制双胞胎方块（未触发时为紫色）
+    float size = cellSize * 0.6f;
+    sf::RectangleShape twinSquare({size, size});
+    twinSquare.setFillColor(sf::Color(150, 50, 150));  // 紫色（醒目）
+
+    twinSquare.setOrigin({size / 2, size / 2});
+    twinSquare.setPosition({x * cellSize, y * cellSize});
+
+    window.draw(twinSquare);
+}
+
+/**
+ * 加载双胞胎sprite纹理（所有双胞胎共享）
+ */
+bool Twin::loadSpriteTexture(const std::string& filename) {
+    if (s_textureLoaded) {
+        return true;  // 已经加载过了
+    }
+
+    if (s_spriteTexture.loadFromFile(filename)) {
+        s_textureLoaded = true;
+        LOG_INFO("Twin sprite loaded: " << filename);
+        return true;
+    }
+
+    LOG_WARN("Failed to load twin sprite: " << filename);
+    return false;
+}
+
+/**
+ * 渲染双胞胎（第一人称）：交给 SpriteRenderer 统一投影、深度测试和合批
+ * 使用sprite纹理渲染（如果已加载），否则画成紫色半透明色块
+ */
+void Twin::addBillboard(SpriteRenderer& sprites) const {
+    // 保持在激活期间仍然渲染（图像在声效结束后消失）
+    if (activated && soundTimer <= 0.0f) {
+        return;
+    }
+
+    SpriteRenderer::Billboard billboard;
+    billboard.x = x;
+    billboard.y = y;
+    billboard.texture = s_textureLoaded ? &s_spriteTexture : nullptr;
+    billboard.scale = 0.5f;
+    billboard.drop = 0.0f;
+    billboard.dimWithLighter = false;
+    billboard.color = sf::Color(150, 50, 150, 200);  // 紫色
+    sprites.add(billboard);
+}
@@ -0,0 +1,126 @@
+#include "UpdateScheduler.h"
+#include "SimulationSnapshot.h"
+#include <algorithm>
+
+UpdateScheduler::UpdateScheduler()
+    : entityCount(0)
+    , clock(0.0)
+{
+}
+
+UpdateScheduler::ChannelId UpdateScheduler::addChannel(const std::string& name, float rateHz) {
+    Channel c;
+    c.name = name;
+    c.rateHz = rateHz;
+    c.budget = 0.0f;
+    c.cursor = 0;
+    c.dueBegin = 0;
+    c.dueCount = 0;
+    c.lastRun.assign(entityCount, clock);
+    channels.push_back(c);
+    return static_cast<ChannelId>(channels.size() - 1);
+}
+
+void UpdateScheduler::setRate(ChannelId channel, float rateHz) {
+    channels[channel].rateHz = rateHz;
+}
+
+float UpdateScheduler::getRate(ChannelId channel) const {
+    return channels[channel].rateHz;
+}
+
+const std::string& UpdateScheduler::getName(ChannelId channel) const {
+    return channels[channel].name;
+}
+
+void UpdateScheduler::reset() {
+    entityCount = 0;
+    for (auto& c : channels) {
+        c.budget = 0.0f;
+        c.cursor = 0;
+        c.dueBegin = 0;
+        c.dueCount = 0;
+        c.lastRun.clear();
+    }
+}
+
+/**
+ * 推进时钟并为每个通道切出本帧到期的实体
+ *
+ * 低频通道：budget += 实体数 × 频率 × dt，取整数部分作为本帧要处理的数量，
+ * 从游标处开始连续取（环绕），小数部分留到下一帧。
+ * budget 上限为实体数，卡顿后不会一帧内把同一个实体更新多次。
+ */
+void UpdateScheduler::beginFrame(float deltaTime, std::size_t count) {
+    clock += deltaTime;
+
+    if (count != entityCount) {
+        // 新增实体从当前时刻开始计时；实体减少时游标收回到范围内
+        for (auto& c : channels) {
+            c.lastRun.resize(count, clock - deltaTime);
+            if (c.cursor >= count) {
+                c.cursor = 0;
+            }
+        }
+        entityCount = count;
+    }
+
+    for (auto& c : channels) {
+        c.dueBegin = c.cursor;
+        if (entityCount == 0) {
+            c.dueCount = 0;
+            continue;
+        }
+
+        if (c.rateHz <= 0.0f) {
+            c.dueCount = entityCount;  // 每帧通道：全部实体
+            continue;
+        }
+
+        c.budget += static_cast<float>(entityCount) * c.rateHz * deltaTime;
+        c.budget = std::min(c.budget, static_cast<float>(entityCount));
+        c.dueCount = static_cast<std::size_t>(c.budget);
+        c.budget -= static_cast<float>(c.dueCount);
+        c.cursor = (c.cursor + c.dueCount) % entityCount;
+    }
+}
+
+void UpdateScheduler::saveState(SnapshotWriter& out) const {
+    out.write(clock);
+    out.write(static_cast<std::uint64_t>(entityCount));
+    out.write(static_cast<std::uint32_t>(channels.size()));
+    for (const auto& c : channels) {
+        out.write(c.budget);
+        out.write(static_cast<std::uint64_t>(c.cursor));
+        out.write(static_cast<std::uint64_t>(c.dueBegin));
+        out.write(static_cast<std::uint64_t>(c.dueCount));
+        out.writeVector(c.lastRun);
+    }
+}
+
+bool UpdateScheduler::loadState(SnapshotReader& in) {
+    std::uint64_t count = 0;
+    std::uint32_t channelCount = 0;
+    in.read(clock);
+    in.read(count);
+    // 通道由构造决定，数量不同说明快照来自不同的程序版本
+    if (!in.read(channelCount) || channelCount != channels.size()) {
+        return false;
+    }
+    entityCount = static_cast<std::size_t>(count);
+    for (auto& c : channels) {
+        std::uint64_t cursor = 0, dueBegin = 0, dueCount = 0;
+        in.read(c.budget);
+        in.read(cursor);
+        in.read(dueBegin);
+        in.read(dueCount);
+        in.readVector(c.lastRun);
+        c.cursor = static_cast<std::size_t>(cursor);
+        c.dueBegin = static_cast<std::size_t>(dueBegin);
+        c.dueCount = static_cast<std::size_t>(dueCount);
+        if (c.lastRun.size() != entityCount || (entityCount > 0 && c.dueCount > entityCount)) {
+            return false;
+        }
+    }
+    return in.isOk();
+}
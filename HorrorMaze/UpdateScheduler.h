@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+/**
+ * UpdateScheduler：多频率子系统调度器
+ *
+ * 每个子系统（通道）有自己的更新频率，例如：
+ *   感知 15Hz、决策 10Hz、移动/碰撞 每帧
+ *
+ * 低频通道不会让所有实体挤在同一帧更新，而是按轮转游标把实体
+ * 均匀错开：N 个实体、频率 f、帧间隔 dt 时，每帧只处理约 N*f*dt 个，
+ * 每个实体仍然每 1/f 秒轮到一次。
+ *
+ * 用法（每帧）：
+ *   scheduler.beginFrame(deltaTime, ghosts.size());
+ *   scheduler.forEachDue(perception, [&](std::size_t i, float elapsed) { ... });
+ *
+ * elapsed = 该实体距上次在本通道更新经过的时间（用于推进计时器）
+ */
+class UpdateScheduler {
+public:
+    using ChannelId = int;
+
+    UpdateScheduler();
+
+    // 添加通道；rateHz <= 0 表示每帧对所有实体执行
+    ChannelId addChannel(const std::string& name, float rateHz);
+
+    // 运行时调整频率
+    void setRate(ChannelId channel, float rateHz);
+    float getRate(ChannelId channel) const;
+    const std::string& getName(ChannelId channel) const;
+
+    // 实体列表整体替换后调用（例如重新开始游戏），清空游标和时间戳
+    void reset();
+
+    // 每帧开始时调用：推进时钟，计算每个通道本帧到期的实体切片
+    void beginFrame(float deltaTime, std::size_t entityCount);
+
+    // 快照：保存/恢复时钟和每个通道的游标、时间戳（通道的名字和频率不保存，由构造决定）
+    void saveState(SnapshotWriter& out) const;
+    bool loadState(SnapshotReader& in);
+
+    // 本帧某通道到期的实体数量
+    std::size_t getDueCount(ChannelId channel) const { return channels[channel].dueCount; }
+
+    /**
+     * 依次处理本帧到期的实体：fn(entityIndex, elapsed)
+     */
+    template <typename Fn>
+    void forEachDue(ChannelId channel, Fn&& fn) {
+        Channel& c = channels[channel];
+        std::size_t index = c.dueBegin;
+        for (std::size_t n = 0; n < c.dueCount; n++) {
+            float elapsed = static_cast<float>(clock - c.lastRun[index]);
+            c.lastRun[index] = clock;
+            fn(index, elapsed);
+            if (++index == entityCount) {
+                index = 0;
+            }
+        }
+    }
+
+private:
+    struct Channel {
+        std::string name;
+        float rateHz;                   // 更新频率（<=0 = 每帧）
+        float budget;                   // 累积的待更新实体数（小数部分留到下一帧）
+        std::size_t cursor;             // 轮转游标：下一个要更新的实体
+        std::size_t dueBegin;           // 本帧切片起点
+        std::size_t dueCount;           // 本帧切片长度
+        std::vector<double> lastRun;    // 每个实体上次更新的时刻
+    };
+
+    std::vector<Channel> channels;
+    std::size_t entityCount;
+    double clock;                       // 调度器内部时钟（秒，double避免长时间运行后精度下降）
+};
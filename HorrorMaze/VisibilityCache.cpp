@@ -0,0 +1,176 @@
+#include "VisibilityCache.h"
+#include "GridTrace.h"
+#include <algorithm>
+#include <thread>
+
+VisibilityCache::VisibilityCache()
+    : width(0)
+    , height(0)
+{
+}
+
+/**
+ * 全量构建
+ *
+ * 每个格子的可见集互不依赖，按行分段交给多个线程，各线程只写自己负责的行。
+ * 小地图直接在当前线程算完（线程启动开销比计算本身还大）。
+ */
+void VisibilityCache::build(const WallBitmap& walls) {
+    width = walls.getWidth();
+    height = walls.getHeight();
+
+    std::size_t cellCount = static_cast<std::size_t>(width) * height;
+    bits.assign(cellCount * WORDS_PER_CELL, 0);
+    rowSpanStart.assign(cellCount, -1);
+    colSpanStart.assign(cellCount, -1);
+
+    for (int y = 0; y < height; y++) {
+        computeRowSpans(walls, y);
+    }
+    for (int x = 0; x < width; x++) {
+        computeColumnSpans(walls, x);
+    }
+
+    auto buildRows = [this, &walls](int yBegin, int yEnd) {
+        for (int y = yBegin; y < yEnd; y++) {
+            for (int x = 0; x < width; x++) {
+                computeCell(walls, x, y);
+            }
+        }
+    };
+
+    const int MIN_ROWS_PER_THREAD = 16;
+    int threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    threadCount = std::max(1, std::min(threadCount, height / MIN_ROWS_PER_THREAD));
+
+    if (threadCount <= 1) {
+        buildRows(0, height);
+        return;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(threadCount - 1);
+    int rowsPerThread = (height + threadCount - 1) / threadCount;
+    for (int t = 1; t < threadCount; t++) {
+        int yBegin = t * rowsPerThread;
+        int yEnd = std::min(height, yBegin + rowsPerThread);
+        if (yBegin < yEnd) {
+            workers.emplace_back(buildRows, yBegin, yEnd);
+        }
+    }
+    buildRows(0, std::min(height, rowsPerThread));  // 当前线程负责第一段
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * 局部修补：(x, y) 的墙体变化只会影响起点在它半径R窗口内的视线
+ * （窗口内任意视线都落在起点和终点的包围盒里）
+ */
+void VisibilityCache::updateCell(const WallBitmap& walls, int x, int y) {
+    if (walls.getWidth() != width || walls.getHeight() != height) {
+        build(walls);
+        return;
+    }
+    if (!walls.inBounds(x, y)) {
+        return;
+    }
+
+    int yBegin = std::max(0, y - RADIUS);
+    int yEnd = std::min(height - 1, y + RADIUS);
+    int xBegin = std::max(0, x - RADIUS);
+    int xEnd = std::min(width - 1, x + RADIUS);
+    for (int sy = yBegin; sy <= yEnd; sy++) {
+        for (int sx = xBegin; sx <= xEnd; sx++) {
+            computeCell(walls, sx, sy);
+        }
+    }
+
+    computeRowSpans(walls, y);
+    computeColumnSpans(walls, x);
+}
+
+bool VisibilityCache::isAxisClear(int x0, int y0, int x1, int y1) const {
+    if (y0 == y1) {
+        int a = std::min(x0, x1) + 1;  // 中间第一格
+        int b = std::max(x0, x1) - 1;  // 中间最后一格
+        if (a > b) {
+            return true;  // 相邻或同一格，中间没有格子
+        }
+        if (y0 < 0 || y0 >= height || a < 0 || b >= width) {
+            return false;  // 中间经过地图外（视为墙）
+        }
+        int spanA = rowSpanStart[cellIndex(a, y0)];
+        return spanA >= 0 && spanA == rowSpanStart[cellIndex(b, y0)];
+    }
+
+    if (x0 == x1) {
+        int a = std::min(y0, y1) + 1;
+        int b = std::max(y0, y1) - 1;
+        if (a > b) {
+            return true;
+        }
+        if (x0 < 0 || x0 >= width || a < 0 || b >= height) {
+            return false;
+        }
+        int spanA = colSpanStart[cellIndex(x0, a)];
+        return spanA >= 0 && spanA == colSpanStart[cellIndex(x0, b)];
+    }
+
+    return false;
+}
+
+/**
+ * 计算单个格子的可见集
+ */
+void VisibilityCache::computeCell(const WallBitmap& walls, int x, int y) {
+    std::uint64_t* cell = bits.data() + cellIndex(x, y) * WORDS_PER_CELL;
+    for (int w = 0; w < WORDS_PER_CELL; w++) {
+        cell[w] = 0;
+    }
+
+    // 墙内的格子没有可见集（起点是墙时视线总是被挡住）
+    if (walls.test(x, y)) {
+        return;
+    }
+
+    for (int dy = -RADIUS; dy <= RADIUS; dy++) {
+        for (int dx = -RADIUS; dx <= RADIUS; dx++) {
+            int tx = x + dx;
+            int ty = y + dy;
+            if (!walls.inBounds(tx, ty)) {
+                continue;  // 地图外视为墙
+            }
+            if (GridTrace::trace<GridTrace::StopAtFirstWall>(walls, x, y, tx, ty).walls == 0) {
+                int bit = (dy + RADIUS) * SPAN + (dx + RADIUS);
+                cell[bit >> 6] |= std::uint64_t(1) << (bit & 63);
+            }
+        }
+    }
+}
+
+void VisibilityCache::computeRowSpans(const WallBitmap& walls, int y) {
+    int start = -1;
+    for (int x = 0; x < width; x++) {
+        if (walls.test(x, y)) {
+            start = -1;
+        } else if (start < 0) {
+            start = x;
+        }
+        rowSpanStart[cellIndex(x, y)] = start;
+    }
+}
+
+void VisibilityCache::computeColumnSpans(const WallBitmap& walls, int x) {
+    int start = -1;
+    for (int y = 0; y < height; y++) {
+        if (walls.test(x, y)) {
+            start = -1;
+        } else if (start < 0) {
+            start = y;
+        }
+        colSpanStart[cellIndex(x, y)] = start;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "WallBitmap.h"
+
+/**
+ * VisibilityCache：预计算的可见集（PVS）
+ *
+ * 1. 每个可通行格子保存一个 (2R+1)×(2R+1) 窗口的位集：
+ *    第 (dy+R)*(2R+1) + (dx+R) 位 = 从本格到 (x+dx, y+dy) 的Bresenham视线是否畅通
+ *    （含端点，规则和 GridTrace::StopAtFirstWall 完全一致）
+ *    R = 5 时每格只占 121 位（2个64位字），视线检测变成一次位测试。
+ *
+ * 2. 每个可通行格子记录所在水平/垂直通道（连续空地）的起点，
+ *    用于"同一行/列且中间没有墙"的双胞胎触发检测，O(1) 判断。
+ *
+ * 加载时多线程全量构建；修改某格墙体时只重算半径R内受影响的格子。
+ */
+class VisibilityCache {
+public:
+    static constexpr int RADIUS = 5;                                   // 预计算半径（格）
+    static constexpr int SPAN = 2 * RADIUS + 1;                        // 窗口边长
+    static constexpr int WORDS_PER_CELL = (SPAN * SPAN + 63) / 64;     // 每格占用的64位字数
+
+    VisibilityCache();
+
+    // 全量构建（加载地图后调用，按行分段并行）
+    void build(const WallBitmap& walls);
+
+    // 某格墙体发生变化后局部修补
+    void updateCell(const WallBitmap& walls, int x, int y);
+
+    // 目标是否在预计算窗口内
+    static bool inWindow(int fromX, int fromY, int toX, int toY) {
+        int dx = toX - fromX;
+        int dy = toY - fromY;
+        return dx >= -RADIUS && dx <= RADIUS && dy >= -RADIUS && dy <= RADIUS;
+    }
+
+    /**
+     * 查表：从 (fromX, fromY) 到 (toX, toY) 的视线是否畅通
+     * 调用者保证目标在窗口内（inWindow）；起点是墙或在地图外时返回false
+     */
+    bool isVisible(int fromX, int fromY, int toX, int toY) const {
+        if (static_cast<unsigned>(fromX) >= static_cast<unsigned>(width) ||
+            static_cast<unsigned>(fromY) >= static_cast<unsigned>(height)) {
+            return false;
+        }
+        int bit = (toY - fromY + RADIUS) * SPAN + (toX - fromX + RADIUS);
+        const std::uint64_t* cell = bits.data() + cellIndex(fromX, fromY) * WORDS_PER_CELL;
+        return (cell[bit >> 6] >> (bit & 63)) & 1u;
+    }
+
+    /**
+     * 同一行或同一列的两格之间（不含两端）是否没有墙
+     * 不在同一行/列时返回false
+     */
+    bool isAxisClear(int x0, int y0, int x1, int y1) const;
+
+private:
+    int width;
+    int height;
+    std::vector<std::uint64_t> bits;     // 每格 WORDS_PER_CELL 个字
+    std::vector<int> rowSpanStart;       // 所在水平通道的起始x（墙 = -1）
+    std::vector<int> colSpanStart;       // 所在垂直通道的起始y（墙 = -1）
+
+    std::size_t cellIndex(int x, int y) const {
+        return static_cast<std::size_t>(y) * width + x;
+    }
+
+    void computeCell(const WallBitmap& walls, int x, int y);
+    void computeRowSpans(const WallBitmap& walls, int y);
+    void computeColumnSpans(const WallBitmap& walls, int x);
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/**
+ * WallBitmap：墙体占用位图（每格1位，按行打包）
+ *
+ * 存储方式：
+ * - 每行按64位字对齐，stride = 每行占用的字数
+ * - 第 y 行第 x 格 = words[y * stride + x / 64] 的第 (x % 64) 位
+ * - 1 = 墙，0 = 可通行
+ *
+ * 边界外的格子一律视为墙（和 Maze::isWall 的约定一致）
+ */
+class WallBitmap {
+public:
+    WallBitmap() : width(0), height(0), stride(0) {}
+
+    // 重新分配位图（全部清零）
+    void resize(int w, int h) {
+        width = (w > 0) ? w : 0;
+        height = (h > 0) ? h : 0;
+        stride = (width + 63) / 64;
+        words.assign(static_cast<std::size_t>(stride) * height, 0);
+    }
+
+    // 设置某个格子是否是墙（边界外忽略）
+    void set(int x, int y, bool wall) {
+        if (!inBounds(x, y)) {
+            return;
+        }
+        std::uint64_t& word = words[static_cast<std::size_t>(y) * stride + (x >> 6)];
+        std::uint64_t mask = std::uint64_t(1) << (x & 63);
+        if (wall) {
+            word |= mask;
+        } else {
+            word &= ~mask;
+        }
+    }
+
+    // 查询某个格子是否是墙（边界外视为墙）
+    bool test(int x, int y) const {
+        if (!inBounds(x, y)) {
+            return true;
+        }
+        return testUnchecked(x, y);
+    }
+
+    // 不做边界检查的查询（调用者保证坐标合法）
+    bool testUnchecked(int x, int y) const {
+        return (words[static_cast<std::size_t>(y) * stride + (x >> 6)] >> (x & 63)) & 1u;
+    }
+
+    bool inBounds(int x, int y) const {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(width) &&
+               static_cast<unsigned>(y) < static_cast<unsigned>(height);
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getStride() const { return stride; }                 // 每行的64位字数
+    const std::uint64_t* data() const { return words.data(); }
+    const std::uint64_t* row(int y) const { return words.data() + static_cast<std::size_t>(y) * stride; }
+
+private:
+    int width;
+    int height;
+    int stride;
+    std::vector<std::uint64_t> words;
+};
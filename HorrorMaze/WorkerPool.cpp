@@ -0,0 +1,93 @@
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(unsigned threadCount)
+    : generation(0)
+    , busyWorkers(0)
+    , stopping(false)
+    , task(nullptr)
+    , count(0)
+    , grain(1)
+    , chunkCount(0)
+    , nextChunk(0)
+{
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers.reserve(threadCount - 1);
+    for (unsigned i = 1; i < threadCount; i++) {
+        workers.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void WorkerPool::parallelFor(int total, int chunkSize, const std::function<void(int, int)>& work) {
+    if (total <= 0) {
+        return;
+    }
+    chunkSize = std::max(1, chunkSize);
+    int chunks = (total + chunkSize - 1) / chunkSize;
+
+    // 只有一段或没有工作线程：直接在当前线程做，不唤醒任何人
+    if (workers.empty() || chunks == 1) {
+        work(0, total);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &work;
+        count = total;
+        grain = chunkSize;
+        chunkCount = chunks;
+        nextChunk.store(0, std::memory_order_relaxed);
+        busyWorkers = static_cast<unsigned>(workers.size());
+        generation++;
+    }
+    wake.notify_all();
+
+    runChunks();  // 当前线程也参与
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busyWorkers == 0; });
+    task = nullptr;
+}
+
+void WorkerPool::workerLoop() {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busyWorkers == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+void WorkerPool::runChunks() {
+    for (int chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+        int begin = chunk * grain;
+        int end = std::min(count, begin + grain);
+        (*task)(begin, end);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkerPool：常驻工作线程池，把区间 [0, count) 切成小段并行处理
+ *
+ * 线程在构造时创建、析构时结束，每次 parallelFor 只是唤醒它们，不再创建线程
+ * （每帧都要用，创建线程的开销比一次光线投射还大）。
+ * 调用线程也参与，段按原子计数领取，先做完的线程多领几段；全部段处理完才返回。
+ * 同一时间只能有一个调用者（渲染线程）。
+ */
+class WorkerPool {
+public:
+    // threadCount：参与计算的线程总数（包括调用线程），0 = 硬件线程数
+    explicit WorkerPool(unsigned threadCount = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // 每段 grain 个元素，task(begin, end) 处理一段；不同段可能在不同线程上同时执行
+    void parallelFor(int count, int grain, const std::function<void(int, int)>& task);
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;       // 新任务或退出
+    std::condition_variable finished;   // 所有工作线程做完本轮
+    std::uint64_t generation;           // 每次 parallelFor 加1，工作线程据此判断有新任务
+    unsigned busyWorkers;               // 本轮还没做完的工作线程数
+    bool stopping;
+
+    // 本轮任务（parallelFor 在唤醒前写好，工作线程只读）
+    const std::function<void(int, int)>* task;
+    int count;
+    int grain;
+    int chunkCount;
+    std::atomic<int> nextChunk;
+};
@@ -1,5 +1,6 @@
 #include "Game.h"
-#include <iostream>
+#include "Logger.h"
+#include <exception>
 
 int main()
 {
@@ -8,7 +9,8 @@ int main()
         game.run();
     }
     catch (const std::exception& e) {
-        std::cerr << "Error: " << e.what() << std::endl;
+        LOG_ERROR("Error: " << e.what());
+        Logger::instance().flush();
         return 1;
     }
 
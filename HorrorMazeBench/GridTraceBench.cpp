@@ -0,0 +1,217 @@
+#include "GridTrace.h"
+#include "PerceptionBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * GridTrace / PerceptionBatch 微基准测试
+ *
+ * 在随机生成的墙体位图上批量检测线段，分别测量三种访问策略
+ * （逐条调用 trace 和 traceBatch 两种入口）的单条线段耗时；
+ * 然后测量批量感知内核（多个起点 → 同一目标）各指令集实现的耗时。
+ *
+ * 用法：HorrorMazeBench [线段数量]
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // 随机墙体位图（外圈一定是墙，和真实地图一致）
+    WallBitmap makeRandomGrid(int width, int height, float wallDensity, std::mt19937& gen) {
+        WallBitmap grid;
+        grid.resize(width, height);
+        std::uniform_real_distribution<float> coin(0.0f, 1.0f);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                bool border = (x == 0 || y == 0 || x == width - 1 || y == height - 1);
+                grid.set(x, y, border || coin(gen) < wallDensity);
+            }
+        }
+        return grid;
+    }
+
+    // 随机线段：长度不超过 maxLength（模拟鬼与玩家之间的距离分布）
+    std::vector<GridTrace::Segment> makeSegments(std::size_t count, int width, int height,
+                                                 int maxLength, std::mt19937& gen) {
+        std::uniform_int_distribution<int> px(0, width - 1);
+        std::uniform_int_distribution<int> py(0, height - 1);
+        std::uniform_int_distribution<int> offset(-maxLength, maxLength);
+
+        std::vector<GridTrace::Segment> segments(count);
+        for (auto& s : segments) {
+            s.x0 = px(gen);
+            s.y0 = py(gen);
+            s.x1 = std::min(width - 1, std::max(0, s.x0 + offset(gen)));
+            s.y1 = std::min(height - 1, std::max(0, s.y0 + offset(gen)));
+        }
+        return segments;
+    }
+
+    // 参照实现：逐格调用 WallBitmap::test 的朴素Bresenham（用于校验内核结果）
+    int referenceCount(const WallBitmap& grid, const GridTrace::Segment& s) {
+        int dxl = std::abs(s.x1 - s.x0);
+        int dyl = std::abs(s.y1 - s.y0);
+        int sx = (s.x0 < s.x1) ? 1 : -1;
+        int sy = (s.y0 < s.y1) ? 1 : -1;
+        int err = dxl - dyl;
+        int cx = s.x0;
+        int cy = s.y0;
+        int walls = 0;
+        while (true) {
+            if (grid.test(cx, cy)) {
+                walls++;
+            }
+            if (cx == s.x1 && cy == s.y1) {
+                break;
+            }
+            int e2 = 2 * err;
+            if (e2 > -dyl) { err -= dyl; cx += sx; }
+            if (e2 < dxl) { err += dxl; cy += sy; }
+        }
+        return walls;
+    }
+
+    // 重复运行 fn，取最快一轮的单次耗时（纳秒）
+    template <typename Fn>
+    double bestNsPerOp(Fn&& fn, std::size_t opsPerRun, int runs) {
+        double best = 1e30;
+        for (int r = 0; r < runs; r++) {
+            auto start = Clock::now();
+            fn();
+            auto end = Clock::now();
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            best = std::min(best, ns / static_cast<double>(opsPerRun));
+        }
+        return best;
+    }
+
+    void report(int size, const char* name, double nsPerOp, long long checksum) {
+        std::printf("%5dx%-5d %-28s %9.2f ns/seg %9.2f Mseg/s   (checksum %lld)\n",
+                    size, size, name, nsPerOp, 1000.0 / nsPerOp, checksum);
+    }
+
+    template <typename Visitor>
+    void benchPolicy(int size, const char* name, const WallBitmap& grid,
+                     const std::vector<GridTrace::Segment>& segments,
+                     const Visitor& prototype, std::vector<int>& results) {
+        const int RUNS = 5;
+        long long checksum = 0;
+
+        double single = bestNsPerOp([&]() {
+            checksum = 0;
+            for (const auto& s : segments) {
+                checksum += GridTrace::trace(grid, s.x0, s.y0, s.x1, s.y1, prototype).walls;
+            }
+        }, segments.size(), RUNS);
+        report(size, (std::string(name) + " trace").c_str(), single, checksum);
+
+        double batch = bestNsPerOp([&]() {
+            GridTrace::traceBatch(grid, segments.data(), segments.size(), results.data(), prototype);
+        }, segments.size(), RUNS);
+        checksum = 0;
+        for (int r : results) {
+            checksum += r;
+        }
+        report(size, (std::string(name) + " traceBatch").c_str(), batch, checksum);
+    }
+
+    /**
+     * 批量感知：所有起点散布在目标周围 maxLength 格内（模拟一群鬼围着玩家）
+     * 数完整条线（对照 CountWalls）和数到第2堵墙就停（打火机检测，对照 StopAfterWalls(2)）各测一遍。
+     * 返回 false 表示某个实现的结果和 GridTrace 不一致
+     */
+    bool benchPerception(int size, const WallBitmap& grid, std::size_t count, int maxLength,
+                         std::mt19937& gen) {
+        const int RUNS = 5;
+        int targetX = size / 2;
+        int targetY = size / 2;
+        std::uniform_int_distribution<int> offset(-maxLength, maxLength);
+        std::vector<int> sourceX(count), sourceY(count), results(count), expected(count);
+        for (std::size_t i = 0; i < count; i++) {
+            sourceX[i] = std::min(size - 1, std::max(0, targetX + offset(gen)));
+            sourceY[i] = std::min(size - 1, std::max(0, targetY + offset(gen)));
+        }
+
+        const PerceptionBatch::Isa isas[] = {
+            PerceptionBatch::Isa::Scalar, PerceptionBatch::Isa::SSE2, PerceptionBatch::Isa::AVX2
+        };
+        const int limits[] = {PerceptionBatch::NO_WALL_LIMIT, 2};
+        for (int limit : limits) {
+            for (std::size_t i = 0; i < count; i++) {
+                expected[i] = GridTrace::trace(grid, sourceX[i], sourceY[i], targetX, targetY,
+                                               GridTrace::StopAfterWalls(limit)).walls;
+            }
+            for (PerceptionBatch::Isa isa : isas) {
+                if (static_cast<int>(isa) > static_cast<int>(CpuFeatures::detectIsa())) {
+                    continue;  // CPU不支持
+                }
+                double ns = bestNsPerOp([&]() {
+                    PerceptionBatch::countWallsToTarget(isa, grid, sourceX.data(), sourceY.data(), count,
+                                                        targetX, targetY, results.data(), limit);
+                }, count, RUNS);
+
+                long long checksum = 0;
+                for (std::size_t i = 0; i < count; i++) {
+                    if (results[i] != expected[i]) {
+                        std::fprintf(stderr, "PerceptionBatch %s (limit %d) mismatch at ray %zu\n",
+                                     CpuFeatures::getIsaName(isa), limit, i);
+                        return false;
+                    }
+                    checksum += results[i];
+                }
+                std::string name = std::string("PerceptionBatch ") + CpuFeatures::getIsaName(isa);
+                if (limit != PerceptionBatch::NO_WALL_LIMIT) {
+                    name += " limit " + std::to_string(limit);
+                }
+                report(size, name.c_str(), ns, checksum);
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::size_t segmentCount = 1 << 18;
+    if (argc > 1) {
+        segmentCount = static_cast<std::size_t>(std::strtoul(argv[1], nullptr, 10));
+    }
+
+    std::mt19937 gen(12345);  // 固定种子，保证每次运行的数据一致
+    const int sizes[] = {32, 128, 512, 2048};
+    const int MAX_SEGMENT_LENGTH = 24;
+
+    std::printf("GridTrace microbenchmark: %zu segments, max length %d\n", segmentCount, MAX_SEGMENT_LENGTH);
+    std::printf("PerceptionBatch: best ISA = %s\n", CpuFeatures::getIsaName(CpuFeatures::detectIsa()));
+
+    for (int size : sizes) {
+        WallBitmap grid = makeRandomGrid(size, size, 0.3f, gen);
+        auto segments = makeSegments(segmentCount, size, size, MAX_SEGMENT_LENGTH, gen);
+        std::vector<int> results(segments.size());
+
+        // 先校验：内核结果必须和朴素实现一致
+        GridTrace::traceBatch<GridTrace::CountWalls>(grid, segments.data(), segments.size(), results.data());
+        for (std::size_t i = 0; i < segments.size(); i++) {
+            if (results[i] != referenceCount(grid, segments[i])) {
+                std::fprintf(stderr, "Mismatch at segment %zu (%d,%d)->(%d,%d)\n", i,
+                             segments[i].x0, segments[i].y0, segments[i].x1, segments[i].y1);
+                return 1;
+            }
+        }
+
+        benchPolicy(size, "CountWalls", grid, segments, GridTrace::CountWalls(), results);
+        benchPolicy(size, "StopAtFirstWall", grid, segments, GridTrace::StopAtFirstWall(), results);
+        benchPolicy(size, "StopAfterWalls(3)", grid, segments, GridTrace::StopAfterWalls(3), results);
+
+        if (!benchPerception(size, grid, segmentCount, MAX_SEGMENT_LENGTH, gen)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+#include "BatchRunner.h"
+#include "HeadlessBots.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+    /**
+     * 跑一个实例：同一个 Simulation 连续玩 episodesPerInstance 局
+     */
+    template <typename Bot>
+    BatchSetResult runInstance(const BatchConfig& config, const SimulationParams& params, std::uint64_t seed) {
+        Simulation sim(seed, params);
+        sim.setMap(config.map);
+        Bot bot(sim.getRng().stream(RngStream::Headless));
+
+        BatchSetResult result;
+        // 每局最多跑到计时器耗尽（计时器按1.5倍速流逝），再留一点余量
+        const std::uint64_t maxSteps = static_cast<std::uint64_t>(
+            Simulation::GAME_TIME_LIMIT / 1.5f / config.timestep) + 1000;
+
+        for (unsigned episode = 0; episode < config.episodesPerInstance; episode++) {
+            if (episode > 0) {
+                sim.reset();
+            }
+
+            double walked = 0.0;
+            float lastX = sim.getPlayer().getX();
+            float lastY = sim.getPlayer().getY();
+            std::uint64_t steps = 0;
+            while (sim.getStatus() == SimulationStatus::Running && steps < maxSteps) {
+                sim.step(config.timestep, bot.next(sim, config.timestep));
+                steps++;
+
+                float x = sim.getPlayer().getX();
+                float y = sim.getPlayer().getY();
+                walked += std::sqrt((x - lastX) * (x - lastX) + (y - lastY) * (y - lastY));
+                lastX = x;
+                lastY = y;
+
+                for (const auto& event : sim.getEvents()) {
+                    if (event.type == SimulationEventType::TwinEncounter) {
+                        result.twinEncounters++;
+                    }
+                }
+            }
+
+            double seconds = steps * static_cast<double>(config.timestep);
+            result.episodes++;
+            result.steps += steps;
+            result.distanceTotal += walked;
+            if (sim.getStatus() == SimulationStatus::Victory) {
+                result.victories++;
+                result.escapeTimeTotal += seconds;
+                result.escapeDistanceTotal += walked;
+            } else if (sim.getDeathCause() == DeathCause::Chopped) {
+                result.chopped++;
+                result.catchTimeTotal += seconds;
+            } else {
+                result.frozen++;
+            }
+        }
+        return result;
+    }
+
+}
+
+void BatchSetResult::merge(const BatchSetResult& other) {
+    episodes += other.episodes;
+    victories += other.victories;
+    chopped += other.chopped;
+    frozen += other.frozen;
+    twinEncounters += other.twinEncounters;
+    steps += other.steps;
+    catchTimeTotal += other.catchTimeTotal;
+    escapeTimeTotal += other.escapeTimeTotal;
+    distanceTotal += other.distanceTotal;
+    escapeDistanceTotal += other.escapeDistanceTotal;
+}
+
+std::vector<BatchSetResult> runBatch(const BatchConfig& config) {
+    const std::size_t jobCount = config.paramSets.size() * config.instancesPerSet;
+    std::vector<BatchSetResult> jobResults(jobCount);
+
+    unsigned threadCount = config.threads;
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threadCount = static_cast<unsigned>(std::min<std::size_t>(threadCount, std::max<std::size_t>(jobCount, 1)));
+
+    // 线程池：每个线程不断领取下一个实例编号，结果写到该实例自己的槽位
+    std::atomic<std::size_t> nextJob(0);
+    auto worker = [&]() {
+        for (std::size_t job = nextJob++; job < jobCount; job = nextJob++) {
+            std::size_t set = job / config.instancesPerSet;
+            std::uint64_t seed = config.baseSeed + job % config.instancesPerSet;
+            const SimulationParams& params = config.paramSets[set].params;
+            jobResults[job] = (config.bot == BatchBot::ExitSeeker)
+                ? runInstance<ExitSeekerBot>(config, params, seed)
+                : runInstance<WanderBot>(config, params, seed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threadCount; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();  // 当前线程也参与
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    std::vector<BatchSetResult> results(config.paramSets.size());
+    for (std::size_t job = 0; job < jobCount; job++) {
+        results[job / config.instancesPerSet].merge(jobResults[job]);
+    }
+    return results;
+}
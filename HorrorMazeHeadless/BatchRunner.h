@@ -0,0 +1,64 @@
+#pragma once
+#include "Maze.h"
+#include "SimulationParams.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * 批量模拟用的机器人
+ */
+enum class BatchBot {
+    Wander,       // 随机漫游
+    ExitSeeker    // 沿最短路径走向出口
+};
+
+/**
+ * 一组参数
+ */
+struct BatchParamSet {
+    std::string label;            // 输出时显示的名字（例如 "ghostChaseSpeed=3.0"）
+    SimulationParams params;
+};
+
+struct BatchConfig {
+    std::shared_ptr<const Maze> map;      // 所有实例共享的只读地图
+    std::vector<BatchParamSet> paramSets;
+    unsigned instancesPerSet = 16;        // 每组参数跑多少个实例（种子 baseSeed + 0..N-1）
+    unsigned episodesPerInstance = 4;     // 每个实例连续玩几局
+    std::uint64_t baseSeed = 1;
+    float timestep = 1.0f / 120.0f;
+    unsigned threads = 0;                 // 0 = 硬件线程数
+    BatchBot bot = BatchBot::ExitSeeker;
+};
+
+/**
+ * 一组参数的汇总结果
+ */
+struct BatchSetResult {
+    std::uint64_t episodes = 0;
+    std::uint64_t victories = 0;
+    std::uint64_t chopped = 0;
+    std::uint64_t frozen = 0;
+    std::uint64_t twinEncounters = 0;
+    std::uint64_t steps = 0;
+    double catchTimeTotal = 0.0;      // 被抓的局：开局到被抓的模拟时间之和（秒）
+    double escapeTimeTotal = 0.0;     // 逃脱的局：开局到出口的模拟时间之和（秒）
+    double distanceTotal = 0.0;       // 所有局玩家走过的距离之和（格）
+    double escapeDistanceTotal = 0.0; // 逃脱的局玩家走过的距离之和（格）
+
+    void merge(const BatchSetResult& other);
+};
+
+/**
+ * 批量模拟：每组参数 × 每个种子是一个实例，实例分给线程池并行运行
+ *
+ * 每个实例有自己的 Simulation、种子和机器人，只共享只读地图，
+ * 所以内存只随线程数增长，不随实例数增长。不同参数组使用同一批种子，
+ * 比较参数时随机因素（鬼的出生点、机器人的选择）相同，差异来自参数本身。
+ * 结果按实例编号汇总，和线程数、调度顺序无关。
+ *
+ * @return 每组参数一个结果（顺序和 config.paramSets 相同）
+ */
+std::vector<BatchSetResult> runBatch(const BatchConfig& config);
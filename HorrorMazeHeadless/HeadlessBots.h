@@ -0,0 +1,113 @@
+#pragma once
+#include "Simulation.h"
+#include "RngService.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/**
+ * 无头模拟用的自动玩家
+ *
+ * 两个机器人的接口相同：每步调用 next(sim, deltaTime) 得到本步的输入。
+ * 随机性都来自构造时传入的流，所以同一个种子的整次运行可以复现。
+ */
+
+/**
+ * 随机漫游：每隔一段时间换一组按键，转向速度随机
+ */
+class WanderBot {
+public:
+    explicit WanderBot(const Pcg32& randomStream)
+        : rng(randomStream)
+        , holdTimer(0.0f)
+        , turnRate(0.0f)
+    {
+    }
+
+    PlayerInput next(const Simulation&, float deltaTime) {
+        holdTimer -= deltaTime;
+        if (holdTimer <= 0.0f) {
+            holdTimer = 0.25f + rng.nextFloat() * 0.75f;  // 每组按键保持 0.25~1 秒
+            held = PlayerInput();
+            held.forward = rng.nextBelow(10) < 7;
+            held.backward = !held.forward && rng.nextBelow(4) == 0;
+            held.strafeLeft = rng.nextBelow(5) == 0;
+            held.strafeRight = !held.strafeLeft && rng.nextBelow(5) == 0;
+            held.run = rng.nextBelow(5) == 0;
+            held.crouch = !held.run && rng.nextBelow(10) == 0;
+            turnRate = (rng.nextFloat() * 2.0f - 1.0f) * 2.0f;  // [-2, 2] rad/s
+        }
+
+        PlayerInput input = held;
+        input.turn = turnRate * deltaTime;
+        input.toggleLighter = rng.nextBelow(2000) == 0;
+        input.toggleWallPhase = rng.nextBelow(4000) == 0;
+        return input;
+    }
+
+private:
+    Pcg32 rng;
+    PlayerInput held;
+    float holdTimer;
+    float turnRate;
+};
+
+/**
+ * 寻路机器人：沿A*最短路径走向出口，有鬼在追时奔跑（体力够的话）
+ *
+ * 只在玩家换格子时重新寻路；转向有速度上限（和鼠标转向差不多快），
+ * 朝向偏差较大时先原地转身再前进，所以不会卡在墙角。
+ * 用来批量测量逃脱率：它不躲藏、不钻墙，结果反映的是追逐参数本身。
+ */
+class ExitSeekerBot {
+public:
+    explicit ExitSeekerBot(const Pcg32& randomStream)
+        : rng(randomStream)
+        , plannedFrom(-1, -1)
+    {
+    }
+
+    PlayerInput next(const Simulation& sim, float deltaTime) {
+        const Player& player = sim.getPlayer();
+        sf::Vector2i cell(static_cast<int>(player.getX()), static_cast<int>(player.getY()));
+        if (cell != plannedFrom) {
+            path = sim.findPathToExit(cell, sim.getMaze().getExitPos());
+            plannedFrom = cell;
+        }
+
+        PlayerInput input;
+        if (path.empty()) {
+            // 在墙里或者无路可走：随便转一转，等换了格子再寻路
+            input.forward = true;
+            input.turn = (rng.nextFloat() - 0.5f) * 4.0f * deltaTime;
+            return input;
+        }
+
+        // 路径第一个点是当前格子，朝下一个格子的中心走
+        sf::Vector2i waypoint = (path.size() > 1) ? path[1] : path[0];
+        float dx = waypoint.x + 0.5f - player.getX();
+        float dy = waypoint.y + 0.5f - player.getY();
+        float diff = std::atan2(dy, dx) - std::atan2(player.getDirY(), player.getDirX());
+        const float PI = std::acos(-1.0f);
+        while (diff > PI) diff -= 2.0f * PI;
+        while (diff < -PI) diff += 2.0f * PI;
+
+        float maxTurn = MAX_TURN_RATE * deltaTime;
+        input.turn = std::max(-maxTurn, std::min(maxTurn, diff));
+        input.forward = std::abs(diff) < 0.6f;
+
+        bool chased = false;
+        for (const auto& ghost : sim.getGhosts()) {
+            chased = chased || ghost.getState() == Ghost::State::Chasing;
+        }
+        input.run = chased && player.getStamina() > player.getStaminaMax() * 0.2f;
+        return input;
+    }
+
+private:
+    static constexpr float MAX_TURN_RATE = 6.0f;  // rad/s
+
+    Pcg32 rng;
+    sf::Vector2i plannedFrom;
+    std::vector<sf::Vector2i> path;
+};
@@ -0,0 +1,478 @@
+#include "Simulation.h"
+#include "BatchRunner.h"
+#include "HeadlessBots.h"
+#include "InputRecording.h"
+#include "Profiler.h"
+#include "RngService.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * 无头模拟程序
+ *
+ * 不创建窗口、不加载声音和纹理，只链接模拟核心（Simulation 及其依赖），
+ * 用随机漫游的自动输入尽可能快地推进模拟，输出每秒步数和各结局的局数。
+ * 用于性能测量、长时间稳定性测试和按种子复现问题。
+ *
+ * --replay 用游戏里录下的输入（HORRORMAZE_RECORD）代替自动输入，种子和步长取自录像，
+ * 步数默认为录像长度；--record 把本次运行的输入也存成录像，可以拿回游戏里回放观看。
+ * --profile 按步统计各模拟阶段的耗时，结束时导出CSV（格式和游戏的 HORRORMAZE_PROFILE 相同）。
+ *
+ * --batch N 切换到批量模式：每组参数用种子 seed..seed+N-1 各跑一个实例（每个实例 --episodes 局），
+ * 实例分给 --threads 个线程并行运行（共享同一份只读地图），最后按参数组输出逃脱率、
+ * 平均被抓时间和平均行走距离。--param 名字=值 修改参数（可重复），
+ * --sweep 名字=值1,值2,... 为每个值生成一组参数。批量模式默认使用寻路机器人（--bot exit）。
+ *
+ * --snapshot 从快照文件（游戏退出时保存的慢帧前状态等）继续运行，种子取自快照。
+ * --snapshot-check 检查快照：反复"保存 → 跑一段 → 恢复 → 再跑同一段"，
+ * 两次跑完的状态必须逐字节相同，同时输出快照大小和保存/恢复的平均耗时。
+ *
+ * 用法：HorrorMazeHeadless [--map 地图文件] [--ticks 步数] [--seed 种子] [--rate 模拟频率]
+ *                          [--replay 录像文件] [--record 录像文件] [--profile CSV文件]
+ *                          [--bot wander|exit] [--snapshot 快照文件] [--snapshot-check]
+ *       HorrorMazeHeadless --batch 实例数 [--episodes 局数] [--threads 线程数]
+ *                          [--param 名字=值]... [--sweep 名字=值1,值2,...] [--map/--seed/--rate/--bot]
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        std::string mapPath;
+        std::string replayPath;
+        std::string recordPath;
+        std::string profilePath;
+        std::string snapshotPath;
+        bool snapshotCheck = false;
+        unsigned long long ticks = 1000000;
+        bool hasTicks = false;
+        unsigned long long seed = 0;
+        bool hasSeed = false;
+        float rate = 120.0f;
+        std::string bot;
+
+        // 批量模式
+        unsigned batch = 0;
+        unsigned episodes = 4;
+        unsigned threads = 0;
+        SimulationParams params;
+        std::string sweepName;
+        std::vector<float> sweepValues;
+    };
+
+    // "名字=值" 拆成两部分
+    bool splitAssignment(const char* text, std::string& name, std::string& value) {
+        const char* equals = std::strchr(text, '=');
+        if (!equals || equals == text) {
+            return false;
+        }
+        name.assign(text, equals);
+        value = equals + 1;
+        return !value.empty();
+    }
+
+    // 参数值：整个字符串必须是一个数，并且在参数的有效范围内
+    bool parseParamValue(const SimulationParamField& field, const std::string& text, float& value) {
+        char* end = nullptr;
+        value = std::strtof(text.c_str(), &end);
+        if (text.empty() || end != text.c_str() + text.size()) {
+            std::fprintf(stderr, "Invalid value for %s: '%s'\n", field.name, text.c_str());
+            return false;
+        }
+        if (!(value >= field.minValue && value <= field.maxValue)) {
+            std::fprintf(stderr, "%s must be in [%g, %g]: '%s'\n", field.name, field.minValue, field.maxValue, text.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool parseParam(const char* text, SimulationParams& params) {
+        std::string name, value;
+        if (!splitAssignment(text, name, value)) {
+            return false;
+        }
+        const SimulationParamField* field = findSimulationParamField(name.c_str());
+        if (!field) {
+            std::fprintf(stderr, "Unknown parameter: %s\n", name.c_str());
+            return false;
+        }
+        return parseParamValue(*field, value, params.*(field->member));
+    }
+
+    bool parseSweep(const char* text, Options& options) {
+        std::string value;
+        if (!splitAssignment(text, options.sweepName, value)) {
+            return false;
+        }
+        const SimulationParamField* field = findSimulationParamField(options.sweepName.c_str());
+        if (!field) {
+            std::fprintf(stderr, "Unknown parameter: %s\n", options.sweepName.c_str());
+            return false;
+        }
+        options.sweepValues.clear();
+        for (std::size_t start = 0; start <= value.size();) {
+            std::size_t comma = value.find(',', start);
+            if (comma == std::string::npos) {
+                comma = value.size();
+            }
+            float sweepValue = 0.0f;
+            if (!parseParamValue(*field, value.substr(start, comma - start), sweepValue)) {
+                return false;
+            }
+            options.sweepValues.push_back(sweepValue);
+            start = comma + 1;
+        }
+        return true;
+    }
+
+    // 参数组的名字：和默认值不同的参数逐个列出（"名字=值"，空格分隔），全部是默认值时为 "default"。
+    // always 指定的参数（--sweep 扫描的那个）即使等于默认值也列出
+    std::string describeParams(const SimulationParams& params, const std::string& always = std::string()) {
+        const SimulationParams defaults;
+        std::string label;
+        for (const auto& field : getSimulationParamFields()) {
+            if (params.*(field.member) == defaults.*(field.member) && always != field.name) {
+                continue;
+            }
+            char text[64];
+            std::snprintf(text, sizeof(text), "%s%s=%g", label.empty() ? "" : " ", field.name,
+                          params.*(field.member));
+            label += text;
+        }
+        return label.empty() ? "default" : label;
+    }
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = (i + 1 < argc);
+            if (std::strcmp(argv[i], "--map") == 0 && hasValue) {
+                options.mapPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) {
+                options.ticks = std::strtoull(argv[++i], nullptr, 0);
+                options.hasTicks = true;
+            } else if (std::strcmp(argv[i], "--seed") == 0 && hasValue) {
+                options.seed = std::strtoull(argv[++i], nullptr, 0);
+                options.hasSeed = true;
+            } else if (std::strcmp(argv[i], "--rate") == 0 && hasValue) {
+                options.rate = static_cast<float>(std::atof(argv[++i]));
+            } else if (std::strcmp(argv[i], "--replay") == 0 && hasValue) {
+                options.replayPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--record") == 0 && hasValue) {
+                options.recordPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--profile") == 0 && hasValue) {
+                options.profilePath = argv[++i];
+            } else if (std::strcmp(argv[i], "--snapshot") == 0 && hasValue) {
+                options.snapshotPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--snapshot-check") == 0) {
+                options.snapshotCheck = true;
+            } else if (std::strcmp(argv[i], "--bot") == 0 && hasValue) {
+                options.bot = argv[++i];
+                if (options.bot != "wander" && options.bot != "exit") {
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--batch") == 0 && hasValue) {
+                options.batch = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 0));
+            } else if (std::strcmp(argv[i], "--episodes") == 0 && hasValue) {
+                options.episodes = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 0));
+            } else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+                options.threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 0));
+            } else if (std::strcmp(argv[i], "--param") == 0 && hasValue) {
+                if (!parseParam(argv[++i], options.params)) {
+                    return false;
+                }
+            } else if (std::strcmp(argv[i], "--sweep") == 0 && hasValue) {
+                if (!parseSweep(argv[++i], options)) {
+                    return false;
+                }
+            } else {
+                return false;
+            }
+        }
+        return options.rate > 0.0f;
+    }
+
+    std::vector<std::string> candidateMapPaths(const std::string& requested) {
+        std::vector<std::string> paths;
+        if (!requested.empty()) {
+            paths.push_back(requested);
+        } else {
+            paths = {
+                "assets/maps/level1.txt",
+                "../assets/maps/level1.txt",
+                "../../assets/maps/level1.txt"
+            };
+        }
+
+        return paths;
+    }
+
+    bool loadAnyMap(Simulation& sim, const std::string& requested) {
+        for (const auto& path : candidateMapPaths(requested)) {
+            if (sim.loadMap(path)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * 快照检查：从当前状态开始，每轮保存一次，跑 CHECK_STEPS 步后再保存一次，
+     * 恢复到第一次保存的状态（机器人也回到当时的状态）重跑同样的步数，比较两次的结果。
+     * 一局结束时重新开始，所以开局、追逐、冻结、结局附近的状态都会被检查到。
+     */
+    template <typename Bot>
+    int runSnapshotCheck(Simulation& sim, Bot bot, unsigned long long ticks, float deltaTime) {
+        const unsigned long long CHECK_STEPS = 240;
+        SimulationSnapshot start, first, second;
+        double saveMicros = 0.0, restoreMicros = 0.0;
+        unsigned long long rounds = 0, mismatches = 0;
+
+        for (unsigned long long tick = 0; tick < ticks; tick += CHECK_STEPS) {
+            if (sim.getStatus() != SimulationStatus::Running) {
+                sim.reset();
+            }
+
+            auto saveStart = Clock::now();
+            sim.saveSnapshot(start);
+            saveMicros += std::chrono::duration<double, std::micro>(Clock::now() - saveStart).count();
+            Bot botAtStart = bot;
+
+            for (unsigned long long i = 0; i < CHECK_STEPS; i++) {
+                sim.step(deltaTime, bot.next(sim, deltaTime));
+            }
+            sim.saveSnapshot(first);
+
+            auto restoreStart = Clock::now();
+            bool restored = sim.restoreSnapshot(start);
+            restoreMicros += std::chrono::duration<double, std::micro>(Clock::now() - restoreStart).count();
+            bot = botAtStart;
+
+            for (unsigned long long i = 0; i < CHECK_STEPS; i++) {
+                sim.step(deltaTime, bot.next(sim, deltaTime));
+            }
+            sim.saveSnapshot(second);
+
+            rounds++;
+            if (!restored || first.data != second.data) {
+                mismatches++;
+                LOG_ERROR("ERROR: Snapshot round trip diverged (round " << rounds << ", step " << start.step << ")");
+            }
+        }
+        Logger::instance().flush();
+
+        std::printf("Snapshot check: %llu rounds of %llu steps, %llu mismatches\n", rounds, CHECK_STEPS, mismatches);
+        std::printf("Snapshot size %zu bytes, save %.2f us, restore %.2f us (average)\n",
+                    start.data.size(), saveMicros / rounds, restoreMicros / rounds);
+        return mismatches == 0 ? 0 : 1;
+    }
+
+    /**
+     * 批量模式：加载一次地图，按参数组并行跑完所有实例，输出每组的统计
+     */
+    int runBatchMode(const Options& options) {
+        Logger::instance().setMinimumLevel(LogLevel::Warn);  // 几百局的出生/遭遇日志没有意义
+
+        std::shared_ptr<Maze> map;
+        for (const auto& path : candidateMapPaths(options.mapPath)) {
+            auto loaded = std::make_shared<Maze>();
+            if (loaded->loadFromFile(path)) {
+                map = loaded;
+                break;
+            }
+        }
+        if (!map) {
+            LOG_ERROR("ERROR: Cannot load map!");
+            Logger::instance().flush();
+            return 1;
+        }
+
+        BatchConfig config;
+        config.map = map;
+        config.instancesPerSet = options.batch;
+        config.episodesPerInstance = options.episodes;
+        config.baseSeed = options.hasSeed ? options.seed : RngService::seedFromEnvironment();
+        config.timestep = 1.0f / options.rate;
+        config.threads = options.threads;
+        config.bot = (options.bot == "wander") ? BatchBot::Wander : BatchBot::ExitSeeker;
+
+        if (options.sweepValues.empty()) {
+            config.paramSets.push_back({describeParams(options.params), options.params});
+        } else {
+            for (float value : options.sweepValues) {
+                BatchParamSet set{"", options.params};
+                *findSimulationParam(set.params, options.sweepName.c_str()) = value;
+                set.label = describeParams(set.params, options.sweepName);
+                config.paramSets.push_back(set);
+            }
+        }
+
+        auto start = Clock::now();
+        std::vector<BatchSetResult> results = runBatch(config);
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        Logger::instance().flush();
+
+        unsigned long long totalSteps = 0;
+        for (const auto& r : results) {
+            totalSteps += r.steps;
+        }
+        std::printf("Batch: %zu parameter set(s) x %u instances x %u episodes, seeds %llu..%llu, %s bot\n",
+                    config.paramSets.size(), config.instancesPerSet, config.episodesPerInstance,
+                    static_cast<unsigned long long>(config.baseSeed),
+                    static_cast<unsigned long long>(config.baseSeed + config.instancesPerSet - 1),
+                    config.bot == BatchBot::Wander ? "wander" : "exit");
+        std::printf("%llu ticks in %.3f s (%.0f ticks/s)\n", totalSteps, seconds, totalSteps / seconds);
+
+        int labelWidth = 28;  // 参数组名字可能比默认列宽长，整列按最长的对齐
+        for (const auto& set : config.paramSets) {
+            labelWidth = std::max(labelWidth, static_cast<int>(set.label.size()));
+        }
+        std::printf("%-*s %8s %8s %8s %8s %10s %10s %10s %8s\n", labelWidth, "params", "episodes", "escape%",
+                    "chopped%", "frozen%", "catch(s)", "escape(s)", "walked", "twins");
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const BatchSetResult& r = results[i];
+            double episodes = r.episodes > 0 ? static_cast<double>(r.episodes) : 1.0;
+            std::printf("%-*s %8llu %7.1f%% %7.1f%% %7.1f%% %10.1f %10.1f %10.1f %8.2f\n",
+                        labelWidth, config.paramSets[i].label.c_str(), static_cast<unsigned long long>(r.episodes),
+                        100.0 * r.victories / episodes, 100.0 * r.chopped / episodes, 100.0 * r.frozen / episodes,
+                        r.chopped > 0 ? r.catchTimeTotal / r.chopped : 0.0,
+                        r.victories > 0 ? r.escapeTimeTotal / r.victories : 0.0,
+                        r.distanceTotal / episodes, r.twinEncounters / episodes);
+        }
+        return 0;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: HorrorMazeHeadless [--map file] [--ticks n] [--seed s] [--rate hz]"
+                             " [--replay file] [--record file] [--profile csv] [--bot wander|exit]\n"
+                             "                          [--snapshot file] [--snapshot-check]\n"
+                             "       HorrorMazeHeadless --batch n [--episodes n] [--threads n]"
+                             " [--param name=value]... [--sweep name=v1,v2,...]\n");
+        return 2;
+    }
+    if (options.batch > 0) {
+        return runBatchMode(options);
+    }
+
+    InputReplay replay;
+    if (!options.replayPath.empty()) {
+        if (!replay.load(options.replayPath)) {
+            Logger::instance().flush();
+            return 1;
+        }
+        options.seed = replay.getSeed();
+        options.hasSeed = true;
+        options.rate = 1.0f / replay.getTimestep();
+        if (!options.hasTicks) {
+            options.ticks = replay.getFrameCount();
+        }
+    }
+
+    std::uint64_t seed = options.hasSeed ? options.seed : RngService::seedFromEnvironment();
+    Simulation sim(seed, options.params);
+    if (!loadAnyMap(sim, options.mapPath)) {
+        LOG_ERROR("ERROR: Cannot load map!");
+        Logger::instance().flush();
+        return 1;
+    }
+
+    bool resetPending = true;  // 录像的第一步总是"开始一局"（和游戏里在菜单按 Enter 一致）
+    if (!options.snapshotPath.empty()) {
+        SimulationSnapshot snapshot;
+        if (!snapshot.loadFromFile(options.snapshotPath) || !sim.restoreSnapshot(snapshot)) {
+            Logger::instance().flush();
+            return 1;
+        }
+        seed = sim.getRng().getSeed();
+        resetPending = false;  // 从快照的状态继续，不重新开始
+    }
+
+    WanderBot wanderBot(sim.getRng().stream(RngStream::Headless));
+    ExitSeekerBot exitBot(sim.getRng().stream(RngStream::Headless));
+    const float deltaTime = replay.isLoaded() ? replay.getTimestep() : 1.0f / options.rate;
+
+    if (options.snapshotCheck) {
+        Logger::instance().setMinimumLevel(LogLevel::Warn);
+        if (resetPending) {
+            sim.reset();
+        }
+        return (options.bot == "exit") ? runSnapshotCheck(sim, exitBot, options.ticks, deltaTime)
+                                       : runSnapshotCheck(sim, wanderBot, options.ticks, deltaTime);
+    }
+
+    InputRecorder recorder;
+    if (!options.recordPath.empty() && !recorder.open(options.recordPath, seed, deltaTime)) {
+        Logger::instance().flush();
+        return 1;
+    }
+    Profiler::instance().setEnabled(!options.profilePath.empty());
+
+    unsigned long long victories = 0;
+    unsigned long long chopped = 0;
+    unsigned long long frozen = 0;
+    unsigned long long twinEncounters = 0;
+
+    auto start = Clock::now();
+    for (unsigned long long tick = 0; tick < options.ticks; tick++) {
+        InputFrame frame;
+        if (replay.isLoaded()) {
+            if (replay.finished()) {
+                options.ticks = tick;
+                break;
+            }
+            frame = replay.next();
+            if (frame.reset) {
+                sim.reset();
+            }
+        } else {
+            if (resetPending) {
+                sim.reset();
+            }
+            frame.input = (options.bot == "exit") ? exitBot.next(sim, deltaTime) : wanderBot.next(sim, deltaTime);
+            frame.reset = resetPending;
+            resetPending = false;
+        }
+        recorder.record(frame);
+
+        sim.step(deltaTime, frame.input);
+        Profiler::instance().endFrame();  // 无头运行时一步算一帧
+
+        for (const auto& event : sim.getEvents()) {
+            switch (event.type) {
+            case SimulationEventType::TwinEncounter: twinEncounters++; break;
+            case SimulationEventType::ReachedExit:   victories++; break;
+            case SimulationEventType::PlayerCaught:  chopped++; break;
+            case SimulationEventType::FrozenToDeath: frozen++; break;
+            default: break;
+            }
+        }
+        if (sim.getStatus() != SimulationStatus::Running) {
+            resetPending = true;
+        }
+    }
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    recorder.close();
+    if (!options.profilePath.empty()) {
+        Profiler::instance().writeCsv(options.profilePath);
+    }
+    Logger::instance().flush();
+    unsigned long long episodes = victories + chopped + frozen;
+    std::printf("Seed %llu: %llu ticks at %.0f Hz in %.3f s (%.0f ticks/s, %.1fx real time)\n",
+                static_cast<unsigned long long>(seed), options.ticks, options.rate, seconds,
+                options.ticks / seconds, options.ticks / (options.rate * seconds));
+    std::printf("Episodes finished: %llu (victory %llu, chopped %llu, frozen %llu), twin encounters %llu\n",
+                episodes, victories, chopped, frozen, twinEncounters);
+    return 0;
+}
@@ -0,0 +1,551 @@
+#include "Simulation.h"
+#include "Maze.h"
+#include "Player.h"
+#include "Ghost.h"
+#include "StimulusSystem.h"
+#include "CpuFeatures.h"
+#include "RayCast.h"
+#include "RayCastBatch.h"
+#include "FloorCast.h"
+#include "ColorGrade.h"
+#include "RngService.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * 引擎热点内核的微基准测试
+ *
+ * 在逐渐变大的生成迷宫上单独测量每个内核的单次耗时（ns/op）和吞吐量：
+ *   Maze::loadFromFile            整张地图的解析 + 位图/可见集构建
+ *   RayCast::cast                 Renderer::castRays 每列的DDA求交（不开窗口，按列计）
+ *   RayCastBatch                  相邻列成组的SIMD求交（各指令集分别测量，结果必须和逐列投射一致）
+ *   Ghost::findPath               鬼的A*寻路
+ *   Simulation::findPathToExit    闪灵逃生路径的A*寻路
+ *   Ghost::canSeePlayer           视野检测
+ *   StimulusSystem::findStrongest 鬼的听觉（原 calculateSoundLevel）
+ *   Player::checkCollision        玩家碰撞检测
+ *   FloorCast::shadeRow           软件渲染的地板/天花板按行投射（和地图无关，按整屏计）
+ *   ColorGrade::applyRow          闪灵视觉的整帧调色（3D 查找表 + 晕影，按整屏计）
+ *
+ * 每项取若干轮中最快一轮的平均值。--json 把结果写成JSON，方便比较两次构建
+ * （width/height 是地图尺寸，整屏内核是屏幕分辨率）。
+ * 校验失败（SIMD 结果和标量不一致）或测试地图无法写入/加载时返回1。
+ *
+ * 用法：HorrorMazeKernelBench [--json 文件] [--runs 轮数]
+ */
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    const int SCREEN_COLUMNS = 1200;   // 和游戏窗口宽度一致
+    const int SCREEN_ROWS = 800;
+    const int RAY_FRAMES = 64;         // 每轮投射的帧数
+    const int PATH_QUERIES = 32;       // 每轮寻路次数
+    const int POINT_QUERIES = 1 << 16; // 每轮视野/听觉/碰撞查询次数
+    const int FOOTSTEPS = 16;          // 听觉测试时场上的刺激数量
+
+    struct Options {
+        std::string jsonPath;
+        int runs = 5;
+    };
+
+    bool parseOptions(int argc, char** argv, Options& options) {
+        for (int i = 1; i < argc; i++) {
+            bool hasValue = (i + 1 < argc);
+            if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+                options.jsonPath = argv[++i];
+            } else if (std::strcmp(argv[i], "--runs") == 0 && hasValue) {
+                options.runs = std::atoi(argv[++i]);
+            } else {
+                return false;
+            }
+        }
+        return options.runs > 0;
+    }
+
+    struct Result {
+        std::string kernel;
+        int width;             // 地图尺寸（整屏内核为屏幕分辨率）
+        int height;
+        const char* unit;      // 一次操作是什么（吞吐量的单位）
+        double nsPerOp;
+        long long checksum;    // 防止结果被优化掉，也用来确认两次构建算出的东西一样
+    };
+
+    // 重复运行 fn，取最快一轮的单次耗时（纳秒）
+    template <typename Fn>
+    double bestNsPerOp(Fn&& fn, std::size_t opsPerRun, int runs) {
+        double best = 1e30;
+        for (int r = 0; r < runs; r++) {
+            auto start = Clock::now();
+            fn();
+            auto end = Clock::now();
+            double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            best = std::min(best, ns / static_cast<double>(opsPerRun));
+        }
+        return best;
+    }
+
+    /**
+     * 生成 size × size 的迷宫（size 为奇数）：递归回溯生成树形迷宫，
+     * 再随机打通约10%的墙形成环路（和手工地图一样有多条路线）。
+     * 出口放在右下角，玩家起点是左上角第一个空地。
+     */
+    std::vector<std::vector<int>> generateMaze(int size, std::mt19937& gen) {
+        std::vector<std::vector<int>> cells(size, std::vector<int>(size, 1));
+        std::vector<sf::Vector2i> stack;
+        cells[1][1] = 0;
+        stack.push_back({1, 1});
+
+        const int dx[] = {0, 0, -2, 2};
+        const int dy[] = {-2, 2, 0, 0};
+        while (!stack.empty()) {
+            sf::Vector2i current = stack.back();
+            int options[4];
+            int count = 0;
+            for (int i = 0; i < 4; i++) {
+                int nx = current.x + dx[i];
+                int ny = current.y + dy[i];
+                if (nx > 0 && ny > 0 && nx < size - 1 && ny < size - 1 && cells[ny][nx] == 1) {
+                    options[count++] = i;
+                }
+            }
+            if (count == 0) {
+                stack.pop_back();
+                continue;
+            }
+            int dir = options[gen() % count];
+            cells[current.y + dy[dir] / 2][current.x + dx[dir] / 2] = 0;
+            cells[current.y + dy[dir]][current.x + dx[dir]] = 0;
+            stack.push_back({current.x + dx[dir], current.y + dy[dir]});
+        }
+
+        std::uniform_int_distribution<int> inner(1, size - 2);
+        int openings = size * size / 10;
+        for (int i = 0; i < openings; i++) {
+            cells[inner(gen)][inner(gen)] = 0;
+        }
+
+        cells[size - 2][size - 2] = 2;
+        return cells;
+    }
+
+    bool writeMapFile(const std::string& path, const std::vector<std::vector<int>>& cells) {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            return false;
+        }
+        int size = static_cast<int>(cells.size());
+        std::fprintf(file, "%d %d\n", size, size);
+        for (const auto& row : cells) {
+            for (std::size_t x = 0; x < row.size(); x++) {
+                std::fprintf(file, x + 1 < row.size() ? "%d " : "%d\n", row[x]);
+            }
+        }
+        std::fclose(file);
+        return true;
+    }
+
+    std::vector<sf::Vector2i> collectFloorCells(const Maze& maze) {
+        std::vector<sf::Vector2i> floor;
+        for (int y = 0; y < maze.getHeight(); y++) {
+            for (int x = 0; x < maze.getWidth(); x++) {
+                if (!maze.isWall(x, y)) {
+                    floor.push_back({x, y});
+                }
+            }
+        }
+        return floor;
+    }
+
+    // 空地格子里的随机一点
+    sf::Vector2f randomPointIn(sf::Vector2i cell, std::mt19937& gen) {
+        std::uniform_real_distribution<float> offset(0.05f, 0.95f);
+        return {cell.x + offset(gen), cell.y + offset(gen)};
+    }
+
+    void report(std::vector<Result>& results, const std::string& kernel, int width, int height, const char* unit,
+                double nsPerOp, long long checksum) {
+        std::printf("%4dx%-4d %-30s %12.1f ns/%-7s %12.0f %s/s   (checksum %lld)\n",
+                    width, height, kernel.c_str(), nsPerOp, unit, 1e9 / nsPerOp, unit, checksum);
+        results.push_back({kernel, width, height, unit, nsPerOp, checksum});
+    }
+
+    void report(std::vector<Result>& results, const std::string& kernel, int size, const char* unit,
+                double nsPerOp, long long checksum) {
+        report(results, kernel, size, size, unit, nsPerOp, checksum);
+    }
+
+    // 返回 false 表示某个内核的校验失败，或测试地图无法写入/加载
+    bool benchSize(int size, const Options& options, std::mt19937& gen, std::vector<Result>& results) {
+        const std::string mapPath = "kernelbench_" + std::to_string(size) + ".txt";
+        if (!writeMapFile(mapPath, generateMaze(size, gen))) {
+            std::fprintf(stderr, "Cannot write %s\n", mapPath.c_str());
+            return false;
+        }
+
+        // === Maze::loadFromFile ===
+        {
+            const int LOADS = std::max(4, (1 << 20) / (size * size));  // 每轮约读入一百万格
+            Maze maze;
+            long long checksum = 0;
+            double ns = bestNsPerOp([&]() {
+                for (int i = 0; i < LOADS; i++) {
+                    maze.loadFromFile(mapPath);
+                }
+                checksum = maze.getExitPos().x + maze.getExitPos().y;
+            }, LOADS, options.runs);
+            report(results, "Maze::loadFromFile", size, "map", ns, checksum);
+        }
+
+        Simulation sim(0x6b65726e656cULL);
+        if (!sim.loadMap(mapPath)) {
+            std::fprintf(stderr, "Cannot load %s\n", mapPath.c_str());
+            std::remove(mapPath.c_str());
+            return false;
+        }
+        std::remove(mapPath.c_str());
+        const Maze& maze = sim.getMaze();
+        const std::vector<sf::Vector2i> floor = collectFloorCells(maze);
+        std::uniform_int_distribution<std::size_t> pickFloor(0, floor.size() - 1);
+        std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+
+        // === RayCast::cast（一帧 = 屏幕宽度条光线） ===
+        struct View { float x, y, dirX, dirY, planeX, planeY; };
+        std::vector<View> views(RAY_FRAMES);
+        for (auto& v : views) {
+            sf::Vector2f p = randomPointIn(floor[pickFloor(gen)], gen);
+            float a = angle(gen);
+            v = {p.x, p.y, std::cos(a), std::sin(a), -0.66f * std::sin(a), 0.66f * std::cos(a)};
+        }
+        const WallBitmap& walls = maze.getWallBitmap();
+        {
+            long long checksum = 0;
+            double ns = bestNsPerOp([&]() {
+                checksum = 0;
+                for (const auto& v : views) {
+                    for (int x = 0; x < SCREEN_COLUMNS; x++) {
+                        float cameraX = RayCast::cameraX(x, SCREEN_COLUMNS);
+                        RayCast::Hit hit = RayCast::cast(walls, v.x, v.y,
+                                                         v.dirX + v.planeX * cameraX,
+                                                         v.dirY + v.planeY * cameraX);
+                        checksum += hit.mapX + hit.mapY + hit.side;
+                    }
+                }
+            }, static_cast<std::size_t>(RAY_FRAMES) * SCREEN_COLUMNS, options.runs);
+            report(results, "RayCast::cast", size, "column", ns, checksum);
+        }
+
+        // === RayCastBatch（同样的视角，每帧整屏一次调用） ===
+        {
+            std::vector<RayCast::Hit> expected;
+            expected.reserve(static_cast<std::size_t>(RAY_FRAMES) * SCREEN_COLUMNS);
+            for (const auto& v : views) {
+                for (int x = 0; x < SCREEN_COLUMNS; x++) {
+                    float cameraX = RayCast::cameraX(x, SCREEN_COLUMNS);
+                    expected.push_back(RayCast::cast(walls, v.x, v.y, v.dirX + v.planeX * cameraX,
+                                                     v.dirY + v.planeY * cameraX));
+                }
+            }
+
+            const RayCastBatch::Isa isas[] = {
+                RayCastBatch::Isa::Scalar, RayCastBatch::Isa::SSE2, RayCastBatch::Isa::AVX2
+            };
+            std::vector<RayCast::Hit> hits(expected.size());
+            for (RayCastBatch::Isa isa : isas) {
+                if (static_cast<int>(isa) > static_cast<int>(CpuFeatures::detectIsa())) {
+                    continue;  // CPU不支持
+                }
+                double ns = bestNsPerOp([&]() {
+                    for (std::size_t frame = 0; frame < views.size(); frame++) {
+                        const View& v = views[frame];
+                        RayCastBatch::castColumns(isa, walls, v.x, v.y, v.dirX, v.dirY, v.planeX, v.planeY,
+                                                  SCREEN_COLUMNS, 0, SCREEN_COLUMNS, &hits[frame * SCREEN_COLUMNS]);
+                    }
+                }, hits.size(), options.runs);
+
+                // 校验：格子、墙面方向、距离、击中点都必须和逐列投射逐位相同
+                long long checksum = 0;
+                for (std::size_t i = 0; i < hits.size(); i++) {
+                    const RayCast::Hit& a = hits[i];
+                    const RayCast::Hit& b = expected[i];
+                    if (a.mapX != b.mapX || a.mapY != b.mapY || a.side != b.side ||
+                        a.distance != b.distance || a.wallX != b.wallX) {
+                        std::fprintf(stderr, "RayCastBatch %s mismatch at frame %zu column %zu\n",
+                                     CpuFeatures::getIsaName(isa), i / SCREEN_COLUMNS, i % SCREEN_COLUMNS);
+                        return false;
+                    }
+                    checksum += a.mapX + a.mapY + a.side;
+                }
+                std::string kernel = std::string("RayCastBatch ") + CpuFeatures::getIsaName(isa);
+                report(results, kernel.c_str(), size, "column", ns, checksum);
+            }
+        }
+
+        // === Ghost::findPath / Simulation::findPathToExit ===
+        {
+            Pcg32 ghostRng = sim.getRng().stream(RngStream::Ghost, 0);
+            std::vector<Ghost> seekers;
+            std::vector<sf::Vector2i> targets;
+            for (int i = 0; i < PATH_QUERIES; i++) {
+                sf::Vector2i start = floor[pickFloor(gen)];
+                seekers.emplace_back(start.x + 0.5f, start.y + 0.5f, ghostRng);
+                targets.push_back(floor[pickFloor(gen)]);
+            }
+            long long checksum = 0;
+            double ns = bestNsPerOp([&]() {
+                checksum = 0;
+                for (int i = 0; i < PATH_QUERIES; i++) {
+                    checksum += static_cast<long long>(seekers[i].findPath(targets[i].x, targets[i].y, maze).size());
+                }
+            }, PATH_QUERIES, options.runs);
+            report(results, "Ghost::findPath", size, "path", ns, checksum);
+
+            const sf::Vector2i exitPos = maze.getExitPos();
+            ns = bestNsPerOp([&]() {
+                checksum = 0;
+                for (int i = 0; i < PATH_QUERIES; i++) {
+                    sf::Vector2i start(static_cast<int>(seekers[i].getX()), static_cast<int>(seekers[i].getY()));
+                    checksum += static_cast<long long>(sim.findPathToExit(start, exitPos).size());
+                }
+            }, PATH_QUERIES, options.runs);
+            report(results, "Simulation::findPathToExit", size, "path", ns, checksum);
+        }
+
+        // === Ghost::canSeePlayer（玩家在鬼周围 ±6 格，视野内外各有） ===
+        {
+            std::uniform_int_distribution<int> near(-6, 6);
+            Pcg32 ghostRng = sim.getRng().stream(RngStream::Ghost, 1);
+            std::vector<Ghost> watchers;
+            std::vector<Player> targets;
+            const int PAIRS = 1024;
+            for (int i = 0; i < PAIRS; i++) {
+                sf::Vector2f g = randomPointIn(floor[pickFloor(gen)], gen);
+                watchers.emplace_back(g.x, g.y, ghostRng);
+                float px = std::min(size - 1.5f, std::max(0.5f, g.x + near(gen)));
+                float py = std::min(size - 1.5f, std::max(0.5f, g.y + near(gen)));
+                targets.emplace_back(px, py);
+            }
+            long long checksum = 0;
+            double ns = bestNsPerOp([&]() {
+                checksum = 0;
+                for (int i = 0; i < POINT_QUERIES; i++) {
+                    checksum += watchers[i % PAIRS].canSeePlayer(targets[i % PAIRS], maze);
+                }
+            }, POINT_QUERIES, options.runs);
+            report(results, "Ghost::canSeePlayer", size, "query", ns, checksum);
+        }
+
+        // === StimulusSystem::findStrongest（鬼听声音） ===
+        {
+            StimulusSystem stimuli;
+            stimuli.resize(maze.getWidth(), maze.getHeight());
+            for (int i = 0; i < FOOTSTEPS; i++) {
+                sf::Vector2f p = randomPointIn(floor[pickFloor(gen)], gen);
+                stimuli.emit(StimulusType::Footstep, p.x, p.y, 60.0f, 1.0f);
+            }
+            const StimulusSystem::Thresholds thresholds = {10.0f, 15.0f};
+            std::vector<sf::Vector2f> listeners(1024);
+            for (auto& l : listeners) {
+                l = randomPointIn(floor[pickFloor(gen)], gen);
+            }
+            long long checksum = 0;
+            double ns = bestNsPerOp([&]() {
+                checksum = 0;
+                HeardStimulus heard;
+                for (int i = 0; i < POINT_QUERIES; i++) {
+                    const sf::Vector2f& l = listeners[i % listeners.size()];
+                    checksum += stimuli.findStrongest(maze.getWallBitmap(), l.x, l.y, thresholds, heard);
+                }
+            }, POINT_QUERIES, options.runs);
+            report(results, "StimulusSystem::findStrongest", size, "query", ns, checksum);
+        }
+
+        // === Player::checkCollision ===
+        {
+            std::uniform_real_distribution<float> anywhere(0.0f, static_cast<float>(size));
+            std::vector<sf::Vector2f> points(4096);
+            for (auto& p : points) {
+                p = {anywhere(gen), anywhere(gen)};
+            }
+            const Player& player = sim.getPlayer();
+            long long checksum = 0;
+            double ns = bestNsPerOp([&]() {
+                checksum = 0;
+                for (int i = 0; i < POINT_QUERIES; i++) {
+                    const sf::Vector2f& p = points[i % points.size()];
+                    checksum += player.checkCollision(p.x, p.y, maze);
+                }
+            }, POINT_QUERIES, options.runs);
+            report(results, "Player::checkCollision", size, "query", ns, checksum);
+        }
+        return true;
+    }
+
+    /**
+     * 地板/天花板投射：整屏 1200×800 逐行着色（和 Renderer::castFloorAndCeiling 相同的行距离和步长）
+     * 各指令集的输出必须和标量版本逐像素相同。返回 false 表示校验失败
+     */
+    bool benchFloorCast(const Options& options, std::mt19937& gen, std::vector<Result>& results) {
+        PackedTexture source;
+        source.width = 64;
+        source.height = 64;
+        source.texels.resize(64 * 64);
+        for (auto& texel : source.texels) {
+            texel = static_cast<std::uint32_t>(gen());
+        }
+        Palette palette;
+        palette.build({&source});
+        IndexedTexture texture = palette.convert(source);
+        std::vector<std::uint32_t> colormap(Palette::SIZE);
+        palette.buildColormap(0xFFB4C8E0u, colormap.data());
+
+        const float horizon = SCREEN_ROWS * 0.5f;
+        const float dirX = 0.8f, dirY = 0.6f, planeX = -0.396f, planeY = 0.528f;
+        const float posX = 10.3f, posY = 7.7f;
+        auto shadeFrame = [&](FloorCast::Isa isa, std::vector<std::uint32_t>& pixels) {
+            for (int y = 0; y < SCREEN_ROWS; y++) {
+                float distance = 0.5f * SCREEN_ROWS / std::max(0.5f, std::abs(y + 0.5f - horizon));
+                FloorCast::shadeRow(isa, texture, posX + distance * (dirX - planeX), posY + distance * (dirY - planeY),
+                                    distance * 2.0f * planeX / SCREEN_COLUMNS, distance * 2.0f * planeY / SCREEN_COLUMNS,
+                                    colormap.data(), &pixels[static_cast<std::size_t>(y) * SCREEN_COLUMNS], SCREEN_COLUMNS);
+            }
+        };
+
+        std::vector<std::uint32_t> expected(static_cast<std::size_t>(SCREEN_COLUMNS) * SCREEN_ROWS);
+        std::vector<std::uint32_t> pixels(expected.size());
+        shadeFrame(FloorCast::Isa::Scalar, expected);
+
+        const FloorCast::Isa isas[] = {FloorCast::Isa::Scalar, FloorCast::Isa::AVX2};
+        for (FloorCast::Isa isa : isas) {
+            if (static_cast<int>(isa) > static_cast<int>(CpuFeatures::detectIsa())) {
+                continue;  // CPU不支持
+            }
+            double ns = bestNsPerOp([&]() { shadeFrame(isa, pixels); }, 1, options.runs);
+            long long checksum = 0;
+            for (std::size_t i = 0; i < pixels.size(); i++) {
+                if (pixels[i] != expected[i]) {
+                    std::fprintf(stderr, "FloorCast %s mismatch at pixel %zu\n", CpuFeatures::getIsaName(isa), i);
+                    return false;
+                }
+                checksum += pixels[i] & 0xFF;
+            }
+            report(results, std::string("FloorCast::shadeRow ") + CpuFeatures::getIsaName(isa),
+                   SCREEN_COLUMNS, SCREEN_ROWS, "frame", ns, checksum);
+        }
+        return true;
+    }
+
+    /**
+     * 整帧调色：整屏 1200×800 随机像素逐行查表、乘晕影（和 Renderer 软件路径的闪灵调色相同）
+     * 各指令集的输出必须和标量版本逐像素相同。返回 false 表示校验失败
+     */
+    bool benchColorGrade(const Options& options, std::mt19937& gen, std::vector<Result>& results) {
+        ColorGrade grade;
+        grade.build(ColorGrade::spiritVision);
+        grade.setVignette(SCREEN_COLUMNS, SCREEN_ROWS, 0.3f);
+
+        std::vector<std::uint32_t> source(static_cast<std::size_t>(SCREEN_COLUMNS) * SCREEN_ROWS);
+        for (auto& pixel : source) {
+            pixel = static_cast<std::uint32_t>(gen());
+        }
+        auto gradeFrame = [&](ColorGrade::Isa isa, std::vector<std::uint32_t>& pixels) {
+            for (int y = 0; y < SCREEN_ROWS; y++) {
+                grade.applyRow(isa, &pixels[static_cast<std::size_t>(y) * SCREEN_COLUMNS], y);
+            }
+        };
+
+        std::vector<std::uint32_t> expected = source;
+        gradeFrame(ColorGrade::Isa::Scalar, expected);
+
+        const ColorGrade::Isa isas[] = {ColorGrade::Isa::Scalar, ColorGrade::Isa::AVX2};
+        std::vector<std::uint32_t> pixels;
+        for (ColorGrade::Isa isa : isas) {
+            if (static_cast<int>(isa) > static_cast<int>(CpuFeatures::detectIsa())) {
+                continue;  // CPU不支持
+            }
+            // 每轮从同一帧开始（复制计入耗时，和整帧调色相比很小）
+            double ns = bestNsPerOp([&]() {
+                pixels = source;
+                gradeFrame(isa, pixels);
+            }, 1, options.runs);
+            long long checksum = 0;
+            for (std::size_t i = 0; i < pixels.size(); i++) {
+                if (pixels[i] != expected[i]) {
+                    std::fprintf(stderr, "ColorGrade %s mismatch at pixel %zu\n", CpuFeatures::getIsaName(isa), i);
+                    return false;
+                }
+                checksum += pixels[i] & 0xFF;
+            }
+            report(results, std::string("ColorGrade::applyRow ") + CpuFeatures::getIsaName(isa),
+                   SCREEN_COLUMNS, SCREEN_ROWS, "frame", ns, checksum);
+        }
+        return true;
+    }
+
+    bool writeJson(const std::string& path, const std::vector<Result>& results, int runs) {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            std::fprintf(stderr, "Cannot write %s\n", path.c_str());
+            return false;
+        }
+        std::fprintf(file, "{\n  \"benchmark\": \"HorrorMazeKernelBench\",\n  \"runs\": %d,\n  \"results\": [\n", runs);
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            std::fprintf(file,
+                         "    {\"kernel\": \"%s\", \"width\": %d, \"height\": %d, \"unit\": \"%s\","
+                         " \"ns_per_op\": %.3f, \"ops_per_sec\": %.1f, \"checksum\": %lld}%s\n",
+                         r.kernel.c_str(), r.width, r.height, r.unit, r.nsPerOp, 1e9 / r.nsPerOp, r.checksum,
+                         i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(file, "  ]\n}\n");
+        std::fclose(file);
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "Usage: HorrorMazeKernelBench [--json file] [--runs n]\n");
+        return 2;
+    }
+
+    std::mt19937 gen(12345);  // 固定种子，保证每次运行的地图和查询一致
+    const int sizes[] = {33, 65, 129, 257};
+    std::vector<Result> results;
+
+    std::printf("Kernel microbenchmark: best of %d runs\n", options.runs);
+    for (int size : sizes) {
+        if (!benchSize(size, options, gen, results)) {
+            Logger::instance().flush();
+            return 1;
+        }
+    }
+    if (!benchFloorCast(options, gen, results)) {
+        Logger::instance().flush();
+        return 1;
+    }
+    if (!benchColorGrade(options, gen, results)) {
+        Logger::instance().flush();
+        return 1;
+    }
+    Logger::instance().flush();
+
+    if (!options.jsonPath.empty()) {
+        if (!writeJson(options.jsonPath, results, options.runs)) {
+            return 1;
+        }
+        std::printf("Results written to %s\n", options.jsonPath.c_str());
+    }
+    return 0;
+}